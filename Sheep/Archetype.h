@@ -0,0 +1,108 @@
+#ifndef ARCHETYPE_H
+#define ARCHETYPE_H
+
+#include <GL/glew.h>
+#include <tuple>
+#include <vector>
+
+#include "Memory.h"
+
+using namespace std;
+
+// an entity's id - stays the same for as long as it lives, while its slot moves around. It's an
+// index in the low bits and the generation of that index in the high ones, like a TimerId, so an
+// id goes stale once its entity is destroyed, even after the index is handed out again
+typedef GLuint Entity;
+const Entity ENTITY_NONE = 0xFFFFFFFF;
+const GLuint ENTITY_INDEX_BITS = 20;
+const GLuint ENTITY_INDEX_MASK = (1 << ENTITY_INDEX_BITS) - 1;
+
+// Storage for every entity made of the same components: one packed array per component, with
+// an entity's components all at the same slot. Systems take the arrays they need, by column(),
+// and run straight down them. Destroying an entity moves the last one into its slot, so the
+// arrays stay packed, which is why anything held on to for longer than a loop is an Entity.
+// Memory is counted against Tag
+template <MemoryTag Tag, typename... Components>
+class Archetype
+{
+public:
+	GLuint size() const { return static_cast<GLuint>(entities.size()); }
+	GLboolean empty() const { return entities.empty(); }
+	// creating and destroying
+	Entity create(const Components&... components)
+	{
+		GLuint index;
+		if (!freeIndices.empty())
+		{
+			index = freeIndices.back();
+			freeIndices.pop_back();
+		}
+		else
+		{
+			index = static_cast<GLuint>(slots.size());
+			slots.push_back(0);
+			generations.push_back(0);
+		}
+		Entity entity = index | (generations[index] << ENTITY_INDEX_BITS);
+		slots[index] = size();
+		entities.push_back(entity);
+		int expand[] = { 0, (std::get<Column<Components> >(columns).push_back(components), 0)... };
+		(void)expand;
+		return entity;
+	}
+	// fine to call with ENTITY_NONE, or an entity that's been destroyed already
+	void destroy(Entity entity)
+	{
+		if (!alive(entity))
+			return;
+		GLuint index = entity & ENTITY_INDEX_MASK;
+		GLuint slot = slots[index], last = size() - 1;
+		int expand[] = { 0, (moveLast(std::get<Column<Components> >(columns), slot), 0)... };
+		(void)expand;
+		entities[slot] = entities[last];
+		slots[entities[slot] & ENTITY_INDEX_MASK] = slot;
+		entities.pop_back();
+		slots[index] = ENTITY_NONE;
+		generations[index]++;
+		freeIndices.push_back(index);
+	}
+	void clear()
+	{
+		int expand[] = { 0, (std::get<Column<Components> >(columns).clear(), 0)... };
+		(void)expand;
+		entities.clear();
+		slots.clear();
+		generations.clear();
+		freeIndices.clear();
+	}
+	// lookup
+	GLboolean alive(Entity entity) const
+	{
+		GLuint index = entity & ENTITY_INDEX_MASK;
+		return index < slots.size() && slots[index] != ENTITY_NONE
+			&& generations[index] << ENTITY_INDEX_BITS == (entity & ~ENTITY_INDEX_MASK);
+	}
+	GLuint slot(Entity entity) const { return slots[entity & ENTITY_INDEX_MASK]; }
+	Entity entity(GLuint slot) const { return entities[slot]; }
+	// a component's packed array, size() long
+	template <typename C> C* column() { return std::get<Column<C> >(columns).data(); }
+	template <typename C> const C* column() const { return std::get<Column<C> >(columns).data(); }
+	template <typename C> C& get(Entity entity) { return column<C>()[slot(entity)]; }
+private:
+	template <typename C> using Column = vector<C, TrackedAllocator<C, Tag> >;
+
+	std::tuple<Column<Components>...> columns;
+	vector<Entity> entities;	 // by slot
+	vector<GLuint> slots;		 // by index, ENTITY_NONE once destroyed
+	vector<GLuint> generations;	 // by index, bumped when its entity is destroyed
+	vector<GLuint> freeIndices;	 // indices to hand out again
+
+	template <typename C>
+	static void moveLast(Column<C>& column, GLuint slot)
+	{
+		column[slot] = column.back();
+		column.pop_back();
+	}
+};
+
+#endif
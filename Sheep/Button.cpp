@@ -1,6 +1,6 @@
 #include "Button.h"
 
-Button::Button(glm::vec2 argPosition, glm::vec2 argSize, Texture2D argSprite, glm::vec4 argColor,
+Button::Button(glm::vec2 argPosition, glm::vec2 argSize, TextureHandle argSprite, glm::vec4 argColor,
 	GLfloat argRotation, GLboolean argDraw, void(*argCallback)())
 {
 	position = argPosition;
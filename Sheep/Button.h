@@ -16,7 +16,7 @@ class Button : public Drawable
 public:
 	void(*callbackFunction)();
 	GLboolean pressed;
-	Button(glm::vec2 argPosition, glm::vec2 argSize, Texture2D argSprite,
+	Button(glm::vec2 argPosition, glm::vec2 argSize, TextureHandle argSprite,
 		glm::vec4 argColor, GLfloat argRotation, GLboolean argDraw, void(*argCallback)());
 	GLboolean cursorOnButton(GLfloat x, GLfloat y);
 	void render(SpriteRenderer& renderer, glm::vec2 argSampleDivider, GLint argSampleIndex);
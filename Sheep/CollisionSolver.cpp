@@ -0,0 +1,332 @@
+#include "StrictFloat.h"
+#include "CollisionSolver.h"
+
+#include <algorithm>
+
+#include "CollisionUtil.h"
+
+CollisionSolver::CollisionSolver(WorkerPool* argPool, GLfloat argWidth, GLfloat argHeight, GLfloat argCellSize)
+	: pool(argPool), awakeGrid(argWidth, argHeight, argCellSize), sleepingGrid(argWidth, argHeight, argCellSize)
+{
+}
+
+void CollisionSolver::solve(const vector<Unit*>& units)
+{
+	// sort out who's awake - a sleeping unit with somewhere to go wakes its island
+	awake.clear();
+	for (GLuint i = 0; i < units.size(); i++)
+	{
+		if (!units[i]->asleep)
+			awake.push_back(units[i]);
+		else if (units[i]->moving)
+			islandsToWake.push_back(units[i]->island);
+	}
+	wakeIslands();
+	if (sleepersChanged)
+	{
+		sleepingGrid.build(sleepers);
+		sleepersChanged = false;
+	}
+	pairEvaluations = 0;
+	if (awake.empty())
+		return;
+
+	sweep();
+
+	GLuint count = static_cast<GLuint>(awake.size());
+	positionX.resize(count); positionY.resize(count);
+	radius.resize(count); moving.resize(count);
+	correctionX.resize(count); correctionY.resize(count);
+	deepestOverlap.resize(count);
+	hitStandingUnit.assign(count, 0);
+	touchedIsland.assign(count, 0);
+	contactCount.resize(count);
+	contacts.resize(count * SOLVER_MAX_CONTACTS);
+	sleepingContactCount.resize(count);
+	sleepingContacts.resize(count * SOLVER_MAX_SLEEPING_CONTACTS);
+
+	maxRadius = 0.f;
+	for (GLuint i = 0; i < count; i++)
+	{
+		positionX[i] = awake[i]->position.x;
+		positionY[i] = awake[i]->position.y;
+		radius[i] = awake[i]->radius();
+		moving[i] = awake[i]->moving ? 1.f : 0.f;
+		maxRadius = std::max(maxRadius, radius[i]);
+	}
+	for (GLuint i = 0; i < sleepers.size(); i++)
+		maxRadius = std::max(maxRadius, sleepers[i]->radius());
+
+	// contacts - everything close enough that it could end up overlapping
+	pool->parallelFor(count, [&](GLuint begin, GLuint end)
+	{
+		GLfloat distances[SOLVER_MAX_CONTACTS];
+		for (GLuint i = begin; i < end; i++)
+		{
+			glm::vec2 position(positionX[i], positionY[i]);
+			GLfloat reach = radius[i] + maxRadius + contactMargin;
+			contactCount[i] = awakeGrid.nearest(position, reach, SOLVER_MAX_CONTACTS, i,
+				&contacts[i * SOLVER_MAX_CONTACTS], distances);
+			sleepingContactCount[i] = sleepers.empty() ? 0 : sleepingGrid.nearest(position, reach, SOLVER_MAX_SLEEPING_CONTACTS,
+				static_cast<GLuint>(sleepers.size()), &sleepingContacts[i * SOLVER_MAX_SLEEPING_CONTACTS], distances);
+		}
+	});
+
+	for (GLuint i = 0; i < count; i++)
+		pairEvaluations += contactCount[i] + sleepingContactCount[i];
+	pairEvaluations *= iterations;
+
+	for (GLuint iteration = 0; iteration < iterations; iteration++)
+	{
+		// work out every correction from the positions at the start of the iteration...
+		pool->parallelFor(count, [&](GLuint begin, GLuint end)
+		{
+			for (GLuint i = begin; i < end; i++)
+			{
+				GLfloat pushX = 0.f, pushY = 0.f, deepest = 0.f;
+				for (GLuint c = 0; c < contactCount[i]; c++)
+				{
+					GLuint j = contacts[i * SOLVER_MAX_CONTACTS + c];
+					GLfloat dx = positionX[i] - positionX[j], dy = positionY[i] - positionY[j];
+					GLfloat distance = sqrt(dx * dx + dy * dy);
+					GLfloat overlap = radius[i] + radius[j] - distance;
+					if (overlap <= 0.f)
+						continue;
+					deepest = std::max(deepest, overlap);
+					if (distance == 0.f)
+					{
+						// right on top of each other - split them along x, by index so the two go opposite ways
+						dx = i < j ? -1.f : 1.f;
+						distance = 1.f;
+					}
+					// each of the two takes half of the overlap
+					pushX += dx / distance * overlap * .5f;
+					pushY += dy / distance * overlap * .5f;
+					if (moving[j] == 0.f)
+						hitStandingUnit[i] = 1;
+				}
+				for (GLuint c = 0; c < sleepingContactCount[i]; c++)
+				{
+					// sleepers don't budge, so this unit takes all of the overlap
+					const Unit* sleeper = sleepers[sleepingContacts[i * SOLVER_MAX_SLEEPING_CONTACTS + c]];
+					GLfloat dx = positionX[i] - sleeper->position.x, dy = positionY[i] - sleeper->position.y;
+					GLfloat distance = sqrt(dx * dx + dy * dy);
+					GLfloat overlap = radius[i] + sleeper->radius() - distance;
+					if (overlap <= 0.f)
+						continue;
+					deepest = std::max(deepest, overlap);
+					if (distance == 0.f)
+					{
+						dx = 1.f;
+						distance = 1.f;
+					}
+					pushX += dx / distance * overlap;
+					pushY += dy / distance * overlap;
+					hitStandingUnit[i] = 1;
+					if (moving[i] != 0.f)
+						touchedIsland[i] = sleeper->island;
+				}
+				correctionX[i] = pushX;
+				correctionY[i] = pushY;
+				deepestOverlap[i] = deepest;
+			}
+		});
+		// ...and only then move anyone
+		pool->parallelFor(count, [&](GLuint begin, GLuint end)
+		{
+			for (GLuint i = begin; i < end; i++)
+			{
+				positionX[i] += correctionX[i];
+				positionY[i] += correctionY[i];
+			}
+		});
+	}
+
+	for (GLuint i = 0; i < count; i++)
+	{
+		Unit* unit = awake[i];
+		// how far the solve moved it all told - a jammed unit gets pushed back and forth a bit every
+		// iteration, but that evens out, and it isn't going anywhere
+		GLfloat shiftX = positionX[i] - unit->position.x, shiftY = positionY[i] - unit->position.y;
+		unit->position = glm::vec2(positionX[i], positionY[i]);
+		if (hitStandingUnit[i])
+			unit->stop();
+		// settling down - stopped units, and only ones that were walking just now, count as moving below.
+		// One still wedged into another isn't settled, just slow to come out, and would stay wedged asleep
+		if (unit->moving || shiftX * shiftX + shiftY * shiftY > SOLVER_SLEEP_TOLERANCE * SOLVER_SLEEP_TOLERANCE
+			|| deepestOverlap[i] > SOLVER_SLEEP_OVERLAP)
+			unit->restTicks = 0;
+		else
+			unit->restTicks++;
+		if (touchedIsland[i])
+			islandsToWake.push_back(touchedIsland[i]);
+	}
+	fallAsleep();
+}
+
+// whether two circles touching from the start of the step are moving closer together over it
+static GLboolean closingIn(glm::vec2 start1, glm::vec2 end1, glm::vec2 start2, glm::vec2 end2)
+{
+	glm::vec2 offset = start2 - start1;
+	glm::vec2 motion = (end2 - start2) - (end1 - start1);
+	return offset.x * motion.x + offset.y * motion.y < 0.f;
+}
+
+void CollisionSolver::sweep()
+{
+	GLuint count = static_cast<GLuint>(awake.size());
+	impactTime.assign(count, 1.f);
+	impactStanding.assign(count, 0);
+	awakeGrid.build(awake, true);
+	pool->parallelFor(count, [&](GLuint begin, GLuint end)
+	{
+		vector<GLuint> candidates;
+		for (GLuint i = begin; i < end; i++)
+		{
+			Unit* unit = awake[i];
+			glm::vec2 path = unit->position - unit->prevPosition;
+			// anything shorter can't get past another unit, it'll still overlap it at the end
+			if (path.x * path.x + path.y * path.y <= unit->radius() * unit->radius())
+				continue;
+			glm::vec2 halfSize = unit->size / 2.f;
+			glm::vec2 low(std::min(unit->position.x, unit->prevPosition.x), std::min(unit->position.y, unit->prevPosition.y));
+			glm::vec2 high(std::max(unit->position.x, unit->prevPosition.x), std::max(unit->position.y, unit->prevPosition.y));
+			// only the first touch counts. Ones from the start are left to the overlap solve, unless
+			// the two are closing in - it'd only see them once they're out the other side, like
+			// after being put back to where they touched last tick
+			GLfloat first = 1.f, time;
+			GLubyte standing = 0;
+			awakeGrid.query(low - halfSize, high + halfSize, candidates);
+			for (GLuint c = 0; c < candidates.size(); c++)
+			{
+				const Unit* other = awake[candidates[c]];
+				if (candidates[c] == i || !sweptPenetrate(unit->prevPosition, unit->position, unit->radius(),
+					other->prevPosition, other->position, other->radius(), time) || time >= first
+					|| (time == 0.f && !closingIn(unit->prevPosition, unit->position, other->prevPosition, other->position)))
+					continue;
+				first = time;
+				standing = other->moving ? 0 : 1;
+			}
+			if (!sleepers.empty())
+			{
+				sleepingGrid.query(low - halfSize, high + halfSize, candidates);
+				for (GLuint c = 0; c < candidates.size(); c++)
+				{
+					const Unit* sleeper = sleepers[candidates[c]];
+					if (!sweptPenetrate(unit->prevPosition, unit->position, unit->radius(),
+						sleeper->position, sleeper->position, sleeper->radius(), time) || time >= first
+						|| (time == 0.f && !closingIn(unit->prevPosition, unit->position, sleeper->position, sleeper->position)))
+						continue;
+					first = time;
+					standing = 1;
+				}
+			}
+			impactTime[i] = first;
+			impactStanding[i] = standing;
+		}
+	});
+
+	// everyone's been swept from where they really went, so only now put anyone back - and a unit
+	// that ran into one standing still stops there, as it would in the overlap solve
+	GLboolean rewound = false;
+	for (GLuint i = 0; i < count; i++)
+	{
+		if (impactTime[i] < 1.f)
+		{
+			awake[i]->position = awake[i]->prevPosition + (awake[i]->position - awake[i]->prevPosition) * impactTime[i];
+			if (impactStanding[i])
+				awake[i]->stop();
+			rewound = true;
+		}
+	}
+	if (rewound)
+		awakeGrid.build(awake);
+}
+
+void CollisionSolver::wakeAll(const vector<Unit*>& units)
+{
+	// sleepers may have been deleted, so they're only ever reached through units here
+	for (GLuint i = 0; i < units.size(); i++)
+	{
+		units[i]->asleep = false;
+		units[i]->restTicks = 0;
+	}
+	sleepers.clear();
+	islandsToWake.clear();
+	sleepersChanged = true;
+}
+
+void CollisionSolver::wakeIslands()
+{
+	if (islandsToWake.empty())
+		return;
+	std::sort(islandsToWake.begin(), islandsToWake.end());
+	GLuint kept = 0;
+	for (GLuint i = 0; i < sleepers.size(); i++)
+	{
+		Unit* sleeper = sleepers[i];
+		if (std::binary_search(islandsToWake.begin(), islandsToWake.end(), sleeper->island))
+		{
+			sleeper->asleep = false;
+			sleeper->restTicks = 0;
+			awake.push_back(sleeper);
+		}
+		else
+			sleepers[kept++] = sleeper;
+	}
+	sleepers.resize(kept);
+	islandsToWake.clear();
+	sleepersChanged = true;
+}
+
+void CollisionSolver::fallAsleep()
+{
+	// islands are the groups of awake units that are in contact, found with union-find
+	GLuint count = static_cast<GLuint>(awake.size());
+	islandParent.resize(count);
+	for (GLuint i = 0; i < count; i++)
+		islandParent[i] = i;
+	for (GLuint i = 0; i < count; i++)
+	{
+		for (GLuint c = 0; c < contactCount[i]; c++)
+		{
+			GLuint j = contacts[i * SOLVER_MAX_CONTACTS + c];
+			glm::vec2 offset = awake[i]->position - awake[j]->position;
+			GLfloat reach = awake[i]->radius() + awake[j]->radius() + contactMargin;
+			if (offset.x * offset.x + offset.y * offset.y <= reach * reach)
+				islandParent[findIsland(i)] = findIsland(j);
+		}
+	}
+
+	// an island sleeps once every one of its units has settled - mark the restless ones' islands
+	vector<GLubyte>& restless = hitStandingUnit; // reused, it's done its job
+	restless.assign(count, 0);
+	for (GLuint i = 0; i < count; i++)
+		if (awake[i]->restTicks < SOLVER_SLEEP_TICKS)
+			restless[findIsland(i)] = 1;
+
+	vector<GLuint>& islandIds = touchedIsland;
+	islandIds.assign(count, 0);
+	for (GLuint i = 0; i < count; i++)
+	{
+		GLuint root = findIsland(i);
+		if (restless[root])
+			continue;
+		if (!islandIds[root])
+			islandIds[root] = nextIsland++;
+		awake[i]->asleep = true;
+		awake[i]->island = islandIds[root];
+		sleepers.push_back(awake[i]);
+		sleepersChanged = true;
+	}
+}
+
+GLuint CollisionSolver::findIsland(GLuint i)
+{
+	while (islandParent[i] != i)
+	{
+		islandParent[i] = islandParent[islandParent[i]];
+		i = islandParent[i];
+	}
+	return i;
+}
@@ -0,0 +1,81 @@
+#ifndef COLLISION_SOLVER_H
+#define COLLISION_SOLVER_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Unit.h"
+#include "SpatialGrid.h"
+#include "WorkerPool.h"
+
+// most overlaps a unit is pushed out of at once, by awake and by sleeping units
+const GLuint SOLVER_MAX_CONTACTS = 12;
+const GLuint SOLVER_MAX_SLEEPING_CONTACTS = 6;
+// ticks a unit has to stand still, without being pushed around, before it can fall asleep
+const GLuint SOLVER_SLEEP_TICKS = 30;
+// being pushed less than this over a tick, all told, counts as standing still
+const GLfloat SOLVER_SLEEP_TOLERANCE = .05f;
+// overlapping anyone by more than this, a unit isn't settled however still it stands
+const GLfloat SOLVER_SLEEP_OVERLAP = 1.f;
+
+// Pushes overlapping units apart, Jacobi style: every iteration works out each unit's correction
+// from where everyone was at the start of it, and only then moves anybody, splitting each overlap
+// evenly between the two units. That makes the outcome independent of how the work is split
+// across threads, so the iterations run on the worker pool and give the same result for the same
+// units passed in the same order. The order does matter: nearest() breaks ties between contacts
+// that are equally far by grid slot, and a unit's pushes are summed in contact order, both of
+// which follow the order units were passed in. Contacts are found once per solve from a grid
+// rather than by testing every pair, and a unit that runs into one standing still stops, as before.
+//
+// Groups of touching units that have all settled - islands - are put to sleep, and left out of
+// the solve until something wakes them: a move order for one of their units, a moving unit
+// running into them, or wakeAll(). Sleeping units sit in a grid of their own that's only rebuilt
+// when an island falls asleep or wakes up, and awake units are pushed out of them as if they
+// were walls. A herd that's standing around costs next to nothing.
+//
+// Overlaps are only looked at where units end up, so before that, units that covered more than
+// their radius this tick are swept along their path against everyone else's, and put back to
+// where they first touched something - stopping there if it was standing still. That keeps them
+// from stepping clean through each other when ticks are long.
+class CollisionSolver
+{
+public:
+	GLuint iterations = 4;
+	GLfloat contactMargin = 5.f;  // units this much further apart are still kept as contacts, as
+								  // iterations can push them together
+	GLuint pairEvaluations = 0;	  // overlap tests done by the last solve
+
+	// constructors
+	CollisionSolver(WorkerPool* argPool, GLfloat argWidth, GLfloat argHeight, GLfloat argCellSize);
+	void solve(const vector<Unit*>& units);
+	// wakes every unit - needed whenever units have been deleted, since sleepers are kept by pointer
+	void wakeAll(const vector<Unit*>& units);
+	GLuint awakeCount() const { return static_cast<GLuint>(awake.size()); }
+private:
+	WorkerPool* pool;
+	SpatialGrid awakeGrid, sleepingGrid;
+	vector<Unit*> awake, sleepers;
+	GLboolean sleepersChanged = false;
+	GLuint nextIsland = 1;
+	vector<GLuint> islandsToWake;
+	// one entry per awake unit
+	vector<GLfloat> positionX, positionY, radius, moving;
+	vector<GLfloat> correctionX, correctionY;
+	vector<GLfloat> deepestOverlap; // by the last iteration, against anybody
+	vector<GLubyte> hitStandingUnit;
+	vector<GLuint> touchedIsland; // sleeping island a moving unit ran into, 0 for none
+	vector<GLuint> contactCount, contacts;					 // SOLVER_MAX_CONTACTS per unit
+	vector<GLuint> sleepingContactCount, sleepingContacts; // SOLVER_MAX_SLEEPING_CONTACTS per unit
+	vector<GLuint> islandParent;
+	vector<GLfloat> impactTime; // fraction of its move an awake unit got through before touching anyone
+	vector<GLubyte> impactStanding; // whether who it touched was standing still
+	GLfloat maxRadius = 0.f;
+
+	void sweep();
+	void wakeIslands();
+	void fallAsleep();
+	GLuint findIsland(GLuint i);
+};
+
+#endif
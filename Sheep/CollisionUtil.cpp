@@ -1,3 +1,4 @@
+#include "StrictFloat.h"
 #include "CollisionUtil.h"
 
 GLboolean doesPenetrate(glm::vec2 position1, GLfloat radius1, glm::vec2 position2, GLfloat radius2)
@@ -26,6 +27,40 @@ glm::vec2 penetrationVector(Unit* unit1, Unit* unit2)
 	return penetrationVector(unit1->position, unit1->radius(), unit2->position, unit2->radius());
 }
 
+GLboolean sweptPenetrate(glm::vec2 start1, glm::vec2 end1, GLfloat radius1,
+	glm::vec2 start2, glm::vec2 end2, GLfloat radius2, GLfloat& timeOfImpact)
+{
+	// in the frame of the first circle, the second one moves from offset along motion, and they
+	// touch when |offset + motion * t| = radius1 + radius2 - a quadratic in t
+	glm::vec2 offset = start2 - start1;
+	glm::vec2 motion = (end2 - start2) - (end1 - start1);
+	GLfloat reach = radius1 + radius2;
+	GLfloat c = offset.x * offset.x + offset.y * offset.y - reach * reach;
+	if (c < 0)
+	{
+		timeOfImpact = 0.f;
+		return true;
+	}
+	GLfloat a = motion.x * motion.x + motion.y * motion.y;
+	if (a == 0)
+		return false; // not moving relative to each other
+	GLfloat b = 2 * (offset.x * motion.x + offset.y * motion.y);
+	GLfloat discriminant = b * b - 4 * a * c;
+	if (discriminant < 0)
+		return false; // paths never come close enough
+	GLfloat t = (-b - sqrt(discriminant)) / (2 * a);
+	if (t < 0 || t > 1)
+		return false; // they touch, but not during this step
+	timeOfImpact = t;
+	return true;
+}
+
+GLboolean sweptPenetrate(Unit* unit1, Unit* unit2, GLfloat& timeOfImpact)
+{
+	return sweptPenetrate(unit1->prevPosition, unit1->position, unit1->radius(),
+		unit2->prevPosition, unit2->position, unit2->radius(), timeOfImpact);
+}
+
 GLfloat norm(glm::vec2 vec)
 {
 	return sqrt(vec.x * vec.x + vec.y * vec.y);
@@ -50,4 +85,18 @@ GLfloat boundNegPiToPi(GLfloat argAngle)
 	while (argAngle > M_PI)
 		argAngle -= 2 * M_PI;
 	return argAngle;
+}
+
+Fixed AngleDiff(Fixed argAngle1, Fixed argAngle2)
+{
+	return boundNegPiToPi(argAngle2 - argAngle1);
+}
+
+Fixed boundNegPiToPi(Fixed argAngle)
+{
+	while (argAngle < -FIXED_PI)
+		argAngle += FIXED_TWO_PI;
+	while (argAngle > FIXED_PI)
+		argAngle -= FIXED_TWO_PI;
+	return argAngle;
 }
\ No newline at end of file
@@ -21,6 +21,13 @@ GLboolean doesPenetrate(glm::vec2 position1, GLfloat radius1, glm::vec2 position
 GLboolean doesPenetrate(Unit* unit1, Unit* unit2);
 glm::vec2 penetrationVector(glm::vec2 position1, GLfloat radius1, glm::vec2 position2, GLfloat radius2);
 glm::vec2 penetrationVector(Unit* unit1, Unit* unit2);
+// continuous version of doesPenetrate, for circles moving in straight lines over a step - tells
+// whether they touch anywhere along the way, so fast units can't skip through each other. If they
+// do, timeOfImpact is the fraction of the step (0 to 1) at which they first touch, 0 if they
+// already overlap at the start
+GLboolean sweptPenetrate(glm::vec2 start1, glm::vec2 end1, GLfloat radius1,
+	glm::vec2 start2, glm::vec2 end2, GLfloat radius2, GLfloat& timeOfImpact);
+GLboolean sweptPenetrate(Unit* unit1, Unit* unit2, GLfloat& timeOfImpact);
 
 GLfloat norm(glm::vec2 vec);
 GLfloat norm(glm::vec3 vec);
@@ -28,6 +35,8 @@ GLfloat norm(glm::vec3 vec);
 // angle stuff
 GLfloat AngleDiff(GLfloat argAngle1, GLfloat argAngle2);
 GLfloat boundNegPiToPi(GLfloat argAngle);
+Fixed AngleDiff(Fixed argAngle1, Fixed argAngle2);
+Fixed boundNegPiToPi(Fixed argAngle);
 
 // time stuff
 inline GLboolean differentTimeInterval(GLfloat t1, GLfloat t2, GLfloat argIntervalLength) 
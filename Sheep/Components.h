@@ -0,0 +1,71 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "TextureHandle.h"
+#include "SpriteRenderer.h"
+#include "TimerWheel.h"
+
+class Unit;
+
+// Components - plain data, kept in packed arrays by an Archetype and worked on by systems.
+// Entities are the things that come and go by the hundred with a few fields each: lazers,
+// rockets and power ups. Units stay objects - everything that runs over the herd already
+// gathers it into flat arrays first (CollisionSolver, Steering, SpatialGrid)
+
+// where something is, and how big
+struct Transform
+{
+	glm::vec2 position, size;
+	GLfloat rotation;
+};
+
+// what it's drawn with
+struct Sprite
+{
+	TextureHandle texture;
+	glm::vec4 color;
+};
+
+// which samples of a sprite sheet are drawn, stepped through on the GPU
+struct Animation
+{
+	glm::vec2 sampleDimensions;
+	GLint sampleFrame;
+	SpriteAnimation animation;
+};
+
+// the next thing due to happen to it - going off, then going away - as scheduled on its owner's
+// TimerWheel. Nothing counts down each tick; due is the sim time it happens at
+struct Timer
+{
+	GLfloat due;
+	GLfloat linger; // how long it stays around once it's gone off
+	TimerId event;
+};
+
+// hazards - once detonated, kills every unit in its hitbox each tick until its linger runs out
+struct Blast
+{
+	TextureHandle texture; // drawn instead of the sprite once detonated
+	GLboolean detonated;
+};
+
+// rockets - homes in on destination, which follows target while it's alive
+struct Mover
+{
+	glm::vec2 destination;
+	GLfloat velocity, angularVelocity;
+	Unit* target;
+	TextureHandle targetTexture; // marks the destination on the ground
+};
+
+// lazers - a line through the world at the transform's rotation, drawn as repeated chunks
+struct Beam
+{
+	glm::vec2 chunkSize;
+};
+
+#endif
@@ -5,7 +5,7 @@ Drawable::Drawable()
 	: position(0, 0), size(1, 1), color(1.0f), rotation(0.0f), sprite(), bDraw(false)
 {}
 
-Drawable::Drawable(glm::vec2 argPosition, glm::vec2 argSize, Texture2D argSprite, glm::vec4 argColor, GLfloat argRotation, GLboolean argDraw)
+Drawable::Drawable(glm::vec2 argPosition, glm::vec2 argSize, TextureHandle argSprite, glm::vec4 argColor, GLfloat argRotation, GLboolean argDraw)
 	: position(argPosition), size(argSize), sprite(argSprite), color(argColor), rotation(argRotation), bDraw(argDraw)
 {}
 
@@ -19,7 +19,7 @@ void Drawable::draw(SpriteRenderer & renderer, glm::vec2 argSampleDivider, GLint
 {
 	if (bDraw)
 		renderer.DrawSprite(this->sprite, this->position, this->size, this->rotation, this->color, 
-			argSampleDivider, argSampleIndex, false, false);
+			argSampleDivider, argSampleIndex, false, false, this->animation);
 }
 
 void Drawable::drawTopLeft(SpriteRenderer & renderer)
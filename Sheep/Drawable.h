@@ -4,7 +4,7 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
-#include "Texture2D.h"
+#include "TextureHandle.h"
 #include "SpriteRenderer.h"
 
 class Drawable
@@ -15,14 +15,16 @@ public:
 	glm::vec4 color = glm::vec4(1.0f);
 	GLfloat rotation;
 	GLboolean bDraw;
-	Texture2D sprite;
+	TextureHandle sprite;
 	// relationships
-	GLfloat radius() { return size.x / 2; };
+	GLfloat radius() const { return size.x / 2; };
 	// rendering stuff
-	GLint sampleFrame = 0;
+	GLint sampleFrame = 0;		 // the sample shown, or the first one of the animation
+	SpriteAnimation animation; // stepped through on the GPU, so it only changes when the animation does
 	
 	Drawable();
-	Drawable(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec4 color, GLfloat argRotation, GLboolean argDraw);
+	Drawable(glm::vec2 pos, glm::vec2 size, TextureHandle sprite, glm::vec4 color, GLfloat argRotation, GLboolean argDraw);
+	virtual ~Drawable() {}
 	virtual void draw(SpriteRenderer &renderer);
 	virtual void draw(SpriteRenderer& renderer, glm::vec2 argSampleDivider, GLint argSampleIndex);
 	virtual void drawTopLeft(SpriteRenderer& renderer);
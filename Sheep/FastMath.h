@@ -0,0 +1,92 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <GL/glew.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+
+// Polynomial stand-ins for the libm trig the simulation and hazard drawing call every tick, and the
+// log random draws take. They're inline, without branches or calls, so loops over arrays of angles
+// vectorise - libm's can't, as every call is opaque to the compiler. And being nothing but float
+// adds, multiplies and divides, they round the same everywhere, which libm's don't promise to. Max
+// errors are against double precision libm, measured over the range given. Past it, sine and
+// cosine lose accuracy the way a float's range reduction would
+
+const GLfloat FAST_PI = 3.14159265f;
+const GLfloat FAST_HALF_PI = 1.57079633f;
+
+// within 2e-6 radians everywhere, 0 for (0, 0) - not the place to tell -0 from 0
+inline GLfloat fastAtan2(GLfloat argY, GLfloat argX)
+{
+	GLfloat absY = fabsf(argY), absX = fabsf(argX);
+	GLfloat big = absY > absX ? absY : absX, small = absY > absX ? absX : absY;
+	// atan over 0..1, then mirrored out into the octant. The mirroring is an offset and a sign picked
+	// by selects, as conditional arithmetic keeps the loop from vectorising - and it's decided off of
+	// big rather than by comparing absY and absX again, or the compiler splits the loop body in two
+	// around the division, which won't vectorise either
+	GLfloat a = small / (big + 1e-30f); // big is 0 only if small is too, and 0 / 1e-30 is 0
+	GLfloat s = a * a;
+	GLfloat r = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f + s * (-0.11643287f + s * (0.05265332f + s * -0.01172120f)))));
+	GLfloat steep = big > absX ? 1.f : 0.f, behind = argX < 0.f ? 1.f : 0.f;
+	r = steep * FAST_HALF_PI + (1.f - 2.f * steep) * r;
+	r = behind * FAST_PI + (1.f - 2.f * behind) * r;
+	return argY < 0.f ? -r : r;
+}
+
+// both at once, within 4e-7 for angles within +-1000 radians. The angle is brought down to within
+// pi/4 of a multiple of pi/2, with pi/2 split in two so the reduction stays exact for longer
+inline void fastSinCos(GLfloat argAngle, GLfloat& sine, GLfloat& cosine)
+{
+	GLfloat scaled = argAngle * 0.636619772f;
+	int32_t quadrant = static_cast<int32_t>(scaled + (scaled < 0.f ? -.5f : .5f));
+	GLfloat q = static_cast<GLfloat>(quadrant);
+	GLfloat r = (argAngle - q * 1.5703125f) - q * 4.83826794e-4f;
+	GLfloat s = r * r;
+	GLfloat sinR = r + r * s * (-1.f / 6.f + s * (1.f / 120.f + s * (-1.f / 5040.f)));
+	GLfloat cosR = 1.f + s * (-.5f + s * (1.f / 24.f + s * (-1.f / 720.f + s * (1.f / 40320.f))));
+	// odd quadrants swap the two, and the signs follow the quadrant around the circle. Picked by
+	// multiplying with 0s and 1s like fastAtan2 does - with selects, a caller that only wants one
+	// of the two gets the other left out, and the select that's left turned into a branch
+	GLfloat odd = static_cast<GLfloat>(quadrant & 1);
+	GLfloat sineSign = 1.f - static_cast<GLfloat>(quadrant & 2), cosineSign = 1.f - static_cast<GLfloat>((quadrant + 1) & 2);
+	sine = sineSign * (odd * cosR + (1.f - odd) * sinR);
+	cosine = cosineSign * (odd * sinR + (1.f - odd) * cosR);
+}
+
+inline GLfloat fastSin(GLfloat argAngle) { GLfloat sine, cosine; fastSinCos(argAngle, sine, cosine); return sine; }
+inline GLfloat fastCos(GLfloat argAngle) { GLfloat sine, cosine; fastSinCos(argAngle, sine, cosine); return cosine; }
+
+// natural log, within 1e-6 for values from 2^-24 up to 1 - and within a few float roundings of it for
+// any positive, normal value. The value is split into a power of two and a mantissa within a factor
+// of sqrt(2) of 1, straight from its bits, and the mantissa's log comes from the atanh series
+inline GLfloat fastLog(GLfloat argValue)
+{
+	uint32_t bits;
+	memcpy(&bits, &argValue, sizeof(bits));
+	// the mantissa over [1, 2), moved down to [sqrt(1/2), sqrt(2)) past 1.41421354 (0x3FB504F3)
+	uint32_t high = (bits & 0x7FFFFF) > 0x3504F3 ? 1 : 0;
+	int32_t exponent = static_cast<int32_t>(bits >> 23) - 127 + static_cast<int32_t>(high);
+	bits = (bits & 0x7FFFFF) | ((127 - high) << 23);
+	GLfloat m;
+	memcpy(&m, &bits, sizeof(m));
+	GLfloat e = static_cast<GLfloat>(exponent);
+	GLfloat f = (m - 1.f) / (m + 1.f);
+	GLfloat s = f * f;
+	GLfloat logM = 2.f * f * (1.f + s * (1.f / 3.f + s * (1.f / 5.f + s * (1.f / 7.f + s * (1.f / 9.f)))));
+	// log 2 split in two, like fastSinCos splits pi/2, so e * log 2 stays exact
+	return e * 0.693145752f + (e * 1.42860677e-6f + logM);
+}
+
+// (x, y) scaled to length 1, for when all an angle would be used for is pointing that way - which
+// is (cos, sin) of atan2(y, x), without the trig. Within a couple of float roundings of that, and
+// (1, 0) for (0, 0), like atan2 would give
+inline void fastDirection(GLfloat argX, GLfloat argY, GLfloat& directionX, GLfloat& directionY)
+{
+	GLfloat lengthSquared = argX * argX + argY * argY;
+	GLfloat scale = lengthSquared > 0.f ? 1.f / sqrtf(lengthSquared) : 0.f;
+	directionX = lengthSquared > 0.f ? argX * scale : 1.f;
+	directionY = argY * scale;
+}
+
+#endif
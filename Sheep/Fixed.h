@@ -0,0 +1,89 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <GL/glew.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "FastMath.h"
+
+// Q16.16 fixed point number - 16 bits of integer and 16 of fraction in a 32 bit int, so it covers
+// about +-32768 in steps of 1/65536. Everything it does is integer math, which comes out the same
+// on every compiler, optimisation level and machine, unlike float math that may be contracted,
+// kept at higher precision or run through a different libm.
+class Fixed
+{
+public:
+	int32_t raw;
+
+	// constructors
+	Fixed() : raw(0) {}
+	explicit Fixed(GLint argValue) : raw(argValue * 65536) {}
+	// rounds to the nearest step - exact, as scaling a float by a power of two is
+	explicit Fixed(GLfloat argValue) : raw(static_cast<int32_t>(lround(argValue * 65536.f))) {}
+	static Fixed fromRaw(int32_t argRaw) { Fixed result; result.raw = argRaw; return result; }
+	GLfloat toFloat() const { return static_cast<GLfloat>(raw) / 65536.f; }
+
+	// arithmetic - products and quotients go through 64 bits, rounding toward negative infinity
+	Fixed operator-() const { return fromRaw(-raw); }
+	Fixed operator+(Fixed other) const { return fromRaw(raw + other.raw); }
+	Fixed operator-(Fixed other) const { return fromRaw(raw - other.raw); }
+	Fixed operator*(Fixed other) const { return fromRaw(static_cast<int32_t>((static_cast<int64_t>(raw) * other.raw) >> 16)); }
+	Fixed operator/(Fixed other) const { return fromRaw(static_cast<int32_t>(static_cast<int64_t>(raw) * 65536 / other.raw)); }
+	Fixed& operator+=(Fixed other) { raw += other.raw; return *this; }
+	Fixed& operator-=(Fixed other) { raw -= other.raw; return *this; }
+	Fixed& operator*=(Fixed other) { return *this = *this * other; }
+	Fixed& operator/=(Fixed other) { return *this = *this / other; }
+	// comparison
+	bool operator==(Fixed other) const { return raw == other.raw; }
+	bool operator!=(Fixed other) const { return raw != other.raw; }
+	bool operator<(Fixed other) const { return raw < other.raw; }
+	bool operator>(Fixed other) const { return raw > other.raw; }
+	bool operator<=(Fixed other) const { return raw <= other.raw; }
+	bool operator>=(Fixed other) const { return raw >= other.raw; }
+};
+
+const Fixed FIXED_PI = Fixed::fromRaw(205887);
+const Fixed FIXED_TWO_PI = Fixed::fromRaw(411775);
+const Fixed FIXED_HALF_PI = Fixed::fromRaw(102944);
+
+// math that's used by the simulation - the Fixed versions read tables, and are within a couple
+// of steps (1/65536ths) of the exact result over the whole range. The GLfloat trig is FastMath's,
+// within a few millionths of a radian, and the rest is the standard library
+Fixed simSin(Fixed argAngle);
+Fixed simCos(Fixed argAngle);
+Fixed simAtan2(Fixed argY, Fixed argX);
+inline void simSinCos(Fixed argAngle, Fixed& sine, Fixed& cosine) { sine = simSin(argAngle); cosine = simCos(argAngle); }
+Fixed simSqrt(Fixed argValue);
+// length of (x, y), without the squares overflowing like they would in Q16.16
+Fixed simLength(Fixed argX, Fixed argY);
+// (x, y) scaled to length 1, or (1, 0) for (0, 0) - the way atan2 would point, without the trig
+void simDirection(Fixed argX, Fixed argY, Fixed& directionX, Fixed& directionY);
+inline Fixed simAbs(Fixed argValue) { return argValue.raw < 0 ? -argValue : argValue; }
+inline GLfloat simSin(GLfloat argAngle) { return fastSin(argAngle); }
+inline GLfloat simCos(GLfloat argAngle) { return fastCos(argAngle); }
+inline void simSinCos(GLfloat argAngle, GLfloat& sine, GLfloat& cosine) { fastSinCos(argAngle, sine, cosine); }
+inline GLfloat simAtan2(GLfloat argY, GLfloat argX) { return fastAtan2(argY, argX); }
+inline void simDirection(GLfloat argX, GLfloat argY, GLfloat& directionX, GLfloat& directionY) { fastDirection(argX, argY, directionX, directionY); }
+inline GLfloat simSqrt(GLfloat argValue) { return sqrt(argValue); }
+inline GLfloat simLength(GLfloat argX, GLfloat argY) { return sqrt(argX * argX + argY * argY); }
+inline GLfloat simAbs(GLfloat argValue) { return fabs(argValue); }
+
+// The number type of the simulation core - unit, rocket and lazer movement and hit tests. It's
+// Fixed when built with SHEEP_FIXED_POINT defined, which makes that math replay bit for bit across
+// builds and machines whatever the compiler does with floats, and float otherwise. State stays
+// stored as floats either way, and is converted at the start and end of each calculation - that
+// rounds the same way everywhere too. The collision solver, steering, swept tests and flow fields
+// are float in both builds: their squared distances would overflow Q16.16, so it's StrictFloat.h
+// that keeps those the same from build to build.
+#ifdef SHEEP_FIXED_POINT
+typedef Fixed Scalar;
+#else
+typedef GLfloat Scalar;
+#endif
+
+inline Scalar toScalar(GLfloat argValue) { return Scalar(argValue); }
+inline GLfloat toFloat(GLfloat argValue) { return argValue; }
+inline GLfloat toFloat(Fixed argValue) { return argValue.toFloat(); }
+
+#endif
@@ -1,3 +1,4 @@
+#include "StrictFloat.h"
 #include "Flock.h"
 
 Flock::Flock(GLfloat argWidth, GLfloat argHeight)
@@ -33,7 +34,7 @@ glm::vec2 Flock::center()
 	return glm::vec2((maxX + minX) / 2, (maxY + minY) / 2);
 }
 
-void Flock::setDestination(glm::vec2 argDestination)
+void Flock::setDestination(glm::vec2 argDestination, GLfloat argTime)
 {
 	// find the farthest point that each unit can travel
 	// we're essentially subtracting by the vector of maximum x and y penetrations
@@ -62,11 +63,19 @@ void Flock::setDestination(glm::vec2 argDestination)
 		// new destination is equal to the position of the unit
 		// plus the vector from the flock's center to the new point
 		// units[i]->setDestination(additionVector);
-		units[i]->setDestination(units[i]->position + additionVector);
+		units[i]->setDestination(units[i]->position + additionVector, argTime);
 	}
 }
 
-void recreateFlocks(vector<Unit*>& argUnits, vector<Flock>& argFlocks, GLfloat argWidth, GLfloat argHeight, GLfloat distanceMax)
+void Flock::setFlowDestination(shared_ptr<FlowField> argField, GLfloat argTime)
+{
+	// the flock gathers around the destination, rather than keeping its shape - units
+	// that get there first stop, and the rest pile up against them
+	for (unsigned int i = 0; i < units.size(); i++)
+		units[i]->setDestination(argField->goal, argTime, argField);
+}
+
+void recreateFlocks(const vector<Unit*>& argUnits, vector<Flock>& argFlocks, GLfloat argWidth, GLfloat argHeight, GLfloat distanceMax)
 {
 	// idea for algorithm: https://stackoverflow.com/questions/3937663/2d-point-clustering/3939542#3939542
 
@@ -125,3 +134,16 @@ bool closeEnough(glm::vec2 position1, glm::vec2 position2, GLfloat distanceToler
 {
 	return (norm(position2 - position1) < distanceTolerance);
 }
+
+shared_ptr<FlowField> buildFlowField(glm::vec2 argDestination, GLfloat argWidth, GLfloat argHeight, const vector<Unit*>& argHerd)
+{
+	// sheep standing around are in the way - selected ones are about to move, so they aren't
+	shared_ptr<FlowField> field = allocate_shared<FlowField>(TrackedAllocator<FlowField, MEMORY_FLOW_FIELDS>(), argWidth, argHeight);
+	for (unsigned int i = 0; i < argHerd.size(); i++)
+	{
+		if (!argHerd[i]->moving && !argHerd[i]->isSelected())
+			field->addObstacle(argHerd[i]->position, argHerd[i]->radius());
+	}
+	field->build(argDestination);
+	return field;
+}
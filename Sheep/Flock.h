@@ -11,7 +11,7 @@
 class Flock
 {
 public:
-	vector<Unit*> units;
+	vector<Unit*, TrackedAllocator<Unit*, MEMORY_FLOCKS> > units;
 	glm::vec2 destination;
 	glm::vec2 position;
 	GLfloat angle;
@@ -25,13 +25,18 @@ public:
 	void add(Unit* argUnit);
 	// position
 	glm::vec2 center();
-	// movement
-	void setDestination(glm::vec2 argDestination);
+	// movement - keeps the flock's formation, each unit walking in a straight line
+	void setDestination(glm::vec2 argDestination, GLfloat argTime);
+	// movement - every unit follows argField to its goal, from buildFlowField
+	void setFlowDestination(shared_ptr<FlowField> argField, GLfloat argTime);
 };
 
 /// helper functions
 // function that will put units into flocks accordingly
-void recreateFlocks(vector<Unit*>& argUnits, vector<Flock>& argFlocks, GLfloat argWidth, GLfloat argHeight, GLfloat distanceMax);
+void recreateFlocks(const vector<Unit*>& argUnits, vector<Flock>& argFlocks, GLfloat argWidth, GLfloat argHeight, GLfloat distanceMax);
+// builds the flow field to argDestination around the idle units in argHerd - one per move order,
+// which every flock in the order shares
+shared_ptr<FlowField> buildFlowField(glm::vec2 argDestination, GLfloat argWidth, GLfloat argHeight, const vector<Unit*>& argHerd);
 // function that will test if units are close enough to be put into the same cluster
 bool closeEnough(Unit* unit1, Unit* unit2, GLfloat distanceTolerance);
 bool closeEnough(glm::vec2 position1, glm::vec2 position2, GLfloat distanceTolerance);
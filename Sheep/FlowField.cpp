@@ -0,0 +1,123 @@
+#include "StrictFloat.h"
+#include "FlowField.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+FlowField::FlowField(GLfloat argWidth, GLfloat argHeight, GLfloat argCellSize)
+	: cellSize(argCellSize), goal(0.f), goalCell(0)
+{
+	columns = std::max(1, static_cast<GLint>(ceil(argWidth / cellSize)));
+	rows = std::max(1, static_cast<GLint>(ceil(argHeight / cellSize)));
+	cost.assign(columns * rows, 0);
+}
+
+GLuint FlowField::cellCount(GLfloat argWidth, GLfloat argHeight, GLfloat argCellSize)
+{
+	return std::max(1, static_cast<GLint>(ceil(argWidth / argCellSize))) * std::max(1, static_cast<GLint>(ceil(argHeight / argCellSize)));
+}
+
+void FlowField::addObstacle(glm::vec2 position, GLfloat radius)
+{
+	for (GLint r = row(position.y - radius); r <= row(position.y + radius); r++)
+		for (GLint c = column(position.x - radius); c <= column(position.x + radius); c++)
+			cost[r * columns + c] += FLOW_FIELD_OBSTACLE_COST;
+}
+
+void FlowField::restore(glm::vec2 argGoal, const GLuint* argCosts)
+{
+	cost.assign(argCosts, argCosts + columns * rows);
+	build(argGoal);
+}
+
+void FlowField::build(glm::vec2 argGoal)
+{
+	goal = argGoal;
+	goalCell = row(goal.y) * columns + column(goal.x);
+
+	// Dijkstra outward from the goal
+	const GLuint unreached = std::numeric_limits<GLuint>::max();
+	integrated.assign(columns * rows, unreached);
+	typedef std::pair<GLuint, GLuint> Entry; // <integrated cost, cell>
+	std::priority_queue<Entry, vector<Entry>, std::greater<Entry> > open;
+	integrated[goalCell] = 0;
+	open.push(Entry(0, goalCell));
+	while (!open.empty())
+	{
+		Entry current = open.top();
+		open.pop();
+		if (current.first > integrated[current.second])
+			continue; // already reached more cheaply
+		GLint c = current.second % columns, r = current.second / columns;
+		for (GLint dr = -1; dr <= 1; dr++)
+		{
+			for (GLint dc = -1; dc <= 1; dc++)
+			{
+				GLint nc = c + dc, nr = r + dr;
+				if ((dc == 0 && dr == 0) || nc < 0 || nr < 0 || nc >= static_cast<GLint>(columns) || nr >= static_cast<GLint>(rows))
+					continue;
+				// walking from the neighbor into this cell costs the step plus this cell's obstacles
+				GLuint neighbor = nr * columns + nc;
+				GLuint total = current.first + (dc && dr ? FLOW_FIELD_DIAGONAL_COST : FLOW_FIELD_STEP_COST) + cost[current.second];
+				if (total < integrated[neighbor])
+				{
+					integrated[neighbor] = total;
+					open.push(Entry(total, neighbor));
+				}
+			}
+		}
+	}
+
+	// point every cell downhill
+	directions.assign(columns * rows, glm::vec2(0.f));
+	for (GLint r = 0; r < static_cast<GLint>(rows); r++)
+	{
+		for (GLint c = 0; c < static_cast<GLint>(columns); c++)
+		{
+			GLuint best = integrated[r * columns + c];
+			for (GLint dr = -1; dr <= 1; dr++)
+			{
+				for (GLint dc = -1; dc <= 1; dc++)
+				{
+					GLint nc = c + dc, nr = r + dr;
+					if (nc < 0 || nr < 0 || nc >= static_cast<GLint>(columns) || nr >= static_cast<GLint>(rows))
+						continue;
+					if (integrated[nr * columns + nc] < best)
+					{
+						best = integrated[nr * columns + nc];
+						directions[r * columns + c] = glm::normalize(glm::vec2(dc * 1.f, dr * 1.f));
+					}
+				}
+			}
+		}
+	}
+}
+
+glm::vec2 FlowField::direction(glm::vec2 position) const
+{
+	glm::vec2 cellDirection = directions[row(position.y) * columns + column(position.x)];
+	if (cellDirection != glm::vec2(0.f))
+		return cellDirection;
+	// in the goal's cell - head straight for the goal
+	glm::vec2 toGoal = goal - position;
+	if (toGoal == glm::vec2(0.f))
+		return toGoal;
+	return glm::normalize(toGoal);
+}
+
+GLboolean FlowField::nearGoal(glm::vec2 position) const
+{
+	return abs(column(position.x) - column(goal.x)) <= 1 && abs(row(position.y) - row(goal.y)) <= 1;
+}
+
+GLint FlowField::column(GLfloat x) const
+{
+	return std::min(std::max(static_cast<GLint>(floor(x / cellSize)), 0), static_cast<GLint>(columns) - 1);
+}
+
+GLint FlowField::row(GLfloat y) const
+{
+	return std::min(std::max(static_cast<GLint>(floor(y / cellSize)), 0), static_cast<GLint>(rows) - 1);
+}
@@ -0,0 +1,55 @@
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Memory.h"
+
+using namespace std;
+
+// size of a flow field cell - about half a sheep, coarse enough to build the field in a blink
+const GLfloat FLOW_FIELD_CELL_SIZE = 25.f;
+// cost of stepping to a neighboring cell, straight and diagonally
+const GLuint FLOW_FIELD_STEP_COST = 10;
+const GLuint FLOW_FIELD_DIAGONAL_COST = 14;
+// extra cost of stepping into a cell for each obstacle covering it
+const GLuint FLOW_FIELD_OBSTACLE_COST = 40;
+
+// Directions toward one goal from anywhere in the world, on a coarse grid. The field is built
+// once per move order, by integrating the cost of getting to the goal outward from it, and each
+// cell points at its cheapest neighbor. Any number of units can then share it and look up which
+// way to walk in constant time, and they head around obstacles rather than into them.
+class FlowField
+{
+public:
+	GLfloat cellSize;
+	GLuint columns, rows;
+	glm::vec2 goal;
+
+	// constructors
+	FlowField(GLfloat argWidth, GLfloat argHeight, GLfloat argCellSize = FLOW_FIELD_CELL_SIZE);
+	// cells a field over a world this size has, without making one
+	static GLuint cellCount(GLfloat argWidth, GLfloat argHeight, GLfloat argCellSize = FLOW_FIELD_CELL_SIZE);
+	// makes the cells covered by the circle more expensive to walk through - call before build()
+	void addObstacle(glm::vec2 position, GLfloat radius);
+	void build(glm::vec2 argGoal);
+	// unit vector pointing the way to walk from position
+	glm::vec2 direction(glm::vec2 position) const;
+	// whether position is in or next to the goal's cell, where the field is too coarse to be of use
+	GLboolean nearGoal(glm::vec2 position) const;
+	// what build() went off of, besides the goal - a field is saved as these and rebuilt from them
+	const vector<GLuint, TrackedAllocator<GLuint, MEMORY_FLOW_FIELDS> >& cellCosts() const { return cost; }
+	void restore(glm::vec2 argGoal, const GLuint* argCosts);
+private:
+	vector<GLuint, TrackedAllocator<GLuint, MEMORY_FLOW_FIELDS> > cost;		  // cost of stepping into each cell
+	vector<GLuint, TrackedAllocator<GLuint, MEMORY_FLOW_FIELDS> > integrated;	  // cheapest total cost from each cell to the goal
+	vector<glm::vec2, TrackedAllocator<glm::vec2, MEMORY_FLOW_FIELDS> > directions; // toward the cheapest neighbor, zero in the goal's cell
+	GLuint goalCell;
+
+	GLint column(GLfloat x) const;
+	GLint row(GLfloat y) const;
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include "Framebuffer.h"
+#include "Memory.h"
+
+#include <iostream>
+
+Framebuffer::Framebuffer(GLuint argWidth, GLuint argHeight)
+	: Width(argWidth), Height(argHeight)
+{
+	colorTexture.Internal_Format = GL_RGBA;
+	colorTexture.Image_Format = GL_RGBA;
+	colorTexture.Wrap_S = GL_CLAMP_TO_EDGE;
+	colorTexture.Wrap_T = GL_CLAMP_TO_EDGE;
+	colorTexture.Generate(Width, Height, NULL);
+
+	glGenFramebuffers(1, &ID);
+	Memory::trackGL(GL_OBJECT_FRAMEBUFFER, ID, 0); // its memory is the texture's
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture.ID, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		std::cout << "ERROR::FRAMEBUFFER: Framebuffer is not complete" << std::endl;
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+Framebuffer::~Framebuffer()
+{
+	glDeleteFramebuffers(1, &ID);
+	glDeleteTextures(1, &colorTexture.ID);
+	Memory::untrackGL(GL_OBJECT_FRAMEBUFFER, ID);
+	Memory::untrackGL(GL_OBJECT_TEXTURE, colorTexture.ID);
+}
+
+void Framebuffer::bind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+}
+
+void Framebuffer::unbind()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void Framebuffer::blitToScreen()
+{
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, ID);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	glBlitFramebuffer(0, 0, Width, Height, 0, 0, Width, Height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
@@ -0,0 +1,30 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <GL/glew.h>
+
+#include "Texture2D.h"
+
+// Offscreen render target with a single color attachment. Used to keep a finished
+// image around, so it can be put back on screen without drawing it all over again.
+class Framebuffer
+{
+public:
+	GLuint ID;
+	Texture2D colorTexture;
+	GLuint Width, Height;
+
+	// constructors
+	Framebuffer(GLuint argWidth, GLuint argHeight);
+	~Framebuffer();
+	// rendering - draws go into the framebuffer between bind() and unbind()
+	void bind();
+	void unbind();
+	// copies the color attachment onto the default framebuffer
+	void blitToScreen();
+private:
+	Framebuffer(const Framebuffer&);
+	Framebuffer& operator=(const Framebuffer&);
+};
+
+#endif
@@ -7,6 +7,7 @@
 ** option) any later version.
 ******************************************************************/
 
+#include "StrictFloat.h"
 #include "game.h"
 
 using namespace std;
@@ -14,34 +15,65 @@ using namespace irrklang;
 ISoundEngine* SoundEngine = createIrrKlangDevice();
 
 // externals
-GameState Game::State;
+std::atomic<GameState> Game::State;
 GLboolean Game::gamestateInitialized;
 GLuint Game::Width, Game::Height;
 vector<Unit*> Game::units;
-vector<Unit*> Game::selectedUnits;
 vector<Flock> Game::flocks;
+PathingMode Game::pathingMode = PATHING_STRAIGHT;
+Steering Game::steering;
+GLboolean Game::steeringEnabled = false;
+GLboolean Game::showMemory = false;
+MemoryReport Game::memoryReport;
+CollisionSolver* Game::collisionSolver;
+SpatialGrid* Game::unitGrid;
+vector<GLuint> Game::gridQuery;
 HazardHandler* Game::hazardHandler;
 Difficulty Game::difficulty;
-vector<PowerUp*> Game::powerUps;
+PowerUpArchetype Game::powerUps;
 GLfloat Game::powerUpSpawnTime = 10;
+TimerWheel Game::powerUpTimers;
+vector<TimerEvent> Game::timerEvents;
+Random Game::random;
+RewindBuffer Game::rewindBuffer;
+GLboolean Game::rewinding = false;
+GLuint Game::rewindTick;
+vector<unsigned char> Game::rewindState;
+vector<glm::vec2> Game::rewindPositions;
 Drawable* Game::selectionBox;
 Button* Game::buttonEnd;
 Button* Game::buttonStart;
 Button* Game::buttonSetSimple; 
 Button* Game::buttonSetNormal;
+Framebuffer* Game::menuComposite;
+GLint Game::menuCompositeState = -1;
+StreamBuffer* Game::streamBuffer;
+RenderQueue* Game::renderQueue;
 SpriteRenderer* Game::spriteRenderer;
 SpriteRenderer* Game::selectionBoxRenderer;
 SpriteRenderer* Game::textRenderer;
+Simulation* Game::simulation;
+TripleBuffer<RenderSnapshot>* Game::snapshots;
+WorkerPool* Game::workers;
 GLfloat Game::gameTime;
 GLint Game::gameScore;
 GLint Game::incDebug;
+uint64_t Game::stateHash;
 
 Game::~Game()
 {
+	// stop ticking before anything the ticks use goes away
+	if (simulation) delete simulation;
+	if (snapshots) delete snapshots;
+	if (collisionSolver) delete collisionSolver;
+	if (workers) delete workers;
 	clearGamestate();
 	if (spriteRenderer) delete spriteRenderer;
 	if (selectionBoxRenderer) delete selectionBoxRenderer;
 	if (textRenderer) delete textRenderer;
+	if (renderQueue) delete renderQueue;
+	if (streamBuffer) delete streamBuffer;
+	if (menuComposite) delete menuComposite;
 }
 
 void Game::InitVariables(GLuint width, GLuint height)
@@ -53,6 +85,7 @@ void Game::InitVariables(GLuint width, GLuint height)
 	incDebug = 0.f;
 	State = GAME_START;
 	difficulty = SIMPLE;
+	Kernels::init();
 }
  
 void Game::InitGraphics()
@@ -73,13 +106,26 @@ void Game::InitGraphics()
 	ResourceManager::GetShader("text").SetMatrix4("projection",
 		glm::ortho(0.0f, static_cast<GLfloat> (Width), 0.0f, static_cast<GLfloat>(Height)));
 
-	// Set render-specific controls
-	spriteRenderer = new SpriteRenderer(ResourceManager::GetShader("sprite"));
-	selectionBoxRenderer = new SpriteRenderer(ResourceManager::GetShader("selectionBox"));
-	textRenderer = new SpriteRenderer(ResourceManager::GetShader("text"));
+	// Set render-specific controls - all per-frame vertex and instance data is streamed through one ring buffer
+	streamBuffer = new StreamBuffer(12 * 1024 * 1024);
+	spriteRenderer = new SpriteRenderer(ResourceManager::GetShader("sprite"), streamBuffer);
+	selectionBoxRenderer = new SpriteRenderer(ResourceManager::GetShader("selectionBox"), streamBuffer);
+	textRenderer = new SpriteRenderer(ResourceManager::GetShader("text"), streamBuffer);
+	renderQueue = new RenderQueue(streamBuffer);
+	spriteRenderer->queue = renderQueue;
+	selectionBoxRenderer->queue = renderQueue;
+
+	// the simulation thread records into renderQueue and swaps the result into a snapshot each tick
+	snapshots = new TripleBuffer<RenderSnapshot>(RenderSnapshot(streamBuffer));
+	simulation = new Simulation(&Game::TickGame, 1.f / SIMULATION_TICK_RATE);
+	// one core each for the render and simulation threads, and the rest help the simulation out
+	GLuint cores = std::max(2u, std::thread::hardware_concurrency());
+	workers = new WorkerPool(cores - 2);
+	collisionSolver = new CollisionSolver(workers, Width, Height, UNIT_GRID_CELL_SIZE);
+	Telemetry::open(TELEMETRY_FILE);
 
 	// initializing text rendering
-	TextUtil::init();
+	TextUtil::init(streamBuffer);
 
 	/// Load textures
 	// sprites
@@ -110,6 +156,9 @@ void Game::InitMenu()
 	// end menu buttons
 	buttonEnd = new Button(glm::vec2(.5 * Width, .8 * Height), glm::vec2(150.0, 100.0),
 		ResourceManager::GetTexture("restartButton"), glm::vec4(1.0f), 0.0f, true, &(Game::cbRestart));
+	// the menu is drawn into here, and only redrawn when it changes
+	menuComposite = new Framebuffer(Width, Height);
+	menuCompositeState = -1;
 }
 
 void Game::InitGamestate()
@@ -129,92 +178,169 @@ void Game::InitGamestate()
 		units.push_back(new Unit(locs[i], glm::vec2(50, 50),
 			ResourceManager::GetTexture("sheep"), glm::vec4(1.0f), true, 0.0f, 100.f));
 	}
+	random.seed(static_cast<uint64_t>(time(NULL)));
+	rewindBuffer.clear();
+	rewinding = false;
+	InitWorld();
+	unitGrid->build(units);
+	// the first spawns count from the start of the game, like the timers do
+	gameScore = 0;
+	gameTime = 0;
+	hazardHandler->init();
+	powerUpSpawnTime = gameTime + 10.f;
+	schedulePowerUps();
+	gamestateInitialized = true;
+	// so the first frame shows this game rather than whatever the last one ended on
+	RecordGame();
+}
+
+void Game::InitWorld()
+{
+	unitGrid = new SpatialGrid(Width, Height, UNIT_GRID_CELL_SIZE);
 	// selection box - don't draw it initially
 	selectionBox = new Drawable(glm::vec2(0, 0), glm::vec2(0, 0),
 		ResourceManager::GetTexture("selectionBox"), glm::vec4(1.0, 1.0, .4, .25), 0.0, false);
 
 	// hazards - test lazer, for now
-	hazardHandler = new HazardHandler(difficulty, Width, Height,
+	hazardHandler = new HazardHandler(difficulty, Width, Height, &random,
 		ResourceManager::GetTexture("Lazer"), ResourceManager::GetTexture("LazerExploded"),
 		ResourceManager::GetTexture("Rocket"), ResourceManager::GetTexture("RocketExploded"), ResourceManager::GetTexture("RocketTarget"));
-	hazardHandler->init();
-	powerUpSpawnTime = glfwGetTime() + 10.f;
-	srand(time(NULL));
+}
 
-	gameScore = 0;
-	gameTime = 0;
-	gamestateInitialized = true;
+void Game::schedulePowerUps()
+{
+	powerUpTimers.clear(gameTime);
+	powerUpTimers.schedule(powerUpSpawnTime, POWER_UP_SPAWN, 0);
 }
 
 void Game::clearGamestate()
 {
 	if (selectionBox)
 	delete selectionBox;
+	selectionBox = nullptr;
 	for (unsigned int i = 0; i < units.size(); i++)
 		delete units[i];
 	units.clear();
-	for (unsigned int i = 0; i < powerUps.size(); i++)
-		delete powerUps[i];
+	Selection::clear();
+	if (collisionSolver)
+		collisionSolver->wakeAll(units);
+	if (unitGrid)
+		delete unitGrid;
+	unitGrid = nullptr;
 	powerUps.clear();
 	if (hazardHandler)
 	delete hazardHandler;
+	hazardHandler = nullptr;
 	gamestateInitialized = false;
 }
 
+GLboolean Game::TickGame(GLfloat dt)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	InputHandler::sample();
+	if (!RewindGame())
+	{
+		ProcessInput(dt);
+		UpdateGame(dt);
+		rewindState.clear();
+		Snapshot::writeRewind(rewindState, rewindPositions);
+		rewindBuffer.record(rewindState, rewindPositions);
+		Telemetry::current.tickDuration = std::chrono::duration<GLfloat>(std::chrono::steady_clock::now() - start).count();
+		Telemetry::commit();
+	}
+	RecordGame();
+	return State == GAME_PLAYING;
+}
+
+GLboolean Game::RewindGame()
+{
+	GLboolean back = InputHandler::keys[GLFW_KEY_LEFT_BRACKET], forward = InputHandler::keys[GLFW_KEY_RIGHT_BRACKET];
+	if (!rewinding)
+	{
+		if (!back || rewindBuffer.empty())
+			return false;
+		rewinding = true;
+		rewindTick = rewindBuffer.lastTick();
+	}
+	// a tick of the recording per tick, so it scrubs at the speed it was played
+	GLuint shown = rewindTick;
+	if (back && rewindTick > rewindBuffer.firstTick())
+		rewindTick--;
+	else if (forward && rewindTick < rewindBuffer.lastTick())
+		rewindTick++;
+	if (rewindTick != shown && rewindBuffer.seek(rewindTick, rewindState, rewindPositions))
+		Snapshot::readRewind(rewindState, rewindPositions);
+	// playing on from an earlier tick forgets the ones after it
+	if (InputHandler::keys[GLFW_KEY_ENTER] && !InputHandler::keysPrev[GLFW_KEY_ENTER])
+	{
+		rewindBuffer.truncate(rewindTick);
+		rewinding = false;
+	}
+	else if (forward && rewindTick == rewindBuffer.lastTick())
+		rewinding = false;
+	return rewinding;
+}
+
 void Game::UpdateGame(GLfloat dt)
 {
-	// updating values in units
+	// units make room for each other before they get to overlap
+	if (steeringEnabled)
+		steering.update(units, *unitGrid);
+	//updating unit positions
 	for (unsigned int i = 0; i < units.size(); i++)
 	{
-		//updating unit positions
 		units[i]->move(dt);
-
-		for (unsigned int j = 0; j < units.size(); j++)
-		{
-			if (i == j)  // if the unit we're looking at is not the same one we just moved, skip
-				continue;
-			if (doesPenetrate(units[i], units[j]))
-			{
-				units[i]->position -= penetrationVector(units[i], units[j]);
-				if (!units[j]->moving)
-				{
-					units[i]->stop();
-					units[j]->stop();
-				}
-			}
-		}
+		Telemetry::current.movingUnits += units[i]->moving;
 	}
+	// pushing apart the units that walked into each other - settled ones are asleep and left alone
+	collisionSolver->solve(units);
+	Telemetry::current.pairEvaluations = collisionSolver->pairEvaluations;
+	GLboolean herdChanged = false;
 	// handling powerups
+	// spawning powerups, as they come due
+	timerEvents.clear();
+	powerUpTimers.advance(gameTime, timerEvents);
+	for (GLuint i = 0; i < timerEvents.size(); i++)
+	{
+		glm::vec2 randomLocation = glm::vec2((100 + random.below(Width - 50))*1.f, (100 + random.below(Height - 50))*1.f);
+		Transform transform = { randomLocation, glm::vec2(50, 50), 0.f };
+		Sprite sprite = { ResourceManager::GetTexture("Life"), glm::vec4(1.0f) };
+		powerUps.create(transform, sprite);
+		powerUpSpawnTime += powerUpSpawnTime + 1.f;
+		powerUpTimers.schedule(powerUpSpawnTime, POWER_UP_SPAWN, 0);
+	}
 	for (unsigned int i = 0; i < powerUps.size(); i++)
 	{
-		powerUps[i]->update(dt);
+		const Transform& powerUp = powerUps.column<Transform>()[i];
 		for (unsigned int j = 0; j < units.size(); j++)
 		{
-			if (powerUps[i]->inHitbox(units[j])) // here
+			// swept, so a unit that walks clean over the power up in one tick still picks it up
+			GLfloat timeOfImpact;
+			if (sweptPenetrate(units[j]->prevPosition, units[j]->position, units[j]->radius(),
+				powerUp.position, powerUp.position, powerUp.size.x / 2, timeOfImpact))
 			{
-				glm::vec2 tempPosition = powerUps[i]->position;
+				glm::vec2 tempPosition = powerUp.position;
 				// getting rid of powerup
-				delete powerUps[i];
-				powerUps.erase(powerUps.begin() + i);
+				powerUps.destroy(powerUps.entity(i));
 				i--;
 				//adding new unit
 				units.push_back(new Unit(tempPosition, glm::vec2(50, 50),
 					ResourceManager::GetTexture("sheep"), glm::vec4(1.0f), true, 0.0f, 100.f));
+				herdChanged = true;
 				break;
 			}
 		}
 	}
-	// generating new powerups
-	if (gameTime > powerUpSpawnTime)
-	{
-		glm::vec2 randomLocation = glm::vec2((100 + (rand() % (Width - 50)))*1.f, (100 + (rand() % (Height - 50))*1.f));
-		powerUps.push_back(new PowerUp(randomLocation, glm::vec2(50, 50), ResourceManager::GetTexture("Life"), glm::vec4(1.0f),
-			GL_TRUE, 100));
-		powerUpSpawnTime += powerUpSpawnTime + 1.f;
-	}
 	// killing units - must occur at the end of updating because
 	// array size and such get modified when a unit is killed
+	GLuint unitCount = units.size();
 	hazardHandler->update(dt, units);
+	// sleepers are kept by pointer, and islands may have been broken up
+	if (units.size() < unitCount)
+	{
+		collisionSolver->wakeAll(units);
+		herdChanged = true;
+	}
 
 	// score will increase, each second, for the number of units that are still alive
 	if (differentTimeInterval(gameTime, gameTime + dt, 1))
@@ -224,7 +350,46 @@ void Game::UpdateGame(GLfloat dt)
 	if (units.size() < 5)
 		State = GAME_END;
 
+	// everything has moved, been born or died - selection next tick goes off of this. A herd that's
+	// all asleep, and hasn't changed, is where it was last time
+	if (collisionSolver->awakeCount() > 0 || herdChanged)
+		unitGrid->build(units);
+
 	gameTime += dt;
+	stateHash = hashState();
+	Telemetry::current.gameTime = gameTime;
+	Telemetry::current.units = units.size();
+	Telemetry::current.powerUps = powerUps.size();
+	Telemetry::current.stateHash = stateHash;
+}
+
+uint64_t Game::hashState()
+{
+	uint64_t hash = hashBytes(&gameTime, sizeof(gameTime));
+	hash = hashBytes(&gameScore, sizeof(gameScore), hash);
+	for (GLuint i = 0; i < units.size(); i++)
+	{
+		hash = hashBytes(&units[i]->id, sizeof(units[i]->id), hash);
+		hash = hashBytes(&units[i]->position, sizeof(units[i]->position), hash);
+		hash = hashBytes(&units[i]->moving, sizeof(units[i]->moving), hash);
+	}
+	const RocketArchetype& rockets = hazardHandler->rockets;
+	for (GLuint i = 0; i < rockets.size(); i++)
+	{
+		const Transform& transform = rockets.column<Transform>()[i];
+		hash = hashBytes(&transform.position, sizeof(transform.position), hash);
+		hash = hashBytes(&transform.rotation, sizeof(transform.rotation), hash);
+		hash = hashBytes(&rockets.column<Timer>()[i].due, sizeof(GLfloat), hash);
+	}
+	const LazerArchetype& lazers = hazardHandler->lazers;
+	for (GLuint i = 0; i < lazers.size(); i++)
+	{
+		hash = hashBytes(&lazers.column<Transform>()[i].position, sizeof(glm::vec2), hash);
+		hash = hashBytes(&lazers.column<Timer>()[i].due, sizeof(GLfloat), hash);
+	}
+	for (GLuint i = 0; i < powerUps.size(); i++)
+		hash = hashBytes(&powerUps.column<Transform>()[i].position, sizeof(glm::vec2), hash);
+	return hash;
 }
 
 void Game::UpdateMenu(GLfloat dt)
@@ -279,93 +444,163 @@ void Game::ProcessInput(GLfloat dt)
 		}
 
 
+		// if not holding shift, deselect everything outside of the box - which is everything,
+		// before selecting what's in it
+		if (InputHandler::mod != GLFW_MOD_SHIFT)
+			Selection::clear();
 		// select units within bounds
-		for (unsigned int i = 0; i < units.size(); i++)
-		{
-			// if within box, select unit
-			if (((units[i]->position.x + units[i]->size.x / 2) > selectionBox->position.x)
-				&& ((units[i]->position.x - units[i]->size.x / 2) < selectionBox->position.x + selectionBox->size.x)
-				&& ((units[i]->position.y + units[i]->size.y / 2) > selectionBox->position.y)
-				&& ((units[i]->position.y - units[i]->size.y / 2) < selectionBox->position.y + selectionBox->size.y))
-				units[i]->select();
-			//if not within box
-			else
-			{
-				// if not holding shift, deselect
-				if (InputHandler::mod != GLFW_MOD_SHIFT)
-					units[i]->deselect();
-			}
-		}
+		unitGrid->query(selectionBox->position, selectionBox->position + selectionBox->size, gridQuery);
+		for (unsigned int i = 0; i < gridQuery.size(); i++)
+			units[gridQuery[i]]->select();
 	}
 	// movement input
 	else if (InputHandler::rightClickState == GLFW_PRESS && InputHandler::rightClickStatePrev == GLFW_RELEASE)
 	{
-		// only consider units that are selected in the flock stuff
-		selectedUnits.clear();
-		for (unsigned int i = 0; i < units.size(); i++)
-		{
-			if (units[i]->selected)
-				selectedUnits.push_back(units[i]);
-		}
-		// use helper function to recreate flocks, which destroys previous flocks
-		recreateFlocks(selectedUnits, flocks, Width, Height, 65.f);
-
-		for (unsigned int i = 0; i < flocks.size(); i++)
-		{
-			flocks[i].setDestination(glm::vec2(InputHandler::mXpos, InputHandler::mYpos));
-		}
+		orderSelection(glm::vec2(InputHandler::mXpos, InputHandler::mYpos));
+	}
+	if (InputHandler::keys[GLFW_KEY_P] && !InputHandler::keysPrev[GLFW_KEY_P])
+		pathingMode = pathingMode == PATHING_FLOW_FIELD ? PATHING_STRAIGHT : PATHING_FLOW_FIELD;
+	if (InputHandler::keys[GLFW_KEY_B] && !InputHandler::keysPrev[GLFW_KEY_B])
+	{
+		steeringEnabled = !steeringEnabled;
+		if (!steeringEnabled)
+			Steering::reset(units);
 	}
 	if (InputHandler::keys[GLFW_KEY_S])
 	{
-		for (unsigned int i = 0; i < units.size(); i++)
-		{
-			if (units[i]->selected)
-				units[i]->stop();
-		}
+		const vector<Unit*>& selected = Selection::units();
+		for (unsigned int i = 0; i < selected.size(); i++)
+			selected[i]->stop();
 	}
+	// memory accounting
+	if (InputHandler::keys[GLFW_KEY_F2] && !InputHandler::keysPrev[GLFW_KEY_F2])
+	{
+		vector<string> report;
+		Memory::report(report);
+		for (GLuint i = 0; i < report.size(); i++)
+			std::cout << report[i] << std::endl;
+	}
+	if (InputHandler::keys[GLFW_KEY_F3] && !InputHandler::keysPrev[GLFW_KEY_F3])
+		showMemory = !showMemory;
+	// quicksave - last, as loading swaps out everything above
+	if (InputHandler::keys[GLFW_KEY_F5] && !InputHandler::keysPrev[GLFW_KEY_F5])
+		Snapshot::save(QUICKSAVE_FILE);
+	if (InputHandler::keys[GLFW_KEY_F9] && !InputHandler::keysPrev[GLFW_KEY_F9] && Snapshot::load(QUICKSAVE_FILE))
+		rewindBuffer.clear(); // the recording leads up to a different game now
 }
 
-void Game::RenderGame(GLfloat dt)
+void Game::orderSelection(glm::vec2 argDestination)
+{
+	// only consider units that are selected in the flock stuff
+	// use helper function to recreate flocks, which destroys previous flocks
+	recreateFlocks(Selection::units(), flocks, Width, Height, 65.f);
+
+	// the flocks all head for the one point, so they share the one field
+	shared_ptr<FlowField> field;
+	if (pathingMode == PATHING_FLOW_FIELD && !flocks.empty())
+		field = buildFlowField(argDestination, Width, Height, units);
+	for (unsigned int i = 0; i < flocks.size(); i++)
+	{
+		if (field)
+			flocks[i].setFlowDestination(field, gameTime);
+		else
+			flocks[i].setDestination(argDestination, gameTime);
+	}
+}
+
+void Game::RecordGame()
 {
+	// sprites are queued up by layer and drawn sorted by shader and texture
 	// draw background
+	renderQueue->layer = LAYER_BACKGROUND;
 	spriteRenderer->DrawSprite(ResourceManager::GetTexture("background"),
 		glm::vec2(Width/2, Height/2), glm::vec2(Width, Height), 0.0f, glm::vec4(1.0f));
 	// draw Lazers behind units
+	renderQueue->layer = LAYER_LAZERS;
 	hazardHandler->drawLazers(*spriteRenderer);
-	if (differentTimeInterval(gameTime, gameTime + dt, .05f))
-		for (unsigned int i = 0; i < hazardHandler->lazers.size(); i++)
-			hazardHandler->lazers[i]->sampleFrame++;
 	// draw powerups
-	for (unsigned int i = 0; i < powerUps.size(); i++)
-		powerUps[i]->draw(*spriteRenderer);
+	renderQueue->layer = LAYER_POWERUPS;
+	drawSprites(*spriteRenderer, powerUps.column<Transform>(), powerUps.column<Sprite>(), powerUps.size());
 	// draw units
+	renderQueue->layer = LAYER_UNITS;
 	for (unsigned int i = 0; i < units.size(); i++)
-	{
-		if (!units[i]->moving)
-			units[i]->sampleFrame = 0;
-		else if (differentTimeInterval(gameTime, gameTime + dt, .1f) && units[i]->moving)
-			units[i]->sampleFrame++;
-		units[i]->draw(*spriteRenderer, glm::vec2(7.0f, 1.0f), units[i]->sampleFrame);
-	}
+		units[i]->draw(*spriteRenderer, glm::vec2(UNIT_WALK_FRAMES, 1.0f), units[i]->sampleFrame);
 	// draw rockets on top of units
+	renderQueue->layer = LAYER_ROCKETS;
 	hazardHandler->drawRockets(*spriteRenderer);
+	renderQueue->layer = LAYER_SELECTION;
 	selectionBox->drawTopLeft(*selectionBoxRenderer);
+	renderQueue->sort();
+
+	// hand it over - renderQueue gets the storage of an old snapshot to record into next time, and
+	// that snapshot's sprites with it, which the menus would draw again if they were left in
+	RenderSnapshot& snapshot = snapshots->back();
+	snapshot.sprites.swap(*renderQueue);
+	renderQueue->clear();
+	snapshot.gameTime = gameTime;
+	snapshot.gameScore = gameScore;
+	snapshot.showMemory = showMemory;
+	snapshots->publish();
+}
+
+void Game::RenderGame(GLfloat dt)
+{
+	// draws the latest tick - the same one again if the simulation hasn't published since
+	snapshots->update();
+	RenderSnapshot& snapshot = snapshots->front();
+	// animations are stepped through on the GPU against the game clock
+	ResourceManager::GetShader("sprite").Use().SetFloat("time", snapshot.gameTime);
+	snapshot.sprites.draw();
 
 	// rendering text test
-	TextUtil::RenderText(ResourceManager::GetShader("text"), "Score: " + std::to_string(gameScore),
+	TextUtil::RenderText(ResourceManager::GetShader("text"), "Score: " + std::to_string(snapshot.gameScore),
 		5.f, Height - 20.f, .5f, glm::vec4(0.f, 0.f, 0.f, 1.f));
+	if (snapshot.showMemory)
+	{
+		memoryReport.update();
+		const vector<string>& report = memoryReport.lines();
+		for (GLuint i = 0; i < report.size(); i++)
+			TextUtil::RenderText(ResourceManager::GetShader("text"), report[i],
+				5.f, Height - 40.f - i * 14.f, .3f, glm::vec4(0.f, 0.f, 0.f, 1.f));
+	}
 }
 
 void Game::RenderMenu(GLfloat dt)
 {
-	// draw background
+	// the menu only changes when a button or the difficulty does, so it's drawn once into
+	// the composite and just copied to the screen while the player sits on it
+	GLint state = menuState();
+	if (state != menuCompositeState)
+	{
+		menuComposite->bind();
+		ComposeMenu(dt);
+		menuComposite->unbind();
+		menuCompositeState = state;
+	}
+	menuComposite->blitToScreen();
+}
+
+GLint Game::menuState()
+{
+	// everything the look of the menu depends on, packed two bits apiece
+	return State | (difficulty << 2) | (buttonStart->sampleFrame << 4) | (buttonSetSimple->sampleFrame << 6)
+		| (buttonSetNormal->sampleFrame << 8) | (buttonEnd->sampleFrame << 10);
+}
+
+void Game::ComposeMenu(GLfloat dt)
+{
+	// draw background - on its own, as the end screen draws the last tick and its text over it
+	renderQueue->layer = LAYER_BACKGROUND;
 	spriteRenderer->DrawSprite(ResourceManager::GetTexture("background"),
 		glm::vec2(Width / 2, Height / 2), glm::vec2(Width, Height), 0.0f, glm::vec4(1.0f));
+	renderQueue->flush();
 	if (State == GAME_START)
 	{
+		renderQueue->layer = LAYER_MENU;
 		buttonStart->render(*spriteRenderer, glm::vec2(3.f, 1.f), buttonStart->sampleFrame);
 		buttonSetSimple->render(*spriteRenderer, glm::vec2(3.f, 1.f), buttonSetSimple->sampleFrame);
 		buttonSetNormal->render(*spriteRenderer, glm::vec2(3.f, 1.f), buttonSetNormal->sampleFrame);
+		renderQueue->flush();
 		TextUtil::RenderText(ResourceManager::GetShader("text"), "Sheep",
 			.275 * Width, .65 * Height, 3.f, glm::vec4(0.f, 0.f, 0.f, 1.f));
 		TextUtil::RenderText(ResourceManager::GetShader("text"), "Simple",
@@ -380,6 +615,8 @@ void Game::RenderMenu(GLfloat dt)
 			.3 * Width, .4 * Height, 1.5f, glm::vec4(0.f, 0.f, 0.f, 1.f));
 		TextUtil::RenderText(ResourceManager::GetShader("text"), std::to_string(gameScore),
 			.4 * Width, .32 * Height, 1.5f, glm::vec4(0.f, 0.f, 0.f, 1.f));
+		renderQueue->layer = LAYER_MENU;
 		buttonEnd->render(*spriteRenderer, glm::vec2(3.f, 1.f), buttonEnd->sampleFrame);
+		renderQueue->flush();
 	}
 }
\ No newline at end of file
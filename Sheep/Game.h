@@ -13,6 +13,9 @@
 #include <GLFW/glfw3.h>
 #include <vector>
 #include <tuple>
+#include <atomic>
+#include <time.h>
+#include <chrono>
 #ifndef _USE_MATH_DEFINES
 #define _USE_MATH_DEFINES
 #endif //_USE_MATH_DEFINES
@@ -21,20 +24,42 @@
 
 #include "TextUtil.h"
 #include "ResourceManager.h"
+#include "StreamBuffer.h"
 #include "SpriteRenderer.h"
+#include "RenderQueue.h"
+#include "Framebuffer.h"
+#include "TripleBuffer.h"
+#include "Simulation.h"
 #include "Drawable.h"
 #include "Unit.h"
 #include "Flock.h"
+#include "Selection.h"
+#include "SpatialGrid.h"
+#include "Steering.h"
+#include "WorkerPool.h"
+#include "CollisionSolver.h"
 #include "CollisionUtil.h"
-#include "Hazard.h"
-#include "Rocket.h"
-#include "Lazer.h"
+#include "Archetype.h"
+#include "Components.h"
+#include "Systems.h"
 #include "HazardHandler.h"
-#include "PowerUp.h"
 #include "Button.h"
 #include "InputHandler.h"
+#include "MappedFile.h"
+#include "Random.h"
+#include "Snapshot.h"
+#include "RewindBuffer.h"
+#include "Telemetry.h"
+#include "Memory.h"
+#include "Kernels.h"
 
 
+// How move orders get units to their destination
+enum PathingMode {
+	PATHING_STRAIGHT,  // each unit walks a straight line, keeping the flock's formation
+	PATHING_FLOW_FIELD // each flock shares a flow field, which leads around idle units
+};
+
 // Represents the current state of the game
 enum GameState {
 	GAME_START,
@@ -42,14 +67,44 @@ enum GameState {
 	GAME_END
 };
 
+// One tick of the game as the render thread sees it. The simulation thread records the sprites
+// and hands the whole thing over, so drawing never looks at game objects while they're updated
+struct RenderSnapshot
+{
+	RenderQueue sprites; // sorted, ready to be drawn
+	GLfloat gameTime;
+	GLint gameScore;
+	GLboolean showMemory;
+
+	RenderSnapshot(StreamBuffer* argStream)
+		: sprites(argStream), gameTime(0.f), gameScore(0), showMemory(false) {}
+};
+
+// power ups - a unit that walks over one becomes two
+typedef Archetype<MEMORY_POWER_UPS, Transform, Sprite> PowerUpArchetype;
+// what the power up timers fire - they stay around until they're picked up
+enum PowerUpEvent
+{
+	POWER_UP_SPAWN
+};
+
+// units are bucketed into cells of about twice their size for selection
+const GLfloat UNIT_GRID_CELL_SIZE = 100.f;
+// game logic runs this many times per second, however fast frames are drawn
+const GLfloat SIMULATION_TICK_RATE = 60.f;
+// where F5 saves the game to, and F9 loads it from
+const char* const QUICKSAVE_FILE = "quicksave.snapshot";
+// where per-tick metrics go, for Tools/TelemetryToCsv
+const char* const TELEMETRY_FILE = "telemetry.bin";
+
 // Game holds all game-related state and functionality.
 // Combines all game-related data into a single class for
 // easy access to each of the components and manageability.
 class Game
 {
 public:
-	// Game state
-	static GameState State;
+	// Game state - set from the simulation thread when the game ends
+	static std::atomic<GameState> State;
 	static GLboolean gamestateInitialized;
 	static GLuint Width, Height;
 	
@@ -73,32 +128,61 @@ public:
 
 	// units
 	static vector<Unit*> units;
-	static vector<Unit*> selectedUnits;
 	static vector<Flock> flocks;
+	static PathingMode pathingMode; // toggled with P
+	static Steering steering;
+	static GLboolean steeringEnabled; // toggled with B
+	static CollisionSolver* collisionSolver;
+	static SpatialGrid* unitGrid; // rebuilt at the end of each tick
+	static vector<GLuint> gridQuery; // unit indices, as found by the last grid query
 	
 	// hazards & powerups
 	static HazardHandler* hazardHandler;
 	static Difficulty difficulty;
-	static vector<PowerUp*> powerUps;
+	static PowerUpArchetype powerUps;
 	static GLfloat powerUpSpawnTime;
+	static TimerWheel powerUpTimers; // spawns, keyed on gameTime
+	static vector<TimerEvent> timerEvents; // scratch
+	static Random random; // every random number the game draws comes from here
 
 	// other stuff to draw
 	static Drawable* selectionBox;
 
 	// menu stuff
 	static Button *buttonStart, *buttonSetSimple, *buttonSetNormal, *buttonEnd;
+	static Framebuffer* menuComposite; // the menu as last drawn
+	static GLint menuCompositeState;   // menuState() when the composite was drawn
 
 	// renderers
+	static StreamBuffer* streamBuffer;
+	static RenderQueue* renderQueue;
 	static SpriteRenderer* spriteRenderer;
 	static SpriteRenderer* selectionBoxRenderer;
 	static SpriteRenderer* textRenderer;
 
+	// threading - the simulation thread owns the game state while playing, and publishes what
+	// it looks like after each tick for the render thread
+	static Simulation* simulation;
+	static TripleBuffer<RenderSnapshot>* snapshots;
+	static WorkerPool* workers; // helps out the simulation thread
+
+	// rewinding - the last ticks are recorded, and holding [ and ] scrubs through them with the game
+	// paused. Enter carries on from there, as does scrubbing all the way forward again
+	static RewindBuffer rewindBuffer;
+	static GLboolean rewinding;
+	static GLuint rewindTick;		   // tick being shown while rewinding
+	static vector<unsigned char> rewindState; // scratch for snapshots going in and out of the buffer
+	static vector<glm::vec2> rewindPositions; // and the units' positions, which are kept apart
+
 	// Constructor/Destructor
 	~Game();
 	// Initialize game state
 	static void InitVariables(GLuint width, GLuint height);
 	static void InitGamestate();
+	static void InitWorld(); // everything a game has besides units, hazards and power ups
 	static void InitMenu();
+	// sets the power up timers up again from gameTime and powerUpSpawnTime
+	static void schedulePowerUps();
 	static void InitGraphics();
 	// clear game state
 	static void clearGamestate();
@@ -107,17 +191,30 @@ public:
 	static void cbSetSimple() { difficulty = SIMPLE;};
 	static void cbSetNormal() {difficulty = NORMAL;};
 	static void cbRestart() { State = GAME_START; clearGamestate(); }
-	// GameLoop
+	// GameLoop - simulation thread
+	static GLboolean TickGame(GLfloat dt);
+	static GLboolean RewindGame(); // true while rewinding, when the game doesn't go on
 	static void ProcessInput(GLfloat dt);
 	static void UpdateGame(GLfloat dt);
+	static void RecordGame();
+	// sends the selected units to argDestination, as a right click does, in the current pathingMode
+	static void orderSelection(glm::vec2 argDestination);
+	// GameLoop - render thread
 	static void UpdateMenu(GLfloat dt);
 	static void RenderGame(GLfloat dt);
 	static void RenderMenu(GLfloat dt);
+	static void ComposeMenu(GLfloat dt);
+	static GLint menuState();
 
 	// other global and debugging stuff
 	static GLfloat gameTime;
 	static GLint gameScore;
 	static GLint incDebug;
+	static GLboolean showMemory; // memory overlay, toggled with F3 - F2 prints the same to the console
+	static MemoryReport memoryReport; // what the overlay shows, only formatted again as it changes
+	static uint64_t stateHash; // of everything the simulation moved, as of the end of the last tick
+	// hashes the bits of the game state - two runs agree as long as their hashes do each tick
+	static uint64_t hashState();
 };
 
 #endif
@@ -1,30 +1,18 @@
+#include "StrictFloat.h"
 #include "HazardHandler.h"
 
-HazardHandler::HazardHandler(Difficulty argDifficulty, GLfloat argWidth, GLfloat argHeight,
-	Texture2D argLazerSprite, Texture2D argLazerSpriteDetonated,
-	Texture2D argRocketSprite, Texture2D argRocketSpriteDetonated, Texture2D argRocketSpriteTarget)
-	:difficulty(argDifficulty), width(argWidth), height(argHeight),
+HazardHandler::HazardHandler(Difficulty argDifficulty, GLfloat argWidth, GLfloat argHeight, Random* argRandom,
+	TextureHandle argLazerSprite, TextureHandle argLazerSpriteDetonated,
+	TextureHandle argRocketSprite, TextureHandle argRocketSpriteDetonated, TextureHandle argRocketSpriteTarget)
+	:difficulty(argDifficulty), width(argWidth), height(argHeight), random(argRandom),
 	lazerSprite(argLazerSprite), lazerSPriteDetonated(argLazerSpriteDetonated),
 	rocketSprite(argRocketSprite), rocketSpriteDetonated(argRocketSpriteDetonated), rocketSpriteTarget(argRocketSpriteTarget)
 {
 
 }
 
-HazardHandler::~HazardHandler()
-{
-	for (unsigned int i = 0; i < lazers.size(); i++)
-		delete lazers[i];
-	lazers.clear();
-	for (unsigned int i = 0; i < rockets.size(); i++)
-		delete rockets[i];
-	rockets.clear();
-}
-
 void HazardHandler::init()
 {
-	// random seeds
-	srand(time(NULL));
-	
 	if (difficulty == SIMPLE)
 	{
 		// lazer stats
@@ -37,6 +25,9 @@ void HazardHandler::init()
 		rocketDuration = 1;
 		rocketVelocity = 80.f;
 		rocketAngularVelocity = .25f;
+		// every so often, on the dot
+		nextLazerTime = (floor(gameTime / lazerFrequency) + 1) * lazerFrequency;
+		nextRocketTime = (floor(gameTime / rocketFrequency) + 1) * rocketFrequency;
 	}
 	else if (difficulty == NORMAL)
 	{
@@ -44,149 +35,193 @@ void HazardHandler::init()
 		lazerTimer = 5;
 		lazerDuration = 5;
 		lazerFrequency = 3;
-		lazerDistribution = new std::normal_distribution<GLfloat>(lazerFrequency, lazerFrequency/4.f);
-		nextLazerTime = glfwGetTime() + lazerFrequency;
+		nextLazerTime = gameTime + lazerFrequency;
 		// rocket stats
 		rocketFrequency = 15;
 		rocketTimer = 15;
 		rocketDuration = 1;
 		rocketVelocity = 100.f;
 		rocketAngularVelocity = .5f;
-		rocketDistribution = new std::normal_distribution<GLfloat>(rocketFrequency, rocketFrequency/4.f);
-		nextRocketTime = glfwGetTime() + rocketFrequency;
-		seed = std::chrono::system_clock::now().time_since_epoch().count();
-		std::default_random_engine generator(seed);
+		nextRocketTime = gameTime + rocketFrequency;
 	}
 	else
 		cout << "difficulty not handled" << endl;
+	reschedule();
 }
 
-void HazardHandler::update(GLfloat deltaTime, vector<Unit*>& argUnits)
+void HazardHandler::reschedule()
 {
-	// adding new hazards
-	generate(deltaTime, argUnits);
-	// updating lazers
-	for (unsigned int i = 0; i < lazers.size(); i++)
+	timers.clear(gameTime);
+	if (lazerFrequency > 0)
+		timers.schedule(nextLazerTime, HAZARD_SPAWN_LAZER, 0);
+	if (rocketFrequency > 0)
+		timers.schedule(nextRocketTime, HAZARD_SPAWN_ROCKET, 0);
+	for (GLuint i = 0; i < lazers.size(); i++)
 	{
-		lazers[i]->update(deltaTime, argUnits);
-		// if the lazer has expired, remove it from the array of lazers
-		if (lazers[i]->duration <= 0)
-		{
-			delete lazers[i];
-			lazers.erase(lazers.begin() + i);
-			i--; // push the counter back because the lazer was removed from the array
-		}
+		Timer& timer = lazers.column<Timer>()[i];
+		timer.event = timers.schedule(timer.due,
+			lazers.column<Blast>()[i].detonated ? HAZARD_EXPIRE_LAZER : HAZARD_DETONATE_LAZER, lazers.entity(i));
 	}
-	// updating rockets
-	for (unsigned int i = 0; i < rockets.size(); i++)
+	for (GLuint i = 0; i < rockets.size(); i++)
 	{
-		updateRocketTargets(argUnits);
-		rockets[i]->update(deltaTime, argUnits);
-		// if the rocket has expired, remove it from the array of rockets
-		if (rockets[i]->duration <= 0)
-		{
-			delete rockets[i];
-			rockets.erase(rockets.begin() + i);
-			i--; // push the counter back because the rocket was removed from the array
-		}
+		Timer& timer = rockets.column<Timer>()[i];
+		timer.event = timers.schedule(timer.due,
+			rockets.column<Blast>()[i].detonated ? HAZARD_EXPIRE_ROCKET : HAZARD_DETONATE_ROCKET, rockets.entity(i));
 	}
 }
 
-void HazardHandler::updateRocketTargets(vector<Unit*>& argUnits)
+void HazardHandler::update(GLfloat deltaTime, vector<Unit*>& argUnits)
 {
-	// for each rocket, we won't choose to update the destination until we make sure
-	// that the rocket's target is still in the array
-	for (unsigned int i = 0; i < rockets.size(); i++)
+	GLuint unitCount = argUnits.size();
+	// spawning, going off and going away, as it comes due
+	gameTime += deltaTime;
+	fired.clear();
+	timers.advance(gameTime, fired);
+	for (GLuint i = 0; i < fired.size(); i++)
+		fire(fired[i], argUnits);
+	// rockets home in, and go off once they get there
+	followTargets(rockets.column<Mover>(), rockets.size());
+	kernels.homeRockets(rockets.column<Transform>(), rockets.column<Mover>(), rockets.column<Blast>(), rockets.size(), deltaTime);
+	arrived.clear();
+	rocketsArrived(rockets.column<Transform>(), rockets.column<Mover>(), rockets.column<Blast>(), rockets.size(), slots);
+	for (GLuint i = 0; i < slots.size(); i++)
+		arrived.push_back(rockets.entity(slots[i]));
+	for (GLuint i = 0; i < arrived.size(); i++)
+		detonateRocket(arrived[i]);
+	// everything that's gone off kills whatever's in its hitbox, for as long as it lingers
+	unitHits.assign(argUnits.size(), false);
+	kernels.gatherUnits(argUnits);
+	kernels.lazerHits(lazers.column<Transform>(), lazers.column<Blast>(), lazers.size(), unitHits);
+	kernels.rocketHits(rockets.column<Transform>(), rockets.column<Blast>(), rockets.size(), unitHits);
+	killUnits(argUnits);
+	Telemetry::current.kills += unitCount - argUnits.size();
+	Telemetry::current.lazers = lazers.size();
+	Telemetry::current.rockets = rockets.size();
+}
+
+void HazardHandler::fire(const TimerEvent& argEvent, vector<Unit*>& argUnits)
+{
+	switch (argEvent.kind)
 	{
-		GLboolean targetExists = false;
-		for (unsigned int j = 0; j < argUnits.size(); j++)
+	case HAZARD_SPAWN_LAZER:
+		if (difficulty == SIMPLE)
 		{
-			if (rockets[i]->targetUnit == argUnits[j])
-				targetExists = true;
+			addLazer(glm::vec2(randomFloat(0, width), randomFloat(0, height)), random->below(2) * M_PI / 2);
+			nextLazerTime += lazerFrequency;
 		}
-		if (targetExists)
+		else
 		{
-			rockets[i]->resetDestination();
+			addLazer(glm::vec2(randomFloat(0, width), randomFloat(0, height)), (randomFloat(0, M_PI / 2)));
+			nextLazerTime += random->normal(lazerFrequency, lazerFrequency / 4.f);
 		}
+		timers.schedule(nextLazerTime, HAZARD_SPAWN_LAZER, 0);
+		break;
+	case HAZARD_SPAWN_ROCKET:
+		addRocket(glm::vec2(-50 + random->below(2)*(width + 50), height / 2), argUnits);
+		if (difficulty == SIMPLE)
+			nextRocketTime += rocketFrequency;
+		else
+			nextRocketTime += random->normal(rocketFrequency, rocketFrequency / 4.f);
+		timers.schedule(nextRocketTime, HAZARD_SPAWN_ROCKET, 0);
+		break;
+	case HAZARD_DETONATE_LAZER:
+		detonateLazer(argEvent.target);
+		break;
+	case HAZARD_DETONATE_ROCKET:
+		detonateRocket(argEvent.target);
+		break;
+	case HAZARD_EXPIRE_LAZER:
+		lazers.destroy(argEvent.target);
+		break;
+	case HAZARD_EXPIRE_ROCKET:
+		rockets.destroy(argEvent.target);
+		break;
 	}
 }
 
-// generation of hazards
-void HazardHandler::generate(GLfloat deltaTime, vector<Unit*>& argUnits)
+void HazardHandler::detonateLazer(Entity argLazer)
 {
-	if (difficulty == SIMPLE)
-		simpleGenerate(deltaTime, argUnits);
-	else if (difficulty = NORMAL)
-		normalGenerate(deltaTime, argUnits);
-	gameTime += deltaTime;
+	Timer& timer = lazers.get<Timer>(argLazer);
+	lazers.get<Blast>(argLazer).detonated = true;
+	timers.cancel(timer.event);
+	timer.due = gameTime + timer.linger;
+	timer.event = timers.schedule(timer.due, HAZARD_EXPIRE_LAZER, argLazer);
 }
 
-void HazardHandler::simpleGenerate(GLfloat deltaTime, vector<Unit*>& argUnits)
+void HazardHandler::detonateRocket(Entity argRocket)
 {
-	// drop lazers and rockets every "frequency" seconds
-	if (differentTimeInterval(gameTime, gameTime + deltaTime, lazerFrequency)) 
-	{
-		addLazer(glm::vec2(randomFloat(0, width), randomFloat(0, height)), (rand() % 2) * M_PI / 2);
-	}
-	if (differentTimeInterval(gameTime, gameTime + deltaTime, rocketFrequency))
-	{
-		addRocket(glm::vec2(-50 + (rand() % 2)*(width + 50), height / 2), argUnits);
-	}
+	// its fuse may still be burning, if it got to its destination first
+	Timer& timer = rockets.get<Timer>(argRocket);
+	rockets.get<Blast>(argRocket).detonated = true;
+	timers.cancel(timer.event);
+	timer.due = gameTime + timer.linger;
+	timer.event = timers.schedule(timer.due, HAZARD_EXPIRE_ROCKET, argRocket);
 }
 
-void HazardHandler::normalGenerate(GLfloat deltaTime, vector<Unit*>& argUnits)
+void HazardHandler::killUnits(vector<Unit*>& argUnits)
 {
-	if (gameTime > nextLazerTime)
-	{
-		addLazer(glm::vec2(randomFloat(0, width), randomFloat(0, height)), (randomFloat(0, M_PI / 2)));
-		nextLazerTime += (*lazerDistribution)(generator);
-	}
-	if (gameTime > nextRocketTime)
+	GLuint kept = 0;
+	Mover* movers = rockets.column<Mover>();
+	for (GLuint i = 0; i < argUnits.size(); i++)
 	{
-		addRocket(glm::vec2(-50 + (rand() % 2)*(width + 50), height / 2), argUnits);
-		nextRocketTime += (*rocketDistribution)(generator);
+		if (!unitHits[i])
+		{
+			argUnits[kept++] = argUnits[i];
+			continue;
+		}
+		// rockets after it go for where it died
+		for (GLuint j = 0; j < rockets.size(); j++)
+			if (movers[j].target == argUnits[i])
+				movers[j].target = NULL;
+		delete argUnits[i];
 	}
+	argUnits.resize(kept);
 }
 
-void HazardHandler::addLazer(glm::vec2 argPosition, GLfloat argAngle)
+Entity HazardHandler::addLazer(glm::vec2 argPosition, GLfloat argAngle)
 {
 	// x size of 2000 so that it can stretch across screen, corner to corner, worst case
-	lazers.push_back(new Lazer(argPosition, glm::vec2(2000, 10),lazerSprite, lazerSPriteDetonated, glm::vec4(1.0f), argAngle,
-		GL_TRUE, width, height, lazerTimer, lazerDuration, glm::vec2(50.f, 10.f)));
+	Transform transform = { argPosition, glm::vec2(2000, 10), argAngle };
+	Sprite sprite = { lazerSprite, glm::vec4(1.0f) };
+	Animation animation = { glm::vec2(LAZER_FRAMES, 1), 0, SpriteAnimation(gameTime, LAZER_FRAMES, LAZER_FRAME_DURATION, ANIMATION_LOOP) };
+	Timer timer = { gameTime + lazerTimer, lazerDuration, TIMER_NONE };
+	Blast blast = { lazerSPriteDetonated, GL_FALSE };
+	Beam beam = { glm::vec2(50.f, 10.f) };
+	Entity lazer = lazers.create(transform, sprite, animation, timer, blast, beam);
+	lazers.get<Timer>(lazer).event = timers.schedule(timer.due, HAZARD_DETONATE_LAZER, lazer);
+	return lazer;
 }
 
-void HazardHandler::addRocket(glm::vec2 argPosition, vector<Unit*>& argUnits)
+Entity HazardHandler::addRocket(glm::vec2 argPosition, vector<Unit*>& argUnits)
 {
 	// I'm gonna give the dude an angle that always points to the center of the map initially
-	GLfloat tempAngle = -atan2(height / 2 - argPosition.y, width / 2 - argPosition.x);
-	rockets.push_back(new Rocket(argPosition, glm::vec2(100, 100), rocketSprite, rocketSpriteDetonated, rocketSpriteTarget,
-		glm::vec4(1.0f), tempAngle, true, width, height, 
-		rocketTimer, rocketDuration, glm::vec2(width / 2, height / 2), rocketVelocity, rocketAngularVelocity));
+	GLfloat tempAngle = -simAtan2(height / 2 - argPosition.y, width / 2 - argPosition.x);
+	Transform transform = { argPosition, glm::vec2(100, 100), tempAngle };
+	Sprite sprite = { rocketSprite, glm::vec4(1.0f) };
+	Timer timer = { gameTime + rocketTimer, rocketDuration, TIMER_NONE };
+	Blast blast = { rocketSpriteDetonated, GL_FALSE };
+	Mover mover = { glm::vec2(width / 2, height / 2), rocketVelocity, rocketAngularVelocity, NULL, rocketSpriteTarget };
 	// immediately give the rocket a target, a random sheep
 	if (!argUnits.empty())
-		rockets[rockets.size() - 1]->setTarget(argUnits[rand() % argUnits.size()]);
+		mover.target = argUnits[random->below(argUnits.size())];
+	Entity rocket = rockets.create(transform, sprite, timer, blast, mover);
+	rockets.get<Timer>(rocket).event = timers.schedule(timer.due, HAZARD_DETONATE_ROCKET, rocket);
+	return rocket;
 }
 
 GLfloat HazardHandler::randomFloat(GLfloat min, GLfloat max)
 {
-	// https://stackoverflow.com/a/686373
-	return min + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / (max-min)));
+	return random->uniform(min, max);
 }
 
 void HazardHandler::drawLazers(SpriteRenderer& renderer)
 {
-	for (unsigned int i = 0; i < lazers.size(); i++)
-	{
-		if (lazers[i]->bDraw)
-			lazers[i]->draw(renderer);
-	}
+	::drawLazers(renderer, lazers.column<Transform>(), lazers.column<Sprite>(), lazers.column<Animation>(),
+		lazers.column<Blast>(), lazers.column<Beam>(), lazers.size(), width, height);
 }
 
 void HazardHandler::drawRockets(SpriteRenderer& renderer)
 {
-	for (unsigned int i = 0; i < rockets.size(); i++)
-	{
-		if (rockets[i]->bDraw)
-			rockets[i]->draw(renderer);
-	}
+	::drawRockets(renderer, rockets.column<Transform>(), rockets.column<Sprite>(), rockets.column<Blast>(),
+		rockets.column<Mover>(), rockets.size());
 }
\ No newline at end of file
@@ -6,10 +6,16 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
-#include "Texture2D.h"
-#include "Hazard.h"
-#include "Rocket.h"
-#include "Lazer.h"
+#include "TextureHandle.h"
+#include "Archetype.h"
+#include "Components.h"
+#include "Systems.h"
+#include "HazardKernels.h"
+#include "Unit.h"
+#include "CollisionUtil.h"
+#include "Random.h"
+#include "TimerWheel.h"
+#include "Telemetry.h"
 
 #ifndef _USE_MATH_DEFINES
 #define _USE_MATH_DEFINES
@@ -17,10 +23,24 @@
 #include <math.h>
 #include <vector>
 #include <algorithm>
-#include <stdlib.h> // srand, rand
-#include <time.h> // time
-#include <random>
-#include <chrono>
+
+// crackling animation, in LazerAnimated.png and LazerExplodedAnimated.png
+const GLint LAZER_FRAMES = 4;
+const GLfloat LAZER_FRAME_DURATION = .05f;
+
+typedef Archetype<MEMORY_HAZARDS, Transform, Sprite, Animation, Timer, Blast, Beam> LazerArchetype;
+typedef Archetype<MEMORY_HAZARDS, Transform, Sprite, Timer, Blast, Mover> RocketArchetype;
+
+// what the hazard timers fire
+enum HazardEvent
+{
+	HAZARD_SPAWN_LAZER,
+	HAZARD_SPAWN_ROCKET,
+	HAZARD_DETONATE_LAZER,	// target is the lazer
+	HAZARD_DETONATE_ROCKET, // target is the rocket
+	HAZARD_EXPIRE_LAZER,
+	HAZARD_EXPIRE_ROCKET
+};
 
 enum Difficulty
 {
@@ -32,52 +52,60 @@ enum Difficulty
 class HazardHandler
 {
 public:
-	vector<Lazer*> lazers;
-	vector<Rocket*> rockets;
+	LazerArchetype lazers;
+	RocketArchetype rockets;
 	GLfloat width, height;
 	GLfloat gameTime = 0;
 	Difficulty difficulty;
-	// randomness
-	std::normal_distribution<GLfloat>* lazerDistribution;
-	std::normal_distribution<GLfloat>* rocketDistribution;
-	unsigned seed;
-	std::default_random_engine generator;
-	
+	// randomness - the game's, so a saved game picks up where it left off
+	Random* random;
+	// spawns, detonations and expiries, keyed on gameTime
+	TimerWheel timers;
+
 
 	// lazer stuff
 	GLfloat lazerTimer, lazerDuration;
 	GLfloat nextLazerTime;
-	Texture2D lazerSprite;
-	Texture2D lazerSPriteDetonated;
+	TextureHandle lazerSprite;
+	TextureHandle lazerSPriteDetonated;
 	GLfloat lazerFrequency = -1;
 	// rocket stuff
 	GLfloat rocketTimer, rocketDuration, rocketVelocity, rocketAngularVelocity;
 	GLfloat nextRocketTime;
-	Texture2D rocketSprite;
-	Texture2D rocketSpriteDetonated;
-	Texture2D rocketSpriteTarget;
+	TextureHandle rocketSprite;
+	TextureHandle rocketSpriteDetonated;
+	TextureHandle rocketSpriteTarget;
 	GLfloat rocketFrequency = -1;
 
 	
 	// constructors and initialization
-	HazardHandler(Difficulty argDifficulty, GLfloat argWidth, GLfloat argHeight,
-		Texture2D argLazerSprite, Texture2D argLazerSpriteDetonated, 
-		Texture2D argRocketSprite, Texture2D argRocketSpriteDetonated, Texture2D argRocketSpriteTarget);
-	~HazardHandler();
+	HazardHandler(Difficulty argDifficulty, GLfloat argWidth, GLfloat argHeight, Random* argRandom,
+		TextureHandle argLazerSprite, TextureHandle argLazerSpriteDetonated, 
+		TextureHandle argRocketSprite, TextureHandle argRocketSpriteDetonated, TextureHandle argRocketSpriteTarget);
 	void init();
+	// sets the timers up again from gameTime, the next spawn times and each hazard's Timer - after
+	// those were set by hand, like when loading a game
+	void reschedule();
 	// generating hazards
-	void generate(GLfloat deltaTime, vector<Unit*>& argUnits);
-	void simpleGenerate(GLfloat deltaTime, vector<Unit*>& argUnits);
-	void normalGenerate(GLfloat deltaTime, vector<Unit*>& argUnits);
-	void addLazer(glm::vec2 argPosition, GLfloat argAngle);
-	void addRocket(glm::vec2 argPosition, vector<Unit*>& argUnits);
+	Entity addLazer(glm::vec2 argPosition, GLfloat argAngle);
+	Entity addRocket(glm::vec2 argPosition, vector<Unit*>& argUnits);
 	GLfloat randomFloat(GLfloat min, GLfloat max);
 	// updating game logic
 	void update(GLfloat deltaTime, vector<Unit*>& argUnits);
-	void updateRocketTargets(vector<Unit*>& argUnits);
+	void fire(const TimerEvent& argEvent, vector<Unit*>& argUnits);
+	void detonateLazer(Entity argLazer);
+	void detonateRocket(Entity argRocket);
+	void killUnits(vector<Unit*>& argUnits); // the ones flagged in unitHits
 	// rendering - I'll separate rendering of hazards because I want some below and some above the units
 	void drawLazers(SpriteRenderer& renderer);
 	void drawRockets(SpriteRenderer& renderer);
+private:
+	HazardKernels kernels;
+	// scratch
+	vector<GLboolean> unitHits; // a flag per unit
+	vector<TimerEvent> fired;
+	vector<GLuint> slots;
+	vector<Entity> arrived;
 
 };
 
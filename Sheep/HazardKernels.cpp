@@ -0,0 +1,97 @@
+#include "StrictFloat.h"
+#include "HazardKernels.h"
+#include "CollisionUtil.h"
+#include "Kernels.h"
+
+void HazardKernels::homeRockets(Transform* transforms, const Mover* movers, const Blast* blasts, GLuint count, GLfloat deltaTime)
+{
+	positionX.resize(count); positionY.resize(count); heading.resize(count);
+	goalX.resize(count); goalY.resize(count); goalAngle.resize(count);
+	velocity.resize(count); angularVelocity.resize(count); live.resize(count);
+	step.resize(count); cosine.resize(count); sine.resize(count);
+
+	// gather - headings are brought into -pi..pi, so the difference to the goal is within a turn
+	// either way, and one select wraps it. Rockets that have detonated don't move
+	for (GLuint i = 0; i < count; i++)
+	{
+		positionX[i] = toScalar(transforms[i].position.x);
+		positionY[i] = toScalar(transforms[i].position.y);
+		heading[i] = boundNegPiToPi(toScalar(transforms[i].rotation));
+		goalX[i] = toScalar(movers[i].destination.x);
+		goalY[i] = toScalar(movers[i].destination.y);
+		velocity[i] = toScalar(movers[i].velocity);
+		angularVelocity[i] = toScalar(movers[i].angularVelocity);
+		live[i] = blasts[i].detonated ? Scalar(0) : Scalar(1);
+	}
+	for (GLuint i = 0; i < count; i++)
+		goalAngle[i] = -simAtan2(goalY[i] - positionY[i], goalX[i] - positionX[i]);
+
+	// turning toward the goal, faster the further off it is, and slowing down while turning
+	Kernels::active.turnRockets(heading.data(), step.data(), goalAngle.data(), angularVelocity.data(), velocity.data(),
+		live.data(), count, toScalar(deltaTime));
+	for (GLuint i = 0; i < count; i++)
+		simSinCos(heading[i], sine[i], cosine[i]);
+	for (GLuint i = 0; i < count; i++)
+	{
+		positionX[i] = positionX[i] + cosine[i] * step[i];
+		positionY[i] = positionY[i] - sine[i] * step[i];
+	}
+
+	// scatter
+	for (GLuint i = 0; i < count; i++)
+	{
+		transforms[i].position.x = toFloat(positionX[i]);
+		transforms[i].position.y = toFloat(positionY[i]);
+		transforms[i].rotation = toFloat(heading[i]);
+	}
+}
+
+void HazardKernels::gatherUnits(const vector<Unit*>& units)
+{
+	GLuint count = static_cast<GLuint>(units.size());
+	unitX.resize(count); unitY.resize(count); unitRadius.resize(count);
+	hit.assign(count, 0);
+	for (GLuint i = 0; i < count; i++)
+	{
+		unitX[i] = toScalar(units[i]->position.x);
+		unitY[i] = toScalar(units[i]->position.y);
+		unitRadius[i] = toScalar(units[i]->radius());
+	}
+}
+
+void HazardKernels::lazerHits(const Transform* transforms, const Blast* blasts, GLuint count, vector<GLboolean>& unitHits)
+{
+	GLuint units = static_cast<GLuint>(unitX.size());
+	for (GLuint i = 0; i < count; i++)
+	{
+		if (!blasts[i].detonated)
+			continue;
+		Scalar heading = toScalar(transforms[i].rotation);
+		Scalar sine, cosine;
+		simSinCos(heading, sine, cosine);
+		Scalar originX = toScalar(transforms[i].position.x), originY = toScalar(transforms[i].position.y);
+		Kernels::active.beamHits(unitX.data(), unitY.data(), unitRadius.data(), hit.data(), units, originX, originY, sine, cosine);
+	}
+	flagHits(unitHits);
+}
+
+void HazardKernels::rocketHits(const Transform* transforms, const Blast* blasts, GLuint count, vector<GLboolean>& unitHits)
+{
+	GLuint units = static_cast<GLuint>(unitX.size());
+	for (GLuint i = 0; i < count; i++)
+	{
+		if (!blasts[i].detonated)
+			continue;
+		// the blast reaches as far as the rocket is wide
+		Scalar reach = toScalar(transforms[i].size.x);
+		Scalar originX = toScalar(transforms[i].position.x), originY = toScalar(transforms[i].position.y);
+		Kernels::active.blastHits(unitX.data(), unitY.data(), hit.data(), units, originX, originY, reach);
+	}
+	flagHits(unitHits);
+}
+
+void HazardKernels::flagHits(vector<GLboolean>& unitHits) const
+{
+	for (GLuint j = 0; j < hit.size(); j++)
+		unitHits[j] |= hit[j] != 0;
+}
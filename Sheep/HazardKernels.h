@@ -0,0 +1,40 @@
+#ifndef HAZARD_KERNELS_H
+#define HAZARD_KERNELS_H
+
+#include <GL/glew.h>
+#include <vector>
+
+#include "Components.h"
+#include "Fixed.h"
+#include "Unit.h"
+
+using namespace std;
+
+// The per tick hazard math - rocket homing and the hits of detonated hazards - as tight loops over
+// flat arrays, like Steering and CollisionSolver do for the herd. The archetype columns hold a
+// rocket's fields in a couple of structs, so they're gathered out into one array per field first,
+// and the homing itself runs down those with no branches, the turn toward the goal and the
+// clamps done as selects, so the compiler can do several rockets at once. atan2 and sin/cos get
+// passes of their own - FastMath's vectorise too, the fixed point tables don't. Hits
+// gather the herd once, and each detonated hazard then runs down all of it the same way. The
+// homing turn and the hit loops themselves are called through Kernels, for the CPU's widest SIMD
+class HazardKernels
+{
+public:
+	void homeRockets(Transform* transforms, const Mover* movers, const Blast* blasts, GLuint count, GLfloat deltaTime);
+	// the hits flag units in unitHits (one per unit) - units have to have been gathered first
+	void gatherUnits(const vector<Unit*>& units);
+	void lazerHits(const Transform* transforms, const Blast* blasts, GLuint count, vector<GLboolean>& unitHits);
+	void rocketHits(const Transform* transforms, const Blast* blasts, GLuint count, vector<GLboolean>& unitHits);
+private:
+	// one entry per rocket
+	vector<Scalar> positionX, positionY, heading, goalX, goalY, goalAngle;
+	vector<Scalar> velocity, angularVelocity, live, step, cosine, sine;
+	// one entry per unit
+	vector<Scalar> unitX, unitY, unitRadius;
+	vector<GLint> hit; // as wide as the positions, so the hit loops vectorise - copied out to unitHits
+
+	void flagHits(vector<GLboolean>& unitHits) const;
+};
+
+#endif
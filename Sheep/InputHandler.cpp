@@ -2,6 +2,7 @@
 
 // key
 GLboolean InputHandler::keys[1024];
+GLboolean InputHandler::keysPrev[1024];
 GLint InputHandler::scancode;
 GLint InputHandler::action;
 GLint InputHandler::mode;
@@ -15,6 +16,16 @@ GLint InputHandler::rightClickStatePrev;
 GLint InputHandler::mod;
 GLfloat InputHandler::mXpos;
 GLfloat InputHandler::mYpos;
+// pending input
+std::mutex InputHandler::pendingMutex;
+GLboolean InputHandler::pendingKeys[1024];
+GLboolean InputHandler::pendingPresses[1024];
+GLint InputHandler::pendingLeftClick = GLFW_RELEASE;
+GLint InputHandler::pendingMidClick = GLFW_RELEASE;
+GLint InputHandler::pendingRightClick = GLFW_RELEASE;
+GLint InputHandler::pendingMod;
+GLfloat InputHandler::pendingXpos;
+GLfloat InputHandler::pendingYpos;
 
 InputHandler::InputHandler()
 {
@@ -28,12 +39,34 @@ void InputHandler::init()
 
 void InputHandler::update(GLFWwindow* window)
 {
+	GLint left = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
+	GLint mid = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_MIDDLE);
+	GLint right = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT);
+	std::lock_guard<std::mutex> lock(pendingMutex);
+	pendingLeftClick = left;
+	pendingMidClick = mid;
+	pendingRightClick = right;
+}
+
+void InputHandler::sample()
+{
+	std::lock_guard<std::mutex> lock(pendingMutex);
+	for (GLuint i = 0; i < 1024; i++)
+	{
+		keysPrev[i] = keys[i];
+		// a tap that came and went between two samples still shows up, for one of them
+		keys[i] = pendingKeys[i] || pendingPresses[i];
+		pendingPresses[i] = GL_FALSE;
+	}
 	leftClickStatePrev = leftClickState;
-	leftClickState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT);
+	leftClickState = pendingLeftClick;
 	midClickStatePrev = midClickState;
-	midClickState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_MIDDLE);
+	midClickState = pendingMidClick;
 	rightClickStatePrev = rightClickState;
-	rightClickState = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT);
+	rightClickState = pendingRightClick;
+	mod = pendingMod;
+	mXpos = pendingXpos;
+	mYpos = pendingYpos;
 }
 
 void InputHandler::key_callback(GLFWwindow * window, int key, int scancode, int action, int mode)
@@ -43,21 +76,24 @@ void InputHandler::key_callback(GLFWwindow * window, int key, int scancode, int
 		glfwSetWindowShouldClose(window, GL_TRUE);
 	if (key >= 0 && key < 1024)
 	{
+		std::lock_guard<std::mutex> lock(pendingMutex);
 		if (action == GLFW_PRESS)
-			keys[key] = GL_TRUE;
+			pendingKeys[key] = pendingPresses[key] = GL_TRUE;
 		else if (action == GLFW_RELEASE)
-			keys[key] = GL_FALSE;
+			pendingKeys[key] = GL_FALSE;
 	}
 }
 
 void InputHandler::mouse_callback(GLFWwindow * window, double xpos, double ypos)
 {
-	mXpos = xpos;
-	mYpos = ypos;
+	std::lock_guard<std::mutex> lock(pendingMutex);
+	pendingXpos = xpos;
+	pendingYpos = ypos;
 }
 
 void InputHandler::mouse_button_callback(GLFWwindow * window, int button, int action, int mods)
 {
-	mod = mods;
+	std::lock_guard<std::mutex> lock(pendingMutex);
+	pendingMod = mods;
 }
 
@@ -2,16 +2,22 @@
 #define MOUSE_HANDLER_H
 
 #include <iostream>
+#include <mutex>
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
 using namespace std;
 
+// Input arrives on the main thread, through the GLFW callbacks and update(), but is read by
+// whichever thread runs the game logic. It's collected on the side and only copied over to the
+// public state in sample(), so the game sees input that holds still for a whole tick.
 class InputHandler
 {
 public:
+	/// input as of the last sample()
 	// key
 	static GLboolean keys[1024];
+	static GLboolean keysPrev[1024]; // as of the sample before
 	static GLint scancode;
 	static GLint action;
 	static GLint mode;
@@ -25,11 +31,21 @@ public:
 
 	InputHandler();
 	static void init();
+	// main thread - polls the mouse buttons
 	static void update(GLFWwindow* window);
+	// game logic thread - takes in everything that's come in since the last sample
+	static void sample();
 	static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode);
 	static void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 	static void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
-
+private:
+	// input as it comes in, waiting for the next sample()
+	static std::mutex pendingMutex;
+	static GLboolean pendingKeys[1024];
+	static GLboolean pendingPresses[1024]; // pressed since the last sample, even if released again
+	static GLint pendingLeftClick, pendingMidClick, pendingRightClick;
+	static GLint pendingMod;
+	static GLfloat pendingXpos, pendingYpos;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "StrictFloat.h"
+#include "Kernels.h"
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef SHEEP_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif //_USE_MATH_DEFINES
+#include <math.h>
+
+using namespace std;
+
+/// scalar - the reference Tools/KernelTest checks the others against, and the only one in fixed point
+void scalarTurnRockets(Scalar* heading, Scalar* step, const Scalar* goalAngle, const Scalar* angularVelocity,
+	const Scalar* velocity, const Scalar* live, GLuint count, Scalar deltaTime)
+{
+	Scalar pi = toScalar(static_cast<GLfloat>(M_PI)), twoPi = toScalar(static_cast<GLfloat>(2 * M_PI));
+	for (GLuint i = 0; i < count; i++)
+	{
+		Scalar angleDifference = heading[i] - goalAngle[i];
+		angleDifference = angleDifference + twoPi * ((angleDifference < -pi ? Scalar(1) : Scalar(0)) - (angleDifference > pi ? Scalar(1) : Scalar(0)));
+		Scalar angleChange = (angularVelocity[i] + simAbs(angleDifference) / Scalar(2)) * deltaTime * live[i];
+		// clockwise when behind the goal, counterclockwise when past it - the wrap and the turn are
+		// both done as a select times a step rather than a conditional add, which won't vectorise
+		Scalar turn = (angleDifference < Scalar(0) ? Scalar(1) : Scalar(0)) - (angleDifference > Scalar(0) ? Scalar(1) : Scalar(0));
+		heading[i] = heading[i] + turn * angleChange;
+		step[i] = velocity[i] * deltaTime / (Scalar(1) + simAbs(angleDifference)) * live[i];
+	}
+}
+
+void scalarBeamHits(const Scalar* unitX, const Scalar* unitY, const Scalar* unitRadius, GLint* hit, GLuint count,
+	Scalar originX, Scalar originY, Scalar sine, Scalar cosine)
+{
+	// distance from Q to PS
+	// = ||PS x PQ|| / ||PQ||, and PQ is a unit vector
+	for (GLuint j = 0; j < count; j++)
+		hit[j] |= unitRadius[j] >= simAbs((unitX[j] - originX) * sine - (unitY[j] - originY) * cosine);
+}
+
+void scalarBlastHits(const Scalar* unitX, const Scalar* unitY, GLint* hit, GLuint count,
+	Scalar originX, Scalar originY, Scalar reach)
+{
+	for (GLuint j = 0; j < count; j++)
+		hit[j] |= simLength(originX - unitX[j], originY - unitY[j]) < reach;
+}
+
+GLboolean scalarKernels(KernelTable& kernels)
+{
+	kernels.turnRockets = scalarTurnRockets;
+	kernels.beamHits = scalarBeamHits;
+	kernels.blastHits = scalarBlastHits;
+	return true;
+}
+
+/// registry
+KernelTable Kernels::active = { scalarTurnRockets, scalarBeamHits, scalarBlastHits };
+KernelIsa Kernels::isa = KERNEL_ISA_SCALAR;
+
+static const char* KERNEL_ISA_NAMES[KERNEL_ISA_COUNT] = { "scalar", "sse2", "avx2", "avx512" };
+
+const char* Kernels::name(KernelIsa argIsa)
+{
+	return KERNEL_ISA_NAMES[argIsa];
+}
+
+GLboolean Kernels::table(KernelIsa argIsa, KernelTable& kernels)
+{
+	switch (argIsa)
+	{
+	case KERNEL_ISA_SSE2:
+		return sse2Kernels(kernels);
+	case KERNEL_ISA_AVX2:
+		return avx2Kernels(kernels);
+	case KERNEL_ISA_AVX512:
+		return avx512Kernels(kernels);
+	default:
+		return scalarKernels(kernels);
+	}
+}
+
+#ifdef SHEEP_X86
+// registers a, b, c and d of a CPUID leaf
+static void cpuid(GLuint leaf, GLuint subleaf, GLuint registers[4])
+{
+#ifdef _MSC_VER
+	int values[4];
+	__cpuidex(values, leaf, subleaf);
+	for (GLuint i = 0; i < 4; i++)
+		registers[i] = static_cast<GLuint>(values[i]);
+#else
+	__cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+// which register sets the OS saves on a context switch - without that, using them isn't safe
+static uint64_t osRegisterState()
+{
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else
+	uint32_t low, high;
+	__asm__ __volatile__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+	return (static_cast<uint64_t>(high) << 32) | low;
+#endif
+}
+#endif
+
+GLboolean Kernels::supported(KernelIsa argIsa)
+{
+	KernelTable kernels;
+	if (!table(argIsa, kernels))
+		return false;
+	if (argIsa == KERNEL_ISA_SCALAR)
+		return true;
+#ifdef SHEEP_X86
+	GLuint leaf0[4], leaf1[4], leaf7[4] = { 0, 0, 0, 0 };
+	cpuid(0, 0, leaf0);
+	cpuid(1, 0, leaf1);
+	if (leaf0[0] >= 7)
+		cpuid(7, 0, leaf7);
+	GLboolean sse2 = (leaf1[3] >> 26) & 1;
+	// AVX state is SSE and AVX registers, AVX-512 adds the mask registers and the upper halves
+	GLboolean osSaves = (leaf1[2] >> 27) & 1;
+	uint64_t state = osSaves ? osRegisterState() : 0;
+	GLboolean avx2 = ((leaf1[2] >> 28) & 1) && ((leaf7[1] >> 5) & 1) && (state & 0x6) == 0x6;
+	GLboolean avx512 = avx2 && ((leaf7[1] >> 16) & 1) && (state & 0xE6) == 0xE6;
+	switch (argIsa)
+	{
+	case KERNEL_ISA_SSE2:
+		return sse2;
+	case KERNEL_ISA_AVX2:
+		return avx2;
+	case KERNEL_ISA_AVX512:
+		return avx512;
+	default:
+		return false;
+	}
+#else
+	return false;
+#endif
+}
+
+void Kernels::init()
+{
+	GLint forced = -1;
+	const char* requested = getenv("SHEEP_ISA");
+	if (requested && *requested)
+	{
+		for (GLint i = 0; i < KERNEL_ISA_COUNT; i++)
+			if (!strcmp(requested, KERNEL_ISA_NAMES[i]))
+				forced = i;
+		if (forced < 0)
+			std::cout << "ERROR::KERNELS: Unknown SHEEP_ISA " << requested << ", expected scalar, sse2, avx2 or avx512" << std::endl;
+		else if (!supported(static_cast<KernelIsa>(forced)))
+		{
+			std::cout << "ERROR::KERNELS: SHEEP_ISA " << requested << " isn't supported here" << std::endl;
+			forced = -1;
+		}
+	}
+	// the widest the CPU supports, from the forced one down
+	for (GLint i = forced >= 0 ? forced : KERNEL_ISA_COUNT - 1; i > KERNEL_ISA_SCALAR; i--)
+	{
+		KernelIsa candidate = static_cast<KernelIsa>(i);
+		if (!supported(candidate))
+			continue;
+		table(candidate, active);
+		isa = candidate;
+		return;
+	}
+	scalarKernels(active);
+	isa = KERNEL_ISA_SCALAR;
+}
@@ -0,0 +1,69 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <GL/glew.h>
+
+#include "Fixed.h"
+
+// x86 builds get the SIMD variants - everything else, and fixed point builds, only have scalar
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SHEEP_X86
+#endif
+
+// instruction sets the kernels come in, slowest first
+enum KernelIsa {
+	KERNEL_ISA_SCALAR,
+	KERNEL_ISA_SSE2,
+	KERNEL_ISA_AVX2,
+	KERNEL_ISA_AVX512,
+	KERNEL_ISA_COUNT
+};
+
+// The innermost loops of the hazard update, over the flat arrays HazardKernels gathers. Every
+// variant does the same float operations in the same order, without fused multiply-adds, so they
+// all come out bit for bit the same as the scalar ones
+struct KernelTable
+{
+	// the turn toward the goal and the step forward of each rocket, from heading and goalAngle
+	void(*turnRockets)(Scalar* heading, Scalar* step, const Scalar* goalAngle, const Scalar* angularVelocity,
+		const Scalar* velocity, const Scalar* live, GLuint count, Scalar deltaTime);
+	// flags the units within their radius of the line through origin, at the angle of sine and cosine
+	void(*beamHits)(const Scalar* unitX, const Scalar* unitY, const Scalar* unitRadius, GLint* hit, GLuint count,
+		Scalar originX, Scalar originY, Scalar sine, Scalar cosine);
+	// flags the units closer than reach to origin
+	void(*blastHits)(const Scalar* unitX, const Scalar* unitY, GLint* hit, GLuint count,
+		Scalar originX, Scalar originY, Scalar reach);
+};
+
+// Picks which variant of the kernels runs, once at startup. It's the widest the CPU and OS support,
+// as CPUID and XGETBV tell, unless the SHEEP_ISA environment variable asks for one of scalar, sse2,
+// avx2 or avx512 - for trying a slower machine's path on a faster one. Tools/KernelTest checks each
+// against the scalar kernels. Until init(), the scalar ones are used
+class Kernels
+{
+public:
+	static KernelTable active; // what everything calls through
+	static KernelIsa isa;
+
+	static void init();
+	static GLboolean supported(KernelIsa argIsa);
+	static const char* name(KernelIsa argIsa);
+private:
+	static GLboolean table(KernelIsa argIsa, KernelTable& kernels);
+};
+
+// the variants - scalar is in Kernels.cpp, and the rest are in KernelsX86.cpp. Each fills in
+// kernels, or returns false if it isn't built in
+GLboolean scalarKernels(KernelTable& kernels);
+// the scalar kernels themselves - the others finish off with these, past their last whole vector
+void scalarTurnRockets(Scalar* heading, Scalar* step, const Scalar* goalAngle, const Scalar* angularVelocity,
+	const Scalar* velocity, const Scalar* live, GLuint count, Scalar deltaTime);
+void scalarBeamHits(const Scalar* unitX, const Scalar* unitY, const Scalar* unitRadius, GLint* hit, GLuint count,
+	Scalar originX, Scalar originY, Scalar sine, Scalar cosine);
+void scalarBlastHits(const Scalar* unitX, const Scalar* unitY, GLint* hit, GLuint count,
+	Scalar originX, Scalar originY, Scalar reach);
+GLboolean sse2Kernels(KernelTable& kernels);
+GLboolean avx2Kernels(KernelTable& kernels);
+GLboolean avx512Kernels(KernelTable& kernels);
+
+#endif
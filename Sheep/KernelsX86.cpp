@@ -0,0 +1,245 @@
+#include "StrictFloat.h"
+#include "Kernels.h"
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif //_USE_MATH_DEFINES
+#include <math.h>
+
+// Each variant is compiled for its own instruction set, whatever the rest of the game is built
+// for - gcc and clang want that said per function, MSVC lets intrinsics through regardless. They
+// load and store unaligned, and leave whatever's past the last whole vector to the scalar kernels.
+// VS2015 doesn't know AVX-512 yet. Compilers would otherwise fuse the multiplies and adds below
+// into FMAs where the instruction set has them, which round differently than the scalar code -
+// StrictFloat.h turns that off, here and for the scalar kernels
+#if defined(SHEEP_X86) && !defined(SHEEP_FIXED_POINT)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#define SHEEP_TARGET(isa)
+#define SHEEP_AVX512 (_MSC_VER >= 1911)
+#else
+#define SHEEP_TARGET(isa) __attribute__((target(isa)))
+#define SHEEP_AVX512 1
+#endif
+
+/// SSE2 - 4 at a time
+SHEEP_TARGET("sse2")
+static void sse2TurnRockets(GLfloat* heading, GLfloat* step, const GLfloat* goalAngle, const GLfloat* angularVelocity,
+	const GLfloat* velocity, const GLfloat* live, GLuint count, GLfloat deltaTime)
+{
+	__m128 pi = _mm_set1_ps(static_cast<GLfloat>(M_PI)), negativePi = _mm_set1_ps(-static_cast<GLfloat>(M_PI));
+	__m128 twoPi = _mm_set1_ps(static_cast<GLfloat>(2 * M_PI));
+	__m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.f), two = _mm_set1_ps(2.f), sign = _mm_set1_ps(-0.f);
+	__m128 dt = _mm_set1_ps(deltaTime);
+	GLuint i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 h = _mm_loadu_ps(heading + i), alive = _mm_loadu_ps(live + i);
+		__m128 difference = _mm_sub_ps(h, _mm_loadu_ps(goalAngle + i));
+		__m128 wrap = _mm_sub_ps(_mm_and_ps(_mm_cmplt_ps(difference, negativePi), one), _mm_and_ps(_mm_cmpgt_ps(difference, pi), one));
+		difference = _mm_add_ps(difference, _mm_mul_ps(twoPi, wrap));
+		__m128 absolute = _mm_andnot_ps(sign, difference);
+		__m128 change = _mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_loadu_ps(angularVelocity + i), _mm_div_ps(absolute, two)), dt), alive);
+		__m128 turn = _mm_sub_ps(_mm_and_ps(_mm_cmplt_ps(difference, zero), one), _mm_and_ps(_mm_cmpgt_ps(difference, zero), one));
+		_mm_storeu_ps(heading + i, _mm_add_ps(h, _mm_mul_ps(turn, change)));
+		_mm_storeu_ps(step + i, _mm_mul_ps(_mm_div_ps(_mm_mul_ps(_mm_loadu_ps(velocity + i), dt), _mm_add_ps(one, absolute)), alive));
+	}
+	scalarTurnRockets(heading + i, step + i, goalAngle + i, angularVelocity + i, velocity + i, live + i, count - i, deltaTime);
+}
+
+SHEEP_TARGET("sse2")
+static void sse2BeamHits(const GLfloat* unitX, const GLfloat* unitY, const GLfloat* unitRadius, GLint* hit, GLuint count,
+	GLfloat originX, GLfloat originY, GLfloat sine, GLfloat cosine)
+{
+	__m128 x0 = _mm_set1_ps(originX), y0 = _mm_set1_ps(originY), s = _mm_set1_ps(sine), c = _mm_set1_ps(cosine);
+	__m128 sign = _mm_set1_ps(-0.f);
+	__m128i one = _mm_set1_epi32(1);
+	GLuint j = 0;
+	for (; j + 4 <= count; j += 4)
+	{
+		__m128 distance = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(unitX + j), x0), s), _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(unitY + j), y0), c));
+		__m128 inside = _mm_cmpge_ps(_mm_loadu_ps(unitRadius + j), _mm_andnot_ps(sign, distance));
+		__m128i flags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hit + j));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(hit + j), _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(inside), one)));
+	}
+	scalarBeamHits(unitX + j, unitY + j, unitRadius + j, hit + j, count - j, originX, originY, sine, cosine);
+}
+
+SHEEP_TARGET("sse2")
+static void sse2BlastHits(const GLfloat* unitX, const GLfloat* unitY, GLint* hit, GLuint count,
+	GLfloat originX, GLfloat originY, GLfloat reach)
+{
+	__m128 x0 = _mm_set1_ps(originX), y0 = _mm_set1_ps(originY), r = _mm_set1_ps(reach);
+	__m128i one = _mm_set1_epi32(1);
+	GLuint j = 0;
+	for (; j + 4 <= count; j += 4)
+	{
+		__m128 dx = _mm_sub_ps(x0, _mm_loadu_ps(unitX + j)), dy = _mm_sub_ps(y0, _mm_loadu_ps(unitY + j));
+		__m128 inside = _mm_cmplt_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy))), r);
+		__m128i flags = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hit + j));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(hit + j), _mm_or_si128(flags, _mm_and_si128(_mm_castps_si128(inside), one)));
+	}
+	scalarBlastHits(unitX + j, unitY + j, hit + j, count - j, originX, originY, reach);
+}
+
+GLboolean sse2Kernels(KernelTable& kernels)
+{
+	kernels.turnRockets = sse2TurnRockets;
+	kernels.beamHits = sse2BeamHits;
+	kernels.blastHits = sse2BlastHits;
+	return true;
+}
+
+/// AVX2 - 8 at a time
+SHEEP_TARGET("avx2")
+static void avx2TurnRockets(GLfloat* heading, GLfloat* step, const GLfloat* goalAngle, const GLfloat* angularVelocity,
+	const GLfloat* velocity, const GLfloat* live, GLuint count, GLfloat deltaTime)
+{
+	__m256 pi = _mm256_set1_ps(static_cast<GLfloat>(M_PI)), negativePi = _mm256_set1_ps(-static_cast<GLfloat>(M_PI));
+	__m256 twoPi = _mm256_set1_ps(static_cast<GLfloat>(2 * M_PI));
+	__m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.f), two = _mm256_set1_ps(2.f), sign = _mm256_set1_ps(-0.f);
+	__m256 dt = _mm256_set1_ps(deltaTime);
+	GLuint i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 h = _mm256_loadu_ps(heading + i), alive = _mm256_loadu_ps(live + i);
+		__m256 difference = _mm256_sub_ps(h, _mm256_loadu_ps(goalAngle + i));
+		__m256 wrap = _mm256_sub_ps(_mm256_and_ps(_mm256_cmp_ps(difference, negativePi, _CMP_LT_OQ), one),
+			_mm256_and_ps(_mm256_cmp_ps(difference, pi, _CMP_GT_OQ), one));
+		difference = _mm256_add_ps(difference, _mm256_mul_ps(twoPi, wrap));
+		__m256 absolute = _mm256_andnot_ps(sign, difference);
+		__m256 change = _mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(angularVelocity + i), _mm256_div_ps(absolute, two)), dt), alive);
+		__m256 turn = _mm256_sub_ps(_mm256_and_ps(_mm256_cmp_ps(difference, zero, _CMP_LT_OQ), one),
+			_mm256_and_ps(_mm256_cmp_ps(difference, zero, _CMP_GT_OQ), one));
+		_mm256_storeu_ps(heading + i, _mm256_add_ps(h, _mm256_mul_ps(turn, change)));
+		_mm256_storeu_ps(step + i, _mm256_mul_ps(_mm256_div_ps(_mm256_mul_ps(_mm256_loadu_ps(velocity + i), dt), _mm256_add_ps(one, absolute)), alive));
+	}
+	scalarTurnRockets(heading + i, step + i, goalAngle + i, angularVelocity + i, velocity + i, live + i, count - i, deltaTime);
+}
+
+SHEEP_TARGET("avx2")
+static void avx2BeamHits(const GLfloat* unitX, const GLfloat* unitY, const GLfloat* unitRadius, GLint* hit, GLuint count,
+	GLfloat originX, GLfloat originY, GLfloat sine, GLfloat cosine)
+{
+	__m256 x0 = _mm256_set1_ps(originX), y0 = _mm256_set1_ps(originY), s = _mm256_set1_ps(sine), c = _mm256_set1_ps(cosine);
+	__m256 sign = _mm256_set1_ps(-0.f);
+	__m256i one = _mm256_set1_epi32(1);
+	GLuint j = 0;
+	for (; j + 8 <= count; j += 8)
+	{
+		__m256 distance = _mm256_sub_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(unitX + j), x0), s),
+			_mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(unitY + j), y0), c));
+		__m256 inside = _mm256_cmp_ps(_mm256_loadu_ps(unitRadius + j), _mm256_andnot_ps(sign, distance), _CMP_GE_OQ);
+		__m256i flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hit + j));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(hit + j), _mm256_or_si256(flags, _mm256_and_si256(_mm256_castps_si256(inside), one)));
+	}
+	scalarBeamHits(unitX + j, unitY + j, unitRadius + j, hit + j, count - j, originX, originY, sine, cosine);
+}
+
+SHEEP_TARGET("avx2")
+static void avx2BlastHits(const GLfloat* unitX, const GLfloat* unitY, GLint* hit, GLuint count,
+	GLfloat originX, GLfloat originY, GLfloat reach)
+{
+	__m256 x0 = _mm256_set1_ps(originX), y0 = _mm256_set1_ps(originY), r = _mm256_set1_ps(reach);
+	__m256i one = _mm256_set1_epi32(1);
+	GLuint j = 0;
+	for (; j + 8 <= count; j += 8)
+	{
+		__m256 dx = _mm256_sub_ps(x0, _mm256_loadu_ps(unitX + j)), dy = _mm256_sub_ps(y0, _mm256_loadu_ps(unitY + j));
+		__m256 inside = _mm256_cmp_ps(_mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy))), r, _CMP_LT_OQ);
+		__m256i flags = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hit + j));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(hit + j), _mm256_or_si256(flags, _mm256_and_si256(_mm256_castps_si256(inside), one)));
+	}
+	scalarBlastHits(unitX + j, unitY + j, hit + j, count - j, originX, originY, reach);
+}
+
+GLboolean avx2Kernels(KernelTable& kernels)
+{
+	kernels.turnRockets = avx2TurnRockets;
+	kernels.beamHits = avx2BeamHits;
+	kernels.blastHits = avx2BlastHits;
+	return true;
+}
+
+/// AVX-512 - 16 at a time, with comparisons going into mask registers
+#if SHEEP_AVX512
+SHEEP_TARGET("avx512f")
+static void avx512TurnRockets(GLfloat* heading, GLfloat* step, const GLfloat* goalAngle, const GLfloat* angularVelocity,
+	const GLfloat* velocity, const GLfloat* live, GLuint count, GLfloat deltaTime)
+{
+	__m512 pi = _mm512_set1_ps(static_cast<GLfloat>(M_PI)), negativePi = _mm512_set1_ps(-static_cast<GLfloat>(M_PI));
+	__m512 twoPi = _mm512_set1_ps(static_cast<GLfloat>(2 * M_PI));
+	__m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.f), two = _mm512_set1_ps(2.f);
+	__m512 dt = _mm512_set1_ps(deltaTime);
+	GLuint i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 h = _mm512_loadu_ps(heading + i), alive = _mm512_loadu_ps(live + i);
+		__m512 difference = _mm512_sub_ps(h, _mm512_loadu_ps(goalAngle + i));
+		__m512 wrap = _mm512_sub_ps(_mm512_maskz_mov_ps(_mm512_cmp_ps_mask(difference, negativePi, _CMP_LT_OQ), one),
+			_mm512_maskz_mov_ps(_mm512_cmp_ps_mask(difference, pi, _CMP_GT_OQ), one));
+		difference = _mm512_add_ps(difference, _mm512_mul_ps(twoPi, wrap));
+		__m512 absolute = _mm512_abs_ps(difference);
+		__m512 change = _mm512_mul_ps(_mm512_mul_ps(_mm512_add_ps(_mm512_loadu_ps(angularVelocity + i), _mm512_div_ps(absolute, two)), dt), alive);
+		__m512 turn = _mm512_sub_ps(_mm512_maskz_mov_ps(_mm512_cmp_ps_mask(difference, zero, _CMP_LT_OQ), one),
+			_mm512_maskz_mov_ps(_mm512_cmp_ps_mask(difference, zero, _CMP_GT_OQ), one));
+		_mm512_storeu_ps(heading + i, _mm512_add_ps(h, _mm512_mul_ps(turn, change)));
+		_mm512_storeu_ps(step + i, _mm512_mul_ps(_mm512_div_ps(_mm512_mul_ps(_mm512_loadu_ps(velocity + i), dt), _mm512_add_ps(one, absolute)), alive));
+	}
+	scalarTurnRockets(heading + i, step + i, goalAngle + i, angularVelocity + i, velocity + i, live + i, count - i, deltaTime);
+}
+
+SHEEP_TARGET("avx512f")
+static void avx512BeamHits(const GLfloat* unitX, const GLfloat* unitY, const GLfloat* unitRadius, GLint* hit, GLuint count,
+	GLfloat originX, GLfloat originY, GLfloat sine, GLfloat cosine)
+{
+	__m512 x0 = _mm512_set1_ps(originX), y0 = _mm512_set1_ps(originY), s = _mm512_set1_ps(sine), c = _mm512_set1_ps(cosine);
+	__m512i one = _mm512_set1_epi32(1);
+	GLuint j = 0;
+	for (; j + 16 <= count; j += 16)
+	{
+		__m512 distance = _mm512_sub_ps(_mm512_mul_ps(_mm512_sub_ps(_mm512_loadu_ps(unitX + j), x0), s),
+			_mm512_mul_ps(_mm512_sub_ps(_mm512_loadu_ps(unitY + j), y0), c));
+		__mmask16 inside = _mm512_cmp_ps_mask(_mm512_loadu_ps(unitRadius + j), _mm512_abs_ps(distance), _CMP_GE_OQ);
+		__m512i flags = _mm512_loadu_si512(hit + j);
+		_mm512_storeu_si512(hit + j, _mm512_mask_or_epi32(flags, inside, flags, one));
+	}
+	scalarBeamHits(unitX + j, unitY + j, unitRadius + j, hit + j, count - j, originX, originY, sine, cosine);
+}
+
+SHEEP_TARGET("avx512f")
+static void avx512BlastHits(const GLfloat* unitX, const GLfloat* unitY, GLint* hit, GLuint count,
+	GLfloat originX, GLfloat originY, GLfloat reach)
+{
+	__m512 x0 = _mm512_set1_ps(originX), y0 = _mm512_set1_ps(originY), r = _mm512_set1_ps(reach);
+	__m512i one = _mm512_set1_epi32(1);
+	GLuint j = 0;
+	for (; j + 16 <= count; j += 16)
+	{
+		__m512 dx = _mm512_sub_ps(x0, _mm512_loadu_ps(unitX + j)), dy = _mm512_sub_ps(y0, _mm512_loadu_ps(unitY + j));
+		// the zero masked sqrt, with every lane on - GCC's plain one starts from an undefined vector,
+		// which -Wmaybe-uninitialized trips over at -O2
+		__m512 distance = _mm512_maskz_sqrt_ps(0xFFFF, _mm512_add_ps(_mm512_mul_ps(dx, dx), _mm512_mul_ps(dy, dy)));
+		__mmask16 inside = _mm512_cmp_ps_mask(distance, r, _CMP_LT_OQ);
+		__m512i flags = _mm512_loadu_si512(hit + j);
+		_mm512_storeu_si512(hit + j, _mm512_mask_or_epi32(flags, inside, flags, one));
+	}
+	scalarBlastHits(unitX + j, unitY + j, hit + j, count - j, originX, originY, reach);
+}
+
+GLboolean avx512Kernels(KernelTable& kernels)
+{
+	kernels.turnRockets = avx512TurnRockets;
+	kernels.beamHits = avx512BeamHits;
+	kernels.blastHits = avx512BlastHits;
+	return true;
+}
+#else
+GLboolean avx512Kernels(KernelTable&) { return false; }
+#endif
+
+#else
+GLboolean sse2Kernels(KernelTable&) { return false; }
+GLboolean avx2Kernels(KernelTable&) { return false; }
+GLboolean avx512Kernels(KernelTable&) { return false; }
+#endif
@@ -0,0 +1,127 @@
+#include "MappedFile.h"
+
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == NULL)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	fileHandle = file;
+	mappingHandle = mapping;
+	data = static_cast<const unsigned char*>(view);
+	size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0)
+	{
+		::close(file);
+		return false;
+	}
+	void* view = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	// the mapping keeps its own reference to the file, so the descriptor isn't needed anymore
+	::close(file);
+	if (view == MAP_FAILED)
+		return false;
+	data = static_cast<const unsigned char*>(view);
+	size = static_cast<size_t>(info.st_size);
+#endif
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (!data)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(mappingHandle);
+	CloseHandle(fileHandle);
+	mappingHandle = fileHandle = nullptr;
+#else
+	munmap(const_cast<unsigned char*>(data), size);
+#endif
+	data = nullptr;
+	size = 0;
+}
+
+bool fileStamp(const std::string& path, uint64_t& size, int64_t& modifiedTime)
+{
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0)
+		return false;
+	size = static_cast<uint64_t>(info.st_size);
+	modifiedTime = static_cast<int64_t>(info.st_mtime);
+	return true;
+}
+
+bool makeDirectory(const std::string& path)
+{
+#ifdef _WIN32
+	return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+	return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+
+uint64_t hashBytes(const void* data, size_t length, uint64_t seed)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	uint64_t hash = seed;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
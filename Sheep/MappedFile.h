@@ -0,0 +1,39 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <stdint.h>
+
+// Read-only view of a whole file mapped into memory. The view stays valid until
+// close() is called or the object is destroyed, so callers can hand the bytes
+// straight to GL without copying them into an intermediate buffer first.
+class MappedFile
+{
+public:
+	const unsigned char* data = nullptr;
+	size_t size = 0;
+
+	MappedFile();
+	~MappedFile();
+	// mapping
+	bool open(const std::string& path);
+	void close();
+	bool isOpen() const { return data != nullptr; }
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+#ifdef _WIN32
+	void* fileHandle = nullptr;
+	void* mappingHandle = nullptr;
+#endif
+};
+
+/// helper functions
+// size and last modification time of a file on disk, used to tell whether a baked asset is stale
+bool fileStamp(const std::string& path, uint64_t& size, int64_t& modifiedTime);
+// creates a directory, if it isn't there already - false if it still isn't
+bool makeDirectory(const std::string& path);
+// FNV-1a hash, used to key cached assets on the contents they were built from
+uint64_t hashBytes(const void* data, size_t length, uint64_t seed = 14695981039346656037ULL);
+
+#endif
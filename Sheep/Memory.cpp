@@ -0,0 +1,112 @@
+#include "Memory.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* const TAG_NAMES[MEMORY_TAG_COUNT] = {
+	"units", "hazards", "power ups", "flocks", "flow fields", "rewind", "glyphs"
+};
+static const char* const GL_KIND_NAMES[GL_OBJECT_KIND_COUNT] = {
+	"textures", "buffers", "vertex arrays", "programs", "framebuffers"
+};
+
+Memory::Usage Memory::usage[MEMORY_TAG_COUNT];
+std::mutex Memory::glMutex;
+std::map<std::pair<GLuint, GLuint>, size_t> Memory::glObjects;
+
+void Memory::allocated(MemoryTag tag, size_t bytes)
+{
+	Usage& tagUsage = usage[tag];
+	size_t now = tagUsage.bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+	tagUsage.allocations.fetch_add(1, std::memory_order_relaxed);
+	size_t peak = tagUsage.peak.load(std::memory_order_relaxed);
+	while (now > peak && !tagUsage.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+		;
+}
+
+void Memory::freed(MemoryTag tag, size_t bytes)
+{
+	usage[tag].bytes.fetch_sub(bytes, std::memory_order_relaxed);
+	usage[tag].allocations.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Memory::trackGL(GLObjectKind kind, GLuint id, size_t bytes)
+{
+	if (!id)
+		return;
+	std::lock_guard<std::mutex> lock(glMutex);
+	glObjects[std::make_pair(static_cast<GLuint>(kind), id)] = bytes;
+}
+
+void Memory::untrackGL(GLObjectKind kind, GLuint id)
+{
+	std::lock_guard<std::mutex> lock(glMutex);
+	glObjects.erase(std::make_pair(static_cast<GLuint>(kind), id));
+}
+
+void Memory::report(std::vector<std::string>& lines)
+{
+	size_t figures[MEMORY_REPORT_LINES][MEMORY_REPORT_FIGURES];
+	reportFigures(figures);
+	char line[128];
+	lines.clear();
+	for (GLuint i = 0; i < MEMORY_REPORT_LINES; i++)
+	{
+		formatLine(i, figures[i], line, sizeof(line));
+		lines.push_back(line);
+	}
+}
+
+void Memory::reportFigures(size_t (&figures)[MEMORY_REPORT_LINES][MEMORY_REPORT_FIGURES])
+{
+	for (GLuint tag = 0; tag < MEMORY_TAG_COUNT; tag++)
+	{
+		figures[tag][0] = usage[tag].bytes;
+		figures[tag][1] = usage[tag].allocations;
+		figures[tag][2] = usage[tag].peak;
+	}
+	size_t (*kinds)[MEMORY_REPORT_FIGURES] = figures + MEMORY_TAG_COUNT;
+	for (GLuint kind = 0; kind < GL_OBJECT_KIND_COUNT; kind++)
+		kinds[kind][0] = kinds[kind][1] = kinds[kind][2] = 0;
+	std::lock_guard<std::mutex> lock(glMutex);
+	for (std::map<std::pair<GLuint, GLuint>, size_t>::const_iterator object = glObjects.begin(); object != glObjects.end(); ++object)
+	{
+		kinds[object->first.first][0]++;
+		kinds[object->first.first][1] += object->second;
+	}
+}
+
+void Memory::formatLine(GLuint line, const size_t (&figures)[MEMORY_REPORT_FIGURES], char* text, size_t size)
+{
+	if (line < MEMORY_TAG_COUNT)
+		snprintf(text, size, "%-14s %8.1f kB in %6u blocks, peak %8.1f kB", TAG_NAMES[line],
+			figures[0] / 1024.0, static_cast<GLuint>(figures[1]), figures[2] / 1024.0);
+	else
+		snprintf(text, size, "GL %-14s %5u live, %8.1f kB", GL_KIND_NAMES[line - MEMORY_TAG_COUNT],
+			static_cast<GLuint>(figures[0]), figures[1] / 1024.0);
+}
+
+MemoryReport::MemoryReport()
+	: text(MEMORY_REPORT_LINES)
+{
+	// nothing's been formatted yet, and no figures come out like this
+	memset(figures, 0xFF, sizeof(figures));
+}
+
+GLboolean MemoryReport::update()
+{
+	size_t now[MEMORY_REPORT_LINES][MEMORY_REPORT_FIGURES];
+	Memory::reportFigures(now);
+	GLboolean changed = false;
+	char line[128];
+	for (GLuint i = 0; i < MEMORY_REPORT_LINES; i++)
+	{
+		if (!memcmp(now[i], figures[i], sizeof(figures[i])))
+			continue;
+		memcpy(figures[i], now[i], sizeof(figures[i]));
+		Memory::formatLine(i, figures[i], line, sizeof(line));
+		text[i].assign(line);
+		changed = true;
+	}
+	return changed;
+}
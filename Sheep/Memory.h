@@ -0,0 +1,128 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <GL/glew.h>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// What CPU memory is counted against
+enum MemoryTag {
+	MEMORY_UNITS,
+	MEMORY_HAZARDS,
+	MEMORY_POWER_UPS,
+	MEMORY_FLOCKS,
+	MEMORY_FLOW_FIELDS,
+	MEMORY_REWIND,
+	MEMORY_GLYPHS,
+	MEMORY_TAG_COUNT
+};
+
+// Kinds of GL objects, as registered
+enum GLObjectKind {
+	GL_OBJECT_TEXTURE,
+	GL_OBJECT_BUFFER,
+	GL_OBJECT_VERTEX_ARRAY,
+	GL_OBJECT_PROGRAM,
+	GL_OBJECT_FRAMEBUFFER,
+	GL_OBJECT_KIND_COUNT
+};
+
+// a line of the report per tag, then per kind of GL object, each from up to this many figures
+const GLuint MEMORY_REPORT_LINES = MEMORY_TAG_COUNT + GL_OBJECT_KIND_COUNT;
+const GLuint MEMORY_REPORT_FIGURES = 3;
+
+// Where the game's memory goes. CPU allocations are counted per tag by the classes and
+// containers below, as they happen, along with the high water mark - a tag that keeps climbing
+// over a long session is leaking. GL objects are registered when they're created and
+// unregistered when deleted, with an estimate of their size in bytes, as the driver won't say.
+// Everything can be called from any thread.
+class Memory
+{
+public:
+	// CPU
+	static void allocated(MemoryTag tag, size_t bytes);
+	static void freed(MemoryTag tag, size_t bytes);
+	static size_t bytes(MemoryTag tag) { return usage[tag].bytes; }
+	static size_t peak(MemoryTag tag) { return usage[tag].peak; }
+	// GL - registering an object again updates its size
+	static void trackGL(GLObjectKind kind, GLuint id, size_t bytes);
+	static void untrackGL(GLObjectKind kind, GLuint id);
+	// a line per tag and per kind of GL object, for printing or drawing
+	static void report(std::vector<std::string>& lines);
+private:
+	friend class MemoryReport;
+	struct Usage
+	{
+		std::atomic<size_t> bytes, peak, allocations;
+	};
+	static Usage usage[MEMORY_TAG_COUNT];
+	static std::mutex glMutex;
+	static std::map<std::pair<GLuint, GLuint>, size_t> glObjects; // <kind, id> to bytes
+
+	// what each line of the report is made from - bytes, blocks and peak for a tag, and objects
+	// and bytes for a kind of GL object
+	static void reportFigures(size_t (&figures)[MEMORY_REPORT_LINES][MEMORY_REPORT_FIGURES]);
+	static void formatLine(GLuint line, const size_t (&figures)[MEMORY_REPORT_FIGURES], char* text, size_t size);
+};
+
+// Memory's report, kept for drawing every frame. A line is only formatted again once the figures
+// behind it change, and into the string already there, so keeping it on screen doesn't allocate
+class MemoryReport
+{
+public:
+	MemoryReport();
+	// brings the lines up to date - true if any of them changed
+	GLboolean update();
+	const std::vector<std::string>& lines() const { return text; }
+private:
+	std::vector<std::string> text;
+	size_t figures[MEMORY_REPORT_LINES][MEMORY_REPORT_FIGURES]; // each line was formatted from
+};
+
+// Base class for objects whose memory counts against Tag when they're new'd
+template <MemoryTag Tag>
+class Tracked
+{
+public:
+	static void* operator new(size_t size)
+	{
+		Memory::allocated(Tag, size);
+		return ::operator new(size);
+	}
+	static void operator delete(void* pointer, size_t size)
+	{
+		Memory::freed(Tag, size);
+		::operator delete(pointer);
+	}
+};
+
+// Allocator for containers whose memory counts against Tag
+template <typename T, MemoryTag Tag>
+class TrackedAllocator
+{
+public:
+	typedef T value_type;
+	template <typename U> struct rebind { typedef TrackedAllocator<U, Tag> other; };
+
+	TrackedAllocator() {}
+	template <typename U> TrackedAllocator(const TrackedAllocator<U, Tag>&) {}
+	T* allocate(size_t count)
+	{
+		Memory::allocated(Tag, count * sizeof(T));
+		return static_cast<T*>(::operator new(count * sizeof(T)));
+	}
+	void deallocate(T* pointer, size_t count)
+	{
+		Memory::freed(Tag, count * sizeof(T));
+		::operator delete(pointer);
+	}
+	template <typename U> bool operator==(const TrackedAllocator<U, Tag>&) const { return true; }
+	template <typename U> bool operator!=(const TrackedAllocator<U, Tag>&) const { return false; }
+};
+
+#endif
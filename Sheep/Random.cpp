@@ -0,0 +1,53 @@
+#include "StrictFloat.h"
+#include "Random.h"
+
+#include <math.h>
+
+#include "FastMath.h"
+
+Random::Random(uint64_t argSeed)
+{
+	seed(argSeed);
+}
+
+void Random::seed(uint64_t argSeed)
+{
+	// scrambled with splitmix64, as similar seeds would start out with similar states, and a
+	// state of zero would never change
+	uint64_t z = argSeed + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	state = z ^ (z >> 31);
+	if (state == 0)
+		state = 1;
+}
+
+uint32_t Random::next()
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return static_cast<uint32_t>((state * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+GLuint Random::below(GLuint argBound)
+{
+	// scaling rather than taking the remainder, which would lean on the low bits
+	return static_cast<GLuint>((static_cast<uint64_t>(next()) * argBound) >> 32);
+}
+
+GLfloat Random::uniform(GLfloat argMin, GLfloat argMax)
+{
+	// 24 bits, as many as a float holds
+	return argMin + (next() >> 8) * (1.f / 16777216.f) * (argMax - argMin);
+}
+
+GLfloat Random::normal(GLfloat argMean, GLfloat argDeviation)
+{
+	// Box-Muller - the first number is kept off of zero for the log. The log and cosine are
+	// FastMath's rather than libm's, as hazard timing comes from here and has to come out the same
+	// on every machine, and sqrtf is exact everywhere
+	GLfloat u = ((next() >> 8) + 1) * (1.f / 16777216.f);
+	GLfloat v = (next() >> 8) * (1.f / 16777216.f);
+	return argMean + argDeviation * sqrtf(-2.f * fastLog(u)) * fastCos(6.2831853f * v);
+}
@@ -0,0 +1,25 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <GL/glew.h>
+#include <stdint.h>
+
+// Pseudo random numbers for the game (xorshift64*). Its whole state is the one integer, so a
+// game can be saved and forked along with the numbers it'll draw next, and the same seed always
+// gives the same game - rand() and the standard engines and distributions can't promise either.
+class Random
+{
+public:
+	uint64_t state;
+
+	// constructors
+	Random(uint64_t argSeed = 1);
+	void seed(uint64_t argSeed);
+	// drawing
+	uint32_t next();
+	GLuint below(GLuint argBound);					  // in [0, argBound)
+	GLfloat uniform(GLfloat argMin, GLfloat argMax); // in [argMin, argMax)
+	GLfloat normal(GLfloat argMean, GLfloat argDeviation);
+};
+
+#endif
@@ -0,0 +1,147 @@
+#include "RenderQueue.h"
+#include "ResourceManager.h"
+
+#include <algorithm>
+
+RenderQueue::RenderQueue(StreamBuffer* argStream)
+	: stream(argStream)
+{
+}
+
+void RenderQueue::submit(SpriteRenderer& renderer, TextureHandle texture, const SpriteInstance& instance)
+{
+	RenderItem item = { &renderer, ResourceManager::GetTexture(texture).ID, instance };
+	uint64_t key = (static_cast<uint64_t>(layer) << 56)
+		| (static_cast<uint64_t>(shaderIndex(renderer.shader.ID) & 0xFF) << 48)
+		| (static_cast<uint64_t>(texture.index & 0xFFFF) << 32)
+		| static_cast<uint64_t>(items.size());
+	items.push_back(item);
+	keys.push_back(key);
+	sorted = false;
+}
+
+void RenderQueue::sort()
+{
+	if (sorted || items.empty())
+		return;
+	radixSort();
+	sorted = true;
+}
+
+void RenderQueue::swap(RenderQueue& other)
+{
+	// the shader bits of the keys index into programs, so they have to go along
+	items.swap(other.items);
+	keys.swap(other.keys);
+	order.swap(other.order);
+	programs.swap(other.programs);
+	std::swap(sorted, other.sorted);
+}
+
+void RenderQueue::draw()
+{
+	if (items.empty())
+		return;
+	sort();
+
+	// upload in as few allocations as the stream buffer allows, then draw each run of
+	// sprites sharing a renderer and texture as one instanced draw
+	GLuint maxBatch = static_cast<GLuint>(stream->maxAllocation() / sizeof(SpriteInstance));
+	GLuint currentProgram = 0, currentTexture = 0, currentVAO = 0;
+	for (GLuint start = 0; start < items.size(); start += maxBatch)
+	{
+		GLuint count = std::min(maxBatch, static_cast<GLuint>(items.size()) - start);
+		GLintptr offset;
+		SpriteInstance* instances = static_cast<SpriteInstance*>(stream->map(count * sizeof(SpriteInstance), offset));
+		if (!instances)
+			break;
+		for (GLuint i = 0; i < count; i++)
+			instances[i] = items[order[start + i]].instance;
+		stream->unmap();
+
+		GLuint runStart = 0;
+		while (runStart < count)
+		{
+			const RenderItem& first = items[order[start + runStart]];
+			GLuint runEnd = runStart + 1;
+			while (runEnd < count && items[order[start + runEnd]].renderer == first.renderer
+				&& items[order[start + runEnd]].texture == first.texture)
+				runEnd++;
+
+			// only touch the state that actually changes between runs
+			if (first.renderer->shader.ID != currentProgram)
+			{
+				currentProgram = first.renderer->shader.ID;
+				glUseProgram(currentProgram);
+			}
+			if (first.texture != currentTexture)
+			{
+				currentTexture = first.texture;
+				glActiveTexture(GL_TEXTURE0);
+				glBindTexture(GL_TEXTURE_2D, currentTexture);
+			}
+			if (first.renderer->quadVAO != currentVAO)
+			{
+				currentVAO = first.renderer->quadVAO;
+				glBindVertexArray(currentVAO);
+			}
+			first.renderer->bindInstances(offset + runStart * sizeof(SpriteInstance));
+			glDrawArraysInstanced(GL_TRIANGLES, 0, 6, runEnd - runStart);
+			runStart = runEnd;
+		}
+	}
+	glBindVertexArray(0);
+}
+
+void RenderQueue::clear()
+{
+	items.clear();
+	keys.clear();
+	sorted = false;
+}
+
+GLuint RenderQueue::shaderIndex(GLuint program)
+{
+	for (GLuint i = 0; i < programs.size(); i++)
+		if (programs[i] == program)
+			return i;
+	programs.push_back(program);
+	return static_cast<GLuint>(programs.size() - 1);
+}
+
+void RenderQueue::radixSort()
+{
+	// least significant digit first, a byte at a time, carrying the item indices along
+	GLuint count = static_cast<GLuint>(keys.size());
+	order.resize(count);
+	orderScratch.resize(count);
+	keysScratch.resize(count);
+	for (GLuint i = 0; i < count; i++)
+		order[i] = i;
+
+	for (GLuint shift = 0; shift < 64; shift += 8)
+	{
+		GLuint histogram[256] = {};
+		for (GLuint i = 0; i < count; i++)
+			histogram[(keys[i] >> shift) & 0xFF]++;
+		// most bytes are the same for every item (there are only a few layers, shaders
+		// and textures), and those passes wouldn't change the order
+		if (histogram[(keys[0] >> shift) & 0xFF] == count)
+			continue;
+		GLuint position = 0;
+		for (GLuint digit = 0; digit < 256; digit++)
+		{
+			GLuint digitCount = histogram[digit];
+			histogram[digit] = position;
+			position += digitCount;
+		}
+		for (GLuint i = 0; i < count; i++)
+		{
+			GLuint destination = histogram[(keys[i] >> shift) & 0xFF]++;
+			keysScratch[destination] = keys[i];
+			orderScratch[destination] = order[i];
+		}
+		keys.swap(keysScratch);
+		order.swap(orderScratch);
+	}
+}
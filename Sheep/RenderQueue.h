@@ -0,0 +1,68 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <GL/glew.h>
+#include <stdint.h>
+#include <vector>
+
+#include "Texture2D.h"
+#include "TextureHandle.h"
+#include "SpriteRenderer.h"
+
+// Layers are drawn back to front; everything in one layer is drawn before anything in the next
+enum RenderLayer {
+	LAYER_BACKGROUND = 0,
+	LAYER_LAZERS,
+	LAYER_POWERUPS,
+	LAYER_UNITS,
+	LAYER_ROCKETS,
+	LAYER_SELECTION,
+	LAYER_MENU
+};
+
+// A sprite waiting to be drawn
+struct RenderItem
+{
+	SpriteRenderer* renderer;
+	GLuint texture;
+	SpriteInstance instance;
+};
+
+// Collects the sprites of a frame and draws them in sort key order rather than submission
+// order. The 64 bit key is, from the most significant bits down:
+//   layer (8) | shader (8) | texture (16) | depth (32)
+// so sprites that share a program and texture end up next to each other within their layer
+// and go out as one instanced draw, without the program, texture or VAO being rebound. The
+// texture bits are its handle's index, which ResourceManager hands out densely from 1, rather
+// than the GL name, which the driver can pick as it likes and wouldn't have to fit.
+// Depth is the submission order, so overlapping sprites of the same texture keep their order.
+class RenderQueue
+{
+public:
+	RenderLayer layer = LAYER_BACKGROUND; // layer that submitted sprites go to
+
+	RenderQueue(StreamBuffer* argStream);
+	// queueing - submit() and sort() don't touch GL, so a queue can be filled on any thread
+	void submit(SpriteRenderer& renderer, TextureHandle texture, const SpriteInstance& instance);
+	void sort();
+	// trades contents with other, so a filled queue can be handed over without copying it
+	void swap(RenderQueue& other);
+	// drawing - draw() leaves the queue as is, so the same sprites can be drawn again
+	void draw();
+	void clear();
+	// sorts and draws everything that was submitted, then empties the queue
+	void flush() { draw(); clear(); }
+	GLuint size() const { return static_cast<GLuint>(items.size()); }
+private:
+	StreamBuffer* stream;
+	std::vector<RenderItem> items;
+	std::vector<uint64_t> keys, keysScratch;
+	std::vector<uint32_t> order, orderScratch;
+	std::vector<GLuint> programs; // shader programs seen so far, indexed by their key bits
+	GLboolean sorted = false;	  // keys and order are in draw order
+
+	GLuint shaderIndex(GLuint program);
+	void radixSort();
+};
+
+#endif
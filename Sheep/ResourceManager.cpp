@@ -9,15 +9,116 @@
 #include "ResourceManager.h"
 
 #include <iostream>
-#include <sstream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
+#include <string.h>
 using namespace std;
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#include "MappedFile.h"
+#include "Memory.h"
+
+// Baked textures live in TEXTURE_CACHE_DIRECTORY, named after their source image's path:
+// "Textures/Rocket.png" bakes to "Cache/Textures_Rocket.png.tex". A blob is this header followed
+// by the texels of every mip level, tightly packed and ready to hand to glTexImage2D
+struct TextureCacheHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t width, height;
+	uint32_t internalFormat, imageFormat;
+	uint32_t mipLevels;
+	uint32_t reserved;
+	uint64_t sourceSize;		// the blob is stale once the source image's size or
+	int64_t sourceModifiedTime; // modification time no longer match these
+};
+static const char TEXTURE_CACHE_MAGIC[4] = { 'S', 'H', 'T', 'X' };
+static const uint32_t TEXTURE_CACHE_VERSION = 1;
+static const std::string TEXTURE_CACHE_DIRECTORY = "Cache";
+
+// Linked programs are cached next to their vertex shader as "<file>.program": this header
+// followed by the driver's program binary. Binaries only load on the driver that produced
+// them, so the cache is keyed on both the shader sources and the driver's identification
+struct ShaderCacheHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t format;
+	uint32_t length;
+	uint64_t sourceHash;
+	uint64_t driverHash;
+};
+static const char SHADER_CACHE_MAGIC[4] = { 'S', 'H', 'P', 'B' };
+static const uint32_t SHADER_CACHE_VERSION = 1;
+
+static uint64_t driverHash()
+{
+	uint64_t hash = hashBytes(nullptr, 0);
+	const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+	for (GLenum name : names)
+	{
+		const char* value = reinterpret_cast<const char*>(glGetString(name));
+		if (value)
+			hash = hashBytes(value, strlen(value), hash);
+	}
+	return hash;
+}
+
+static std::string textureCachePath(const GLchar *file)
+{
+	std::string name(file);
+	for (char& c : name)
+		if (c == '/' || c == '\\' || c == ':')
+			c = '_';
+	return TEXTURE_CACHE_DIRECTORY + "/" + name + ".tex";
+}
+
+// maps file's blob and reads its header, if the blob is there, was baked from the image as it
+// is now, in the format asked for, and holds every level it claims to and nothing more
+static bool openTextureCache(const GLchar *file, GLboolean alpha, MappedFile &blob, TextureCacheHeader &header)
+{
+	uint64_t sourceSize;
+	int64_t sourceModifiedTime;
+	if (!fileStamp(file, sourceSize, sourceModifiedTime))
+		return false;
+	if (!blob.open(textureCachePath(file)) || blob.size < sizeof(TextureCacheHeader))
+		return false;
+	memcpy(&header, blob.data, sizeof(header));
+	GLuint format = alpha ? GL_RGBA : GL_RGB;
+	if (memcmp(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic)) != 0
+		|| header.version != TEXTURE_CACHE_VERSION
+		|| header.sourceSize != sourceSize || header.sourceModifiedTime != sourceModifiedTime
+		|| header.internalFormat != format || header.imageFormat != format
+		|| header.width == 0 || header.height == 0 || header.mipLevels == 0)
+		return false;
+	// in 64 bits, and given up on as soon as it passes the end of the file, so a corrupt header
+	// can't wrap the size around to one that matches
+	uint64_t bytesPerPixel = alpha ? 4 : 3, expectedSize = sizeof(header);
+	for (uint32_t level = 0, w = header.width, h = header.height; level < header.mipLevels; level++)
+	{
+		expectedSize += uint64_t(w) * h * bytesPerPixel;
+		if (expectedSize > blob.size)
+			return false;
+		w = w > 1 ? w / 2 : 1;
+		h = h > 1 ? h / 2 : 1;
+	}
+	return expectedSize == blob.size;
+}
+
+static bool readSource(const GLchar *file, std::string &code)
+{
+	MappedFile source;
+	if (!source.open(file))
+		return false;
+	code.assign(reinterpret_cast<const char*>(source.data), source.size);
+	return true;
+}
 
 // Instantiate static variables
-std::map<std::string, Texture2D>    ResourceManager::Textures;
+std::map<std::string, TextureHandle> ResourceManager::Textures;
+std::vector<Texture2D>              ResourceManager::textureTable(1);
 std::map<std::string, Shader>       ResourceManager::Shaders;
 
 
@@ -33,25 +134,78 @@ Shader ResourceManager::GetShader(std::string name)
 }
 
 // second argument asks if the image file has pixels with non-max alpha components
-Texture2D ResourceManager::LoadTexture(const GLchar *file, GLboolean alpha, std::string name)
+TextureHandle ResourceManager::LoadTexture(const GLchar *file, GLboolean alpha, std::string name)
 {
-	Textures[name] = loadTextureFromFile(file, alpha);
-	return Textures[name];
+	Texture2D texture;
+	if (!loadTextureFromCache(file, alpha, texture))
+	{
+		glDeleteTextures(1, &texture.ID);
+		Memory::untrackGL(GL_OBJECT_TEXTURE, texture.ID);
+		texture = loadTextureFromFile(file, alpha);
+	}
+	TextureHandle& handle = Textures[name];
+	if (handle.valid())
+	{
+		// reloaded - the old texture goes, and whoever holds the handle draws the new one
+		glDeleteTextures(1, &textureTable[handle.index].ID);
+		Memory::untrackGL(GL_OBJECT_TEXTURE, textureTable[handle.index].ID);
+		textureTable[handle.index] = texture;
+	}
+	else
+	{
+		handle = TextureHandle(static_cast<GLuint>(textureTable.size()));
+		textureTable.push_back(texture);
+	}
+	return handle;
 }
 
-Texture2D ResourceManager::GetTexture(std::string name)
+GLboolean ResourceManager::BakeTexture(const GLchar *file, GLboolean alpha, GLboolean mipmaps)
 {
-	return Textures[name];
+	// already baked from the image as it is, with mips if they're wanted
+	MappedFile blob;
+	TextureCacheHeader header;
+	if (openTextureCache(file, alpha, blob, header) && (!mipmaps || header.mipLevels > 1))
+		return true;
+	blob.close();
+	int width, height, nrChannels;
+	unsigned char* image = stbi_load(file, &width, &height, &nrChannels, alpha ? 4 : 3);
+	if (!image)
+	{
+		std::cout << "ERROR::TEXTURE: Failed to decode " << file << std::endl;
+		return false;
+	}
+	GLboolean written = writeTextureCache(file, alpha, width, height, image, mipmaps);
+	stbi_image_free(image);
+	return written;
+}
+
+TextureHandle ResourceManager::GetTexture(std::string name)
+{
+	std::map<std::string, TextureHandle>::const_iterator found = Textures.find(name);
+	if (found == Textures.end())
+	{
+		std::cout << "ERROR::TEXTURE: No texture named " << name << std::endl;
+		return TextureHandle();
+	}
+	return found->second;
 }
 
 void ResourceManager::Clear()
 {
 	// (Properly) delete all shaders	
 	for (auto iter : Shaders)
+	{
 		glDeleteProgram(iter.second.ID);
+		Memory::untrackGL(GL_OBJECT_PROGRAM, iter.second.ID);
+	}
 	// (Properly) delete all textures
-	for (auto iter : Textures)
-		glDeleteTextures(1, &iter.second.ID);
+	for (GLuint i = 1; i < textureTable.size(); i++)
+	{
+		glDeleteTextures(1, &textureTable[i].ID);
+		Memory::untrackGL(GL_OBJECT_TEXTURE, textureTable[i].ID);
+	}
+	textureTable.resize(1);
+	Textures.clear();
 }
 
 Shader ResourceManager::loadShaderFromFile(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile)
@@ -60,44 +214,70 @@ Shader ResourceManager::loadShaderFromFile(const GLchar *vShaderFile, const GLch
 	std::string vertexCode;
 	std::string fragmentCode;
 	std::string geometryCode;
-	try
-	{
-		// Open files
-		std::ifstream vertexShaderFile(vShaderFile);
-		std::ifstream fragmentShaderFile(fShaderFile);
-		std::stringstream vShaderStream, fShaderStream;
-		// Read file's buffer contents into streams
-		vShaderStream << vertexShaderFile.rdbuf();
-		fShaderStream << fragmentShaderFile.rdbuf();
-		// close file handlers
-		vertexShaderFile.close();
-		fragmentShaderFile.close();
-		// Convert stream into string
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
-		// If geometry shader path is present, also load a geometry shader
-		if (gShaderFile != nullptr)
-		{
-			std::ifstream geometryShaderFile(gShaderFile);
-			std::stringstream gShaderStream;
-			gShaderStream << geometryShaderFile.rdbuf();
-			geometryShaderFile.close();
-			geometryCode = gShaderStream.str();
-		}
-	}
-	catch (std::exception e)
+	const GLchar *missing = !readSource(vShaderFile, vertexCode) ? vShaderFile
+		: !readSource(fShaderFile, fragmentCode) ? fShaderFile
+		: gShaderFile != nullptr && !readSource(gShaderFile, geometryCode) ? gShaderFile : nullptr;
+	if (missing)
 	{
-		std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
+		// compiling what did get read would only bury this under compile errors - the program stays 0
+		std::cout << "ERROR::SHADER: Failed to read " << missing << ", so it wasn't compiled" << std::endl;
+		return Shader();
 	}
+	// 2. Reuse the program binary from the last launch if these sources were already linked by this driver
+	uint64_t sourceHash = hashBytes(vertexCode.data(), vertexCode.size());
+	sourceHash = hashBytes(fragmentCode.data(), fragmentCode.size(), sourceHash);
+	sourceHash = hashBytes(geometryCode.data(), geometryCode.size(), sourceHash);
+	std::string cacheFile = std::string(vShaderFile) + ".program";
+	GLboolean useCache = Shader::BinariesSupported();
+	Shader shader;
+	if (useCache && loadShaderFromCache(cacheFile, sourceHash, shader))
+		return shader;
+	// 3. Otherwise create shader object from source code
 	const GLchar *vShaderCode = vertexCode.c_str();
 	const GLchar *fShaderCode = fragmentCode.c_str();
 	const GLchar *gShaderCode = geometryCode.c_str();
-	// 2. Now create shader object from source code
-	Shader shader;
 	shader.Compile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr); //@debug here
+	if (useCache)
+		writeShaderCache(cacheFile, sourceHash, shader);
 	return shader;
 }
 
+GLboolean ResourceManager::loadShaderFromCache(const std::string &cacheFile, uint64_t sourceHash, Shader &shader)
+{
+	MappedFile blob;
+	if (!blob.open(cacheFile) || blob.size < sizeof(ShaderCacheHeader))
+		return false;
+	ShaderCacheHeader header;
+	memcpy(&header, blob.data, sizeof(header));
+	if (memcmp(header.magic, SHADER_CACHE_MAGIC, sizeof(header.magic)) != 0
+		|| header.version != SHADER_CACHE_VERSION
+		|| header.sourceHash != sourceHash || header.driverHash != driverHash()
+		|| blob.size != sizeof(header) + header.length)
+		return false;
+	return shader.LoadBinary(header.format, blob.data + sizeof(header), header.length);
+}
+
+GLboolean ResourceManager::writeShaderCache(const std::string &cacheFile, uint64_t sourceHash, Shader &shader)
+{
+	GLenum format;
+	std::vector<unsigned char> binary;
+	if (!shader.GetBinary(format, binary))
+		return false;
+	ShaderCacheHeader header;
+	memcpy(header.magic, SHADER_CACHE_MAGIC, sizeof(header.magic));
+	header.version = SHADER_CACHE_VERSION;
+	header.format = format;
+	header.length = static_cast<uint32_t>(binary.size());
+	header.sourceHash = sourceHash;
+	header.driverHash = driverHash();
+	std::ofstream blob(cacheFile, std::ios::binary | std::ios::trunc);
+	if (!blob)
+		return false;
+	blob.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	blob.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+	return blob.good();
+}
+
 Texture2D ResourceManager::loadTextureFromFile(const GLchar *file, GLboolean alpha)
 {
 	// Create Texture object
@@ -107,12 +287,85 @@ Texture2D ResourceManager::loadTextureFromFile(const GLchar *file, GLboolean alp
 		texture.Internal_Format = GL_RGBA;
 		texture.Image_Format = GL_RGBA;
 	}
-	// Load image
+	// Load image - always expand to the channel count the texture format expects
 	int width, height, nrChannels;
-	unsigned char* image = stbi_load(file, &width, &height, &nrChannels, 0);
+	unsigned char* image = stbi_load(file, &width, &height, &nrChannels, texture.BytesPerPixel());
 	// Now generate texture
 	texture.Generate(width, height, image);
+	// Bake the decoded texels so the next launch can skip decoding this image - it's only decoded
+	// here when the blob is missing or stale
+	if (image)
+		writeTextureCache(file, alpha, width, height, image, false);
 	// And finally free image data
 	stbi_image_free(image);
 	return texture;
+}
+
+GLboolean ResourceManager::loadTextureFromCache(const GLchar *file, GLboolean alpha, Texture2D &texture)
+{
+	if (alpha)
+	{
+		texture.Internal_Format = GL_RGBA;
+		texture.Image_Format = GL_RGBA;
+	}
+	// make sure the blob holds every level it claims to before uploading straight out of it
+	MappedFile blob;
+	TextureCacheHeader header;
+	if (!openTextureCache(file, alpha, blob, header))
+		return false;
+	if (header.mipLevels > 1)
+		texture.Filter_Min = GL_LINEAR_MIPMAP_LINEAR;
+	texture.Generate(header.width, header.height, blob.data + sizeof(header), header.mipLevels);
+	return true;
+}
+
+GLboolean ResourceManager::writeTextureCache(const GLchar *file, GLboolean alpha, GLuint width, GLuint height,
+	const unsigned char *image, GLboolean mipmaps)
+{
+	TextureCacheHeader header;
+	memcpy(header.magic, TEXTURE_CACHE_MAGIC, sizeof(header.magic));
+	header.version = TEXTURE_CACHE_VERSION;
+	header.width = width;
+	header.height = height;
+	header.internalFormat = header.imageFormat = alpha ? GL_RGBA : GL_RGB;
+	header.mipLevels = 1;
+	header.reserved = 0;
+	if (!fileStamp(file, header.sourceSize, header.sourceModifiedTime))
+		return false;
+	GLuint channels = alpha ? 4 : 3;
+
+	// build the mip chain with a 2x2 box filter, each level from the one above it
+	std::vector<unsigned char> texels(image, image + static_cast<size_t>(width) * height * channels);
+	size_t previousLevel = 0;
+	GLuint w = width, h = height;
+	while (mipmaps && (w > 1 || h > 1))
+	{
+		GLuint nextW = w > 1 ? w / 2 : 1, nextH = h > 1 ? h / 2 : 1;
+		size_t nextLevel = texels.size();
+		texels.resize(nextLevel + static_cast<size_t>(nextW) * nextH * channels);
+		for (GLuint y = 0; y < nextH; y++)
+			for (GLuint x = 0; x < nextW; x++)
+				for (GLuint c = 0; c < channels; c++)
+				{
+					GLuint x0 = std::min(2 * x, w - 1), x1 = std::min(2 * x + 1, w - 1);
+					GLuint y0 = std::min(2 * y, h - 1), y1 = std::min(2 * y + 1, h - 1);
+					const unsigned char* level = &texels[previousLevel];
+					GLuint sum = level[(y0 * w + x0) * channels + c] + level[(y0 * w + x1) * channels + c]
+						+ level[(y1 * w + x0) * channels + c] + level[(y1 * w + x1) * channels + c];
+					texels[nextLevel + (y * nextW + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+				}
+		previousLevel = nextLevel;
+		w = nextW;
+		h = nextH;
+		header.mipLevels++;
+	}
+
+	if (!makeDirectory(TEXTURE_CACHE_DIRECTORY))
+		return false;
+	std::ofstream blob(textureCachePath(file), std::ios::binary | std::ios::trunc);
+	if (!blob)
+		return false;
+	blob.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	blob.write(reinterpret_cast<const char*>(texels.data()), texels.size());
+	return blob.good();
 }
\ No newline at end of file
@@ -11,10 +11,13 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <stdint.h>
 
 #include <GL/glew.h>
 
 #include "texture2D.h"
+#include "TextureHandle.h"
 #include "shader.h"
 
 
@@ -22,30 +25,46 @@
 // functions to load Textures and Shaders. Each loaded texture
 // and/or shader is also stored for future reference by string
 // handles. All functions and resources are static and no 
-// public constructor is defined.
+// public constructor is defined. It's the one owner of every
+// loaded texture - everything else holds a TextureHandle.
 class ResourceManager
 {
 public:
 	// Resource storage
 	static std::map<std::string, Shader>    Shaders;
-	static std::map<std::string, Texture2D> Textures;
+	static std::map<std::string, TextureHandle> Textures;
 	// Loads (and generates) a shader program from file loading vertex, fragment (and geometry) shader's source code. If gShaderFile is not nullptr, it also loads a geometry shader
 	static Shader   LoadShader(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile, std::string name);
 	// Retrieves a stored sader
 	static Shader   GetShader(std::string name);
-	// Loads (and generates) a texture from file
-	static Texture2D LoadTexture(const GLchar *file, GLboolean alpha, std::string name);
+	// Loads (and generates) a texture from file, preferring its baked cache blob over decoding the image. Loading a name again replaces its texture in place, so handles to it stay good
+	static TextureHandle LoadTexture(const GLchar *file, GLboolean alpha, std::string name);
+	// Bakes a texture's decoded texels (and optionally its mip chain) to a cache blob in the cache directory, unless it's baked already
+	static GLboolean BakeTexture(const GLchar *file, GLboolean alpha, GLboolean mipmaps = false);
 	// Retrieves a stored texture
-	static Texture2D GetTexture(std::string name);
+	static TextureHandle GetTexture(std::string name);
+	// The texture behind a handle - loading may move the table, so textures are all loaded before handles go to other threads
+	static const Texture2D& GetTexture(TextureHandle handle) { return textureTable[handle.index]; }
 	// Properly de-allocates all loaded resources
 	static void      Clear();
 private:
+	// Texture storage, indexed by handle - the first entry is the empty texture default handles refer to
+	static std::vector<Texture2D> textureTable;
 	// Private constructor, that is we do not want any actual resource manager objects. Its members and functions should be publicly available (static).
 	ResourceManager() { }
-	// Loads and generates a shader from file
+	// Loads and generates a shader from file, reusing the cached program binary when its sources and driver haven't changed
 	static Shader    loadShaderFromFile(const GLchar *vShaderFile, const GLchar *fShaderFile, const GLchar *gShaderFile = nullptr);
+	// Loads a linked program from its cache file, failing if the file is missing, stale or rejected by the driver
+	static GLboolean loadShaderFromCache(const std::string &cacheFile, uint64_t sourceHash, Shader &shader);
+	// Writes the linked program's binary to its cache file
+	static GLboolean writeShaderCache(const std::string &cacheFile, uint64_t sourceHash, Shader &shader);
 	// Loads a single texture from file
 	static Texture2D loadTextureFromFile(const GLchar *file, GLboolean alpha);
+	// Loads a single texture from its baked cache blob, failing if the blob is missing or stale
+	static GLboolean loadTextureFromCache(const GLchar *file, GLboolean alpha, Texture2D &texture);
+	// Writes decoded texels to the cache blob of the given image file
+	static GLboolean writeTextureCache(const GLchar *file, GLboolean alpha, GLuint width, GLuint height, 
+		const unsigned char *image, GLboolean mipmaps);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include "RewindBuffer.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+
+// zeroes it takes to end a run of changed bytes - shorter gaps are cheaper to copy along
+const size_t REWIND_BUFFER_MIN_GAP = 4;
+
+static void writeVarint(vector<unsigned char>& out, size_t value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back(static_cast<unsigned char>(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back(static_cast<unsigned char>(value));
+}
+
+static size_t readVarint(const unsigned char*& in)
+{
+	size_t value = 0;
+	for (GLuint shift = 0; ; shift += 7)
+	{
+		unsigned char byte = *in++;
+		value |= static_cast<size_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+}
+
+// small corrections either way take a byte, zigzagged so the sign is in the lowest bit
+static void writeSigned(vector<unsigned char>& out, GLint value)
+{
+	writeVarint(out, (static_cast<GLuint>(value) << 1) ^ static_cast<GLuint>(value >> 31));
+}
+
+static GLint readSigned(const unsigned char*& in)
+{
+	GLuint value = static_cast<GLuint>(readVarint(in));
+	return static_cast<GLint>(value >> 1) ^ -static_cast<GLint>(value & 1);
+}
+
+static GLint quantize(GLfloat position)
+{
+	return static_cast<GLint>(floorf(position * REWIND_BUFFER_POSITION_SCALE + .5f));
+}
+
+// the velocity or the position half of each correction in a motion delta, added on or taken off
+static void correctMotion(const unsigned char* in, const unsigned char* end, vector<GLint, TrackedAllocator<GLint, MEMORY_REWIND> >& motion,
+	GLint sign, GLboolean velocity)
+{
+	for (size_t i = 0; in < end; i++)
+	{
+		i += readVarint(in);
+		GLint velocityX = readSigned(in), velocityY = readSigned(in), positionX = readSigned(in), positionY = readSigned(in);
+		GLint* unit = &motion[i * 4];
+		if (velocity)
+		{
+			unit[2] += sign * velocityX;
+			unit[3] += sign * velocityY;
+		}
+		else
+		{
+			unit[0] += sign * positionX;
+			unit[1] += sign * positionY;
+		}
+	}
+}
+
+RewindBuffer::RewindBuffer(size_t argBudget, GLuint argMaxTicks, GLuint argKeyframeInterval)
+	: budget(argBudget), maxTicks(argMaxTicks), keyframeInterval(argKeyframeInterval)
+{
+}
+
+void RewindBuffer::record(const vector<unsigned char>& state, const vector<glm::vec2>& positions)
+{
+	quantized.resize(positions.size() * 2);
+	for (GLuint i = 0; i < positions.size(); i++)
+	{
+		quantized[i * 2] = quantize(positions[i].x);
+		quantized[i * 2 + 1] = quantize(positions[i].y);
+	}
+	Frame frame;
+	frame.tick = nextTick++;
+	// the motion is moved on even for a keyframe, as it's what the ticks after it build on
+	encodeMotion(previousMotion, recorded, quantized, motionScratch);
+	frame.keyframe = frames.empty() || frame.tick - lastKeyframe >= keyframeInterval || groupUsed >= budget / REWIND_BUFFER_GROUPS;
+	if (frame.keyframe)
+	{
+		frame.data.assign(state.begin(), state.end());
+		encodeWholeMotion(previousMotion, motionScratch);
+		lastKeyframe = frame.tick;
+		keyframes++;
+		groupUsed = 0;
+	}
+	else
+	{
+		// built up in scratch, so the kept copy is no bigger than it has to be
+		encode(previous, state, scratch);
+		frame.data.assign(scratch.begin(), scratch.end());
+	}
+	frame.motion.assign(motionScratch.begin(), motionScratch.end());
+	used += frameBytes(frame);
+	groupUsed += frameBytes(frame);
+	previous.assign(state.begin(), state.end());
+	recorded.swap(quantized);
+	frames.push_back(std::move(frame));
+
+	// the newest keyframe always stays, as everything after it builds on it
+	while ((used > budget || frames.size() > maxTicks) && keyframes > 1)
+		dropOldest();
+}
+
+void RewindBuffer::truncate(GLuint tick)
+{
+	if (frames.empty() || tick >= lastTick())
+		return;
+	// to the tick first, while previous is still the last tick's state to start from
+	if (tick >= firstTick())
+		moveCursor(tick);
+	while (!frames.empty() && frames.back().tick > tick)
+	{
+		used -= frameBytes(frames.back());
+		if (frames.back().keyframe)
+			keyframes--;
+		frames.pop_back();
+	}
+	nextTick = tick + 1;
+	if (frames.empty())
+	{
+		clear();
+		nextTick = tick + 1;
+		return;
+	}
+	groupUsed = 0;
+	for (GLuint i = static_cast<GLuint>(frames.size()); i-- > 0; )
+	{
+		groupUsed += frameBytes(frames[i]);
+		if (frames[i].keyframe)
+		{
+			lastKeyframe = frames[i].tick;
+			break;
+		}
+	}
+	previous.assign(cursor.begin(), cursor.end());
+	previousMotion.assign(cursorMotion.begin(), cursorMotion.end());
+	// where the units really were is gone - where they were played back to is as near as it gets
+	recorded.resize(cursorMotion.size() / 2);
+	for (GLuint i = 0; i < recorded.size() / 2; i++)
+	{
+		recorded[i * 2] = cursorMotion[i * 4];
+		recorded[i * 2 + 1] = cursorMotion[i * 4 + 1];
+	}
+}
+
+void RewindBuffer::clear()
+{
+	frames.clear();
+	previous.clear();
+	previousMotion.clear();
+	recorded.clear();
+	cursor.clear();
+	cursorMotion.clear();
+	nextTick = lastKeyframe = keyframes = 0;
+	cursorTick = REWIND_BUFFER_NO_TICK;
+	used = groupUsed = 0;
+}
+
+GLboolean RewindBuffer::seek(GLuint tick, vector<unsigned char>& state, vector<glm::vec2>& positions)
+{
+	if (frames.empty() || tick < firstTick() || tick > lastTick())
+		return false;
+	moveCursor(tick);
+	state.assign(cursor.begin(), cursor.end());
+	positions.resize(cursorMotion.size() / 4);
+	for (GLuint i = 0; i < positions.size(); i++)
+		positions[i] = glm::vec2(cursorMotion[i * 4], cursorMotion[i * 4 + 1]) / REWIND_BUFFER_POSITION_SCALE;
+	return true;
+}
+
+void RewindBuffer::moveCursor(GLuint tick)
+{
+	// the keyframe this tick builds on
+	GLuint target = tick - firstTick(), start = target;
+	while (!frames[start].keyframe)
+		start--;
+	// or where the cursor is, failing that the last tick recorded, if it's fewer deltas away -
+	// going back undoes deltas, and a keyframe has none to undo, so not back past one of those
+	GLuint at = static_cast<GLuint>(frames.size()) - 1;
+	GLboolean fromCursor = cursorTick != REWIND_BUFFER_NO_TICK && cursorTick >= firstTick() && cursorTick <= lastTick();
+	if (fromCursor)
+		at = cursorTick - firstTick();
+	GLboolean closer = at <= target ? at >= start : at - target < target - start;
+	for (GLuint i = target + 1; i <= at && closer; i++)
+		closer = !frames[i].keyframe;
+	if (!closer)
+	{
+		at = start;
+		cursor.assign(frames[start].data.begin(), frames[start].data.end());
+		cursorMotion.clear();
+		applyMotion(frames[start].motion, cursorMotion, true);
+	}
+	else if (!fromCursor)
+	{
+		cursor.assign(previous.begin(), previous.end());
+		cursorMotion.assign(previousMotion.begin(), previousMotion.end());
+	}
+	for (; at < target; at++)
+		stepCursor(at + 1, true);
+	for (; at > target; at--)
+		stepCursor(at, false);
+	cursorTick = tick;
+}
+
+void RewindBuffer::stepCursor(GLuint frame, GLboolean forward)
+{
+	apply(frames[frame].data, cursor, forward);
+	applyMotion(frames[frame].motion, cursorMotion, forward);
+}
+
+void RewindBuffer::dropOldest()
+{
+	// a keyframe and the deltas up to the next one
+	do
+	{
+		used -= frameBytes(frames.front());
+		if (frames.front().keyframe)
+			keyframes--;
+		frames.pop_front();
+	} while (!frames.front().keyframe);
+}
+
+void RewindBuffer::encode(const Data& base, const vector<unsigned char>& state, vector<unsigned char>& delta)
+{
+	// <size of state> <size of base> then pairs of <unchanged bytes to skip, changed bytes> <the
+	// changed bytes XOR the old ones>. The state grows and shrinks with the herd, and bytes past
+	// the end of either count as zero - so the bytes a shrinking state drops are kept too, and
+	// the delta can be undone
+	delta.clear();
+	size_t size = std::max(state.size(), base.size());
+	writeVarint(delta, state.size());
+	writeVarint(delta, base.size());
+	size_t i = 0;
+	while (i < size)
+	{
+		size_t start = i;
+		while (i < size && (i < base.size() ? base[i] : 0) == (i < state.size() ? state[i] : 0))
+			i++;
+		if (i == size)
+			break;
+		size_t skipped = i - start, changed = i, zeroes = 0;
+		// the run of changes goes on until enough unchanged bytes in a row
+		for (size_t j = i; j < size && zeroes < REWIND_BUFFER_MIN_GAP; j++)
+		{
+			if ((j < base.size() ? base[j] : 0) == (j < state.size() ? state[j] : 0))
+				zeroes++;
+			else
+			{
+				zeroes = 0;
+				changed = j + 1;
+			}
+		}
+		writeVarint(delta, skipped);
+		writeVarint(delta, changed - i);
+		for (; i < changed; i++)
+			delta.push_back((i < state.size() ? state[i] : 0) ^ (i < base.size() ? base[i] : 0));
+	}
+}
+
+void RewindBuffer::apply(const Data& delta, Data& state, GLboolean forward)
+{
+	const unsigned char* in = delta.data();
+	const unsigned char* end = in + delta.size();
+	size_t size = readVarint(in), baseSize = readVarint(in), i = 0;
+	// bytes past the end are XORed against zero, as they were encoded, and cut off after
+	state.resize(std::max(size, baseSize), 0);
+	while (in < end)
+	{
+		i += readVarint(in);
+		size_t changed = readVarint(in);
+		for (size_t j = 0; j < changed; j++, i++)
+			state[i] ^= *in++;
+	}
+	state.resize(forward ? size : baseSize);
+}
+
+void RewindBuffer::encodeMotion(Motion& motion, const vector<GLint>& last, const vector<GLint>& now, vector<unsigned char>& delta)
+{
+	// <units now> <units before> then, for each unit corrected, <units skipped since the last
+	// correction> <velocity x, y correction> <position x, y correction>. A unit left alone moves
+	// on by its velocity. Ones past the end of either count as standing still at 0, so ones that
+	// go are brought back to that first, and the delta can be undone
+	delta.clear();
+	size_t count = now.size() / 2, base = motion.size() / 4, size = std::max(count, base);
+	writeVarint(delta, count);
+	writeVarint(delta, base);
+	motion.resize(size * 4, 0);
+	size_t skipped = 0;
+	for (size_t i = 0; i < size; i++)
+	{
+		GLint* unit = &motion[i * 4];
+		GLint x = i < count ? now[i * 2] : 0, y = i < count ? now[i * 2 + 1] : 0;
+		GLint strayX = x - (unit[0] + unit[2]), strayY = y - (unit[1] + unit[3]);
+		GLboolean correct = i < count
+			? abs(strayX) > REWIND_BUFFER_POSITION_TOLERANCE || abs(strayY) > REWIND_BUFFER_POSITION_TOLERANCE
+			: strayX || strayY || unit[2] || unit[3];
+		if (!correct)
+		{
+			unit[0] += unit[2];
+			unit[1] += unit[3];
+			skipped++;
+			continue;
+		}
+		// the velocity it really had over the last tick, and right onto where it is
+		GLint velocityX = i < count && i < last.size() / 2 ? x - last[i * 2] : 0;
+		GLint velocityY = i < count && i < last.size() / 2 ? y - last[i * 2 + 1] : 0;
+		writeVarint(delta, skipped);
+		writeSigned(delta, velocityX - unit[2]);
+		writeSigned(delta, velocityY - unit[3]);
+		writeSigned(delta, x - unit[0] - velocityX);
+		writeSigned(delta, y - unit[1] - velocityY);
+		unit[0] = x;
+		unit[1] = y;
+		unit[2] = velocityX;
+		unit[3] = velocityY;
+		skipped = 0;
+	}
+	motion.resize(count * 4);
+}
+
+void RewindBuffer::encodeWholeMotion(const Motion& motion, vector<unsigned char>& delta)
+{
+	// the same, as corrections to units that were all standing still at 0
+	delta.clear();
+	size_t count = motion.size() / 4, skipped = 0;
+	writeVarint(delta, count);
+	writeVarint(delta, 0);
+	for (size_t i = 0; i < count; i++)
+	{
+		const GLint* unit = &motion[i * 4];
+		if (!unit[0] && !unit[1] && !unit[2] && !unit[3])
+		{
+			skipped++;
+			continue;
+		}
+		writeVarint(delta, skipped);
+		writeSigned(delta, unit[2]);
+		writeSigned(delta, unit[3]);
+		writeSigned(delta, unit[0] - unit[2]);
+		writeSigned(delta, unit[1] - unit[3]);
+		skipped = 0;
+	}
+}
+
+void RewindBuffer::applyMotion(const Data& delta, Motion& motion, GLboolean forward)
+{
+	const unsigned char* in = delta.data();
+	const unsigned char* end = in + delta.size();
+	size_t count = readVarint(in), base = readVarint(in);
+	motion.resize(std::max(count, base) * 4, 0);
+	// velocities are corrected, every unit moves on, then positions are - or back the other way
+	if (forward)
+		correctMotion(in, end, motion, 1, true);
+	else
+		correctMotion(in, end, motion, -1, false);
+	GLint sign = forward ? 1 : -1;
+	for (size_t i = 0; i < motion.size(); i += 4)
+	{
+		motion[i] += sign * motion[i + 2];
+		motion[i + 1] += sign * motion[i + 3];
+	}
+	if (forward)
+		correctMotion(in, end, motion, 1, false);
+	else
+		correctMotion(in, end, motion, -1, true);
+	motion.resize((forward ? count : base) * 4);
+}
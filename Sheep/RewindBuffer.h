@@ -0,0 +1,97 @@
+#ifndef REWIND_BUFFER_H
+#define REWIND_BUFFER_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <deque>
+#include <vector>
+
+#include "Memory.h"
+
+using namespace std;
+
+// most memory the recorded ticks may take up, and most ticks kept - whichever runs out first. A
+// tick's memory is all of it, bookkeeping included, as the F3 overlay counts it
+const size_t REWIND_BUFFER_BUDGET = 4 << 20;
+const GLuint REWIND_BUFFER_TICKS = 60 * 60;
+// every this many ticks, the state is kept whole rather than as a delta - and sooner, once the
+// ticks since the last one take up this fraction of the budget, so dropping the oldest keyframe
+// and its deltas always gets the buffer back under budget
+const GLuint REWIND_BUFFER_KEYFRAME_INTERVAL = 10 * 60;
+const GLuint REWIND_BUFFER_GROUPS = 8;
+const GLuint REWIND_BUFFER_NO_TICK = 0xFFFFFFFF;
+// unit positions are kept to a 256th of a pixel, and only corrected once a unit has strayed
+// further than this from where its last velocity would have put it - with the rounding to the
+// 256th, they come back within 1/8 of a pixel
+const GLfloat REWIND_BUFFER_POSITION_SCALE = 256.f;
+const GLint REWIND_BUFFER_POSITION_TOLERANCE = 31;
+
+// The last stretch of a game, tick by tick, for scrubbing back through. A tick is two things: the
+// state as written by Snapshot::writeRewind, and where each unit is. The state is kept as the XOR
+// against the tick before, with runs of zeroes - bytes that didn't change - squeezed out and
+// lengths stored as varints. The units' positions, which change every tick, are dead reckoned
+// instead: each unit carries on at the velocity it was last given, and a tick only keeps the
+// velocity and position corrections of the units that strayed from that, so a herd walking
+// along costs next to nothing. Every so often a whole keyframe is kept that the deltas after it
+// build on. Seeking carries on from wherever the last seek (or the last tick recorded) left off,
+// when that's closer than the nearest keyframe at or before the tick: forward by applying deltas,
+// and back by undoing them - so scrubbing a tick at a time costs a delta a tick. Once over
+// budget, the oldest keyframe and its deltas go, so the buffer covers less time when a lot is
+// happening, rather than taking up more memory.
+class RewindBuffer
+{
+public:
+	size_t budget;
+	GLuint maxTicks, keyframeInterval;
+
+	// constructors
+	RewindBuffer(size_t argBudget = REWIND_BUFFER_BUDGET, GLuint argMaxTicks = REWIND_BUFFER_TICKS,
+		GLuint argKeyframeInterval = REWIND_BUFFER_KEYFRAME_INTERVAL);
+	// recording - the state of the next tick, and its units' positions by unit id
+	void record(const vector<unsigned char>& state, const vector<glm::vec2>& positions);
+	// forgets the ticks after tick, so recording carries on from there
+	void truncate(GLuint tick);
+	void clear();
+	// seeking - any tick from firstTick() to lastTick(). Positions come back within the tolerance
+	GLboolean seek(GLuint tick, vector<unsigned char>& state, vector<glm::vec2>& positions);
+	GLboolean empty() const { return frames.empty(); }
+	GLuint firstTick() const { return frames.front().tick; }
+	GLuint lastTick() const { return frames.back().tick; }
+	size_t memoryUsed() const { return used; }
+private:
+	typedef vector<unsigned char, TrackedAllocator<unsigned char, MEMORY_REWIND> > Data;
+	// per unit id: x, y, and the velocity in each, in 256ths of a pixel (per tick)
+	typedef vector<GLint, TrackedAllocator<GLint, MEMORY_REWIND> > Motion;
+	struct Frame
+	{
+		GLuint tick;
+		GLboolean keyframe;
+		Data data;	 // the whole state for keyframes, a delta otherwise
+		Data motion; // the units' corrections - against no units at all for keyframes
+	};
+	deque<Frame, TrackedAllocator<Frame, MEMORY_REWIND> > frames;
+	Data previous;			// state of the last tick recorded, that the next is diffed against
+	Motion previousMotion;	// and the units' motion, as it will be played back
+	vector<GLint> recorded; // where the units of the last tick recorded really were
+	Data cursor;			// state of cursorTick, where the last seek left off
+	Motion cursorMotion;
+	vector<unsigned char> scratch, motionScratch;
+	vector<GLint> quantized;
+	GLuint nextTick = 0, lastKeyframe = 0, keyframes = 0, cursorTick = REWIND_BUFFER_NO_TICK;
+	size_t used = 0, groupUsed = 0; // groupUsed is what the ticks since the last keyframe take up
+
+	// what a frame takes up, itself and what it holds
+	static size_t frameBytes(const Frame& frame) { return sizeof(Frame) + frame.data.capacity() + frame.motion.capacity(); }
+	void dropOldest();
+	void moveCursor(GLuint tick);
+	void stepCursor(GLuint frame, GLboolean forward);
+	static void encode(const Data& base, const vector<unsigned char>& state, vector<unsigned char>& delta);
+	// forward turns the state a delta was taken against into the one after it, and back the reverse
+	static void apply(const Data& delta, Data& state, GLboolean forward);
+	// moves motion on a tick toward where the units are now, writing down the corrections made
+	static void encodeMotion(Motion& motion, const vector<GLint>& last, const vector<GLint>& now, vector<unsigned char>& delta);
+	static void encodeWholeMotion(const Motion& motion, vector<unsigned char>& delta);
+	static void applyMotion(const Data& delta, Motion& motion, GLboolean forward);
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "Selection.h"
+#include "Unit.h"
+
+std::vector<Unit*> Selection::dense;
+std::vector<GLuint> Selection::denseIndex;
+std::vector<uint64_t> Selection::bits;
+
+void Selection::add(Unit* unit)
+{
+	GLuint id = unit->id;
+	if (contains(id))
+		return;
+	if (id / 64 >= bits.size())
+		bits.resize(id / 64 + 1, 0);
+	if (id >= denseIndex.size())
+		denseIndex.resize(id + 1);
+	bits[id / 64] |= uint64_t(1) << (id % 64);
+	denseIndex[id] = static_cast<GLuint>(dense.size());
+	dense.push_back(unit);
+}
+
+void Selection::remove(Unit* unit)
+{
+	GLuint id = unit->id;
+	if (!contains(id))
+		return;
+	bits[id / 64] &= ~(uint64_t(1) << (id % 64));
+	// fill the hole with the last unit
+	GLuint index = denseIndex[id];
+	dense[index] = dense.back();
+	denseIndex[dense[index]->id] = index;
+	dense.pop_back();
+}
+
+void Selection::clear()
+{
+	// every bit that's set belongs to a unit in dense, so whole words can be zeroed
+	for (GLuint i = 0; i < dense.size(); i++)
+		bits[dense[i]->id / 64] = 0;
+	dense.clear();
+}
+
+GLboolean Selection::contains(GLuint id)
+{
+	return id / 64 < bits.size() && (bits[id / 64] >> (id % 64)) & 1;
+}
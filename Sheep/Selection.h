@@ -0,0 +1,29 @@
+#ifndef SELECTION_H
+#define SELECTION_H
+
+#include <GL/glew.h>
+#include <stdint.h>
+#include <vector>
+
+class Unit;
+
+// The units that are selected, kept as a sparse set: a dense array of the selected units, for
+// commands that go out to all of them, plus a bitset keyed by Unit::id, for checking a single
+// unit. Adding, removing and checking are constant time, and clearing or visiting the selection
+// costs as much as the selection is big, not the herd.
+class Selection
+{
+public:
+	static void add(Unit* unit);
+	static void remove(Unit* unit);
+	static void clear();
+	static GLboolean contains(GLuint id);
+	// the selected units, in no particular order
+	static const std::vector<Unit*>& units() { return dense; }
+private:
+	static std::vector<Unit*> dense;
+	static std::vector<GLuint> denseIndex; // where each selected id sits in dense
+	static std::vector<uint64_t> bits;
+};
+
+#endif
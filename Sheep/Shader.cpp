@@ -7,10 +7,20 @@
 ** option) any later version.
 ******************************************************************/
 #include "Shader.h"
+#include "Memory.h"
 
 #include <iostream>
 using namespace std;
 
+// registers a linked program, sized by its binary - the closest thing to a size the driver gives
+static void trackProgram(GLuint program)
+{
+	GLint length = 0;
+	if (Shader::BinariesSupported())
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	Memory::trackGL(GL_OBJECT_PROGRAM, program, length);
+}
+
 Shader &Shader::Use()
 {
 	glUseProgram(this->ID);
@@ -40,12 +50,15 @@ void Shader::Compile(const GLchar* vertexSource, const GLchar* fragmentSource, c
 	}
 	// Shader Program
 	this->ID = glCreateProgram();
+	if (BinariesSupported())
+		glProgramParameteri(this->ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glAttachShader(this->ID, sVertex);
 	glAttachShader(this->ID, sFragment);
 	if (geometrySource != nullptr)
 		glAttachShader(this->ID, gShader);
 	glLinkProgram(this->ID);
 	checkCompileErrors(this->ID, "PROGRAM");
+	trackProgram(this->ID);
 	// Delete the shaders as they're linked into our program now and no longer necessery
 	glDeleteShader(sVertex);
 	glDeleteShader(sFragment);
@@ -53,6 +66,44 @@ void Shader::Compile(const GLchar* vertexSource, const GLchar* fragmentSource, c
 		glDeleteShader(gShader);
 }
 
+GLboolean Shader::LoadBinary(GLenum format, const void *binary, GLsizei length)
+{
+	this->ID = glCreateProgram();
+	glProgramBinary(this->ID, format, binary, length);
+	// a driver update can invalidate old binaries, in which case the program just fails to link
+	GLint success;
+	glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glDeleteProgram(this->ID);
+		this->ID = 0;
+		return false;
+	}
+	trackProgram(this->ID);
+	return true;
+}
+
+GLboolean Shader::GetBinary(GLenum &format, std::vector<unsigned char> &binary)
+{
+	GLint length = 0;
+	glGetProgramiv(this->ID, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return false;
+	binary.resize(length);
+	glGetProgramBinary(this->ID, length, &length, &format, binary.data());
+	binary.resize(length);
+	return length > 0;
+}
+
+GLboolean Shader::BinariesSupported()
+{
+	if (!GLEW_ARB_get_program_binary)
+		return false;
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	return formats > 0;
+}
+
 void Shader::SetBoolean(const GLchar * name, GLboolean value, GLboolean useShader)
 {
 	if (useShader)
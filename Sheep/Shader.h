@@ -10,6 +10,7 @@
 #define SHADER_H
 
 #include <string>
+#include <vector>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
@@ -25,11 +26,17 @@ public:
 	// State
 	GLuint ID;
 	// Constructor
-	Shader() { }
+	Shader() : ID(0) { }
 	// Sets the current shader as active
 	Shader  &Use();
 	// Compiles the shader from given source code
 	void    Compile(const GLchar *vertexSource, const GLchar *fragmentSource, const GLchar *geometrySource = nullptr); // Note: geometry source code is optional 
+	// Creates the program from a binary previously retrieved with GetBinary, failing if the driver rejects it
+	GLboolean LoadBinary(GLenum format, const void *binary, GLsizei length);
+	// Retrieves the linked program's binary so it can be cached across launches
+	GLboolean GetBinary(GLenum &format, std::vector<unsigned char> &binary);
+	// Whether the driver can hand out and take back program binaries at all
+	static GLboolean BinariesSupported();
 																													   // Utility functions
 	void	SetBoolean(const GLchar *name, GLboolean value, GLboolean useShader = false);
 	void    SetFloat(const GLchar *name, GLfloat value, GLboolean useShader = false);
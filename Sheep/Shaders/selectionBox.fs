@@ -1,13 +1,13 @@
  #version 330 core
 in vec4 TexCoords;
+in vec4 SpriteColor;
 out vec4 color;
 
 uniform sampler2D image;
-uniform vec4 spriteColor;
 
 void main()
 {
-    color = vec4(spriteColor) * texture(image, TexCoords.zw);
+    color = SpriteColor * texture(image, TexCoords.zw);
 	if (TexCoords.x < -.495f || TexCoords.x > 0.495f)
 		color.a = .75;
 }  
\ No newline at end of file
@@ -1,14 +1,23 @@
 #version 330 core
-layout (location = 0) 
-in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec4 instanceTransform; // <vec2 position, vec2 size>
+layout (location = 2) in vec4 instanceColor;
+layout (location = 3) in vec4 instanceSample; // unused, sprite layout
+layout (location = 4) in vec4 instanceRotation; // <rotation, unused, unused, unused>
+layout (location = 5) in vec4 instanceAnimation; // unused, sprite layout
 
 out vec4 TexCoords;
+out vec4 SpriteColor;
 
-uniform mat4 model;
 uniform mat4 projection;
 
 void main()
 {
     TexCoords = vertex;
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
+	SpriteColor = instanceColor;
+	float s = sin(instanceRotation.x);
+	float c = cos(instanceRotation.x);
+	vec2 scaled = vertex.xy * instanceTransform.zw;
+	vec2 world = vec2(c * scaled.x - s * scaled.y, s * scaled.x + c * scaled.y) + instanceTransform.xy;
+    gl_Position = projection * vec4(world, 0.0, 1.0);
 }
\ No newline at end of file
@@ -1,11 +1,11 @@
- #version 330 core
+#version 330 core
 in vec2 TexCoords;
+in vec4 SpriteColor;
 out vec4 color;
 
 uniform sampler2D image;
-uniform vec4 spriteColor;
 
 void main()
 {    
-    color = vec4(spriteColor) * texture(image, TexCoords);
+    color = SpriteColor * texture(image, TexCoords);
 }  
\ No newline at end of file
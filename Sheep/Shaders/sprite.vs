@@ -1,24 +1,48 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+layout (location = 1) in vec4 instanceTransform; // <vec2 position, vec2 size>
+layout (location = 2) in vec4 instanceColor;
+layout (location = 3) in vec4 instanceSample; // <vec2 sampleDivider, first sample index, unused>
+layout (location = 4) in vec4 instanceRotation; // <rotation, mirrorXAxis, mirrorYAxis, unused>
+layout (location = 5) in vec4 instanceAnimation; // <startTime, frameCount, frameDuration, loopMode>
 
 out vec2 TexCoords;
+out vec4 SpriteColor;
 
-uniform mat4 model;
 uniform mat4 projection;
-uniform vec2 sampleDivider;
-uniform vec2 sampleOffset;
-uniform bool mirrorXAxis;
-uniform bool mirrorYAxis;
+uniform float time;
 
 void main()
 {
+	// step through the animation - loopMode 0 wraps around, 1 holds the last frame
+	int frame = int(instanceSample.z);
+	int frameCount = int(instanceAnimation.y);
+	if (frameCount > 1)
+	{
+		int step = int(floor(max(time - instanceAnimation.x, 0.0) / instanceAnimation.z));
+		if (instanceAnimation.w < 0.5)
+			step = step % frameCount;
+		else
+			step = min(step, frameCount - 1);
+		frame += step;
+	}
+	// treat the image as an array of samples, row by row
+	vec2 sampleDivider = instanceSample.xy;
+	int columns = int(sampleDivider.x);
+	vec2 sampleOffset = vec2(frame % columns, frame / columns);
     TexCoords = vec2((vertex.z + sampleOffset.x)/ sampleDivider.x, 
 					(vertex.w + sampleOffset.y) / sampleDivider.y);
 	
-	if (mirrorXAxis)
+	if (instanceRotation.y > 0.5)
 		TexCoords.x = (1.0 - sampleOffset.x)/sampleDivider.x - TexCoords.x;
-    if (mirrorYAxis)
+    if (instanceRotation.z > 0.5)
 		TexCoords.y = (1.0 - sampleOffset.y)/sampleDivider.y - TexCoords.y;
-		
-	gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
+	SpriteColor = instanceColor;
+
+	// scale, then rotate, then translate the unit quad
+	float s = sin(instanceRotation.x);
+	float c = cos(instanceRotation.x);
+	vec2 scaled = vertex.xy * instanceTransform.zw;
+	vec2 world = vec2(c * scaled.x - s * scaled.y, s * scaled.x + c * scaled.y) + instanceTransform.xy;
+	gl_Position = projection * vec4(world, 0.0, 1.0);
 }
\ No newline at end of file
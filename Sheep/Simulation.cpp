@@ -0,0 +1,73 @@
+#include "Simulation.h"
+
+#include <chrono>
+
+typedef std::chrono::steady_clock SimulationClock;
+
+Simulation::Simulation(GLboolean (*argTick)(GLfloat), GLfloat argTickLength, GLuint argMaxCatchUp)
+	: tickLength(argTickLength), maxCatchUp(argMaxCatchUp), ticksDropped(0), tick(argTick)
+{
+	thread = std::thread(&Simulation::run, this);
+}
+
+Simulation::~Simulation()
+{
+	{
+		std::lock_guard<std::mutex> lock(tickMutex);
+		quit = true;
+	}
+	wake.notify_all();
+	thread.join();
+}
+
+void Simulation::start()
+{
+	{
+		std::lock_guard<std::mutex> lock(tickMutex);
+		running = true;
+	}
+	wake.notify_all();
+}
+
+std::unique_lock<std::mutex> Simulation::hold()
+{
+	return std::unique_lock<std::mutex>(tickMutex);
+}
+
+void Simulation::run()
+{
+	const SimulationClock::duration tickDuration =
+		std::chrono::duration_cast<SimulationClock::duration>(std::chrono::duration<GLfloat>(tickLength));
+	SimulationClock::time_point nextTick;
+	std::unique_lock<std::mutex> lock(tickMutex);
+	while (true)
+	{
+		if (!running && !quit)
+		{
+			wake.wait(lock, [this] { return running || quit; });
+			nextTick = SimulationClock::now();
+		}
+		if (quit)
+			break;
+
+		// run every tick that's come due
+		GLuint ticks = 0;
+		while (running && SimulationClock::now() >= nextTick)
+		{
+			if (ticks == maxCatchUp)
+			{
+				// too far behind to ever catch up - let the game slow down instead
+				ticksDropped += static_cast<GLuint>((SimulationClock::now() - nextTick) / tickDuration) + 1;
+				nextTick = SimulationClock::now();
+				break;
+			}
+			running = tick(tickLength);
+			nextTick += tickDuration;
+			ticks++;
+		}
+
+		// the lock is let go while waiting, which is when hold() gets its turn
+		if (running)
+			wake.wait_until(lock, nextTick, [this] { return quit; });
+	}
+}
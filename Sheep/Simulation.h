@@ -0,0 +1,42 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <GL/glew.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Runs a tick function on its own thread at a fixed rate, independent of how fast frames are
+// drawn. Each tick advances the game by exactly tickLength seconds; if the thread falls behind,
+// it runs up to maxCatchUp ticks back to back and drops whatever is left, rather than slowing
+// down for good. The tick function returns whether to keep going - once it says no, the thread
+// sleeps until start() is called again.
+class Simulation
+{
+public:
+	GLfloat tickLength;	// seconds of game time per tick
+	GLuint maxCatchUp;	// most ticks run back to back to catch up after a stall
+	GLuint ticksDropped; // ticks skipped since the thread couldn't keep up
+
+	// constructors
+	Simulation(GLboolean (*argTick)(GLfloat), GLfloat argTickLength, GLuint argMaxCatchUp = 5);
+	~Simulation();
+	// starts ticking, counting from now
+	void start();
+	// waits for the tick in progress, if any, and keeps another one from starting while the lock
+	// is held - anything that touches game state outside of a tick has to hold on to it
+	std::unique_lock<std::mutex> hold();
+private:
+	GLboolean (*tick)(GLfloat);
+	std::thread thread;
+	std::mutex tickMutex;		   // held for the duration of each tick
+	std::condition_variable wake;
+	GLboolean running = false;	   // guarded by tickMutex, like quit
+	GLboolean quit = false;
+	Simulation(const Simulation&);
+	Simulation& operator=(const Simulation&);
+
+	void run();
+};
+
+#endif
@@ -0,0 +1,542 @@
+#include "Snapshot.h"
+#include "Game.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string.h>
+
+static const char SNAPSHOT_MAGIC[4] = { 'S', 'H', 'S', 'N' };
+
+// what a snapshot is built up in and read back out through, kept from one call to the next - a
+// rewind records one every tick, and reads one every tick it's scrubbed through, so neither
+// allocates once they've grown to fit the game
+struct SnapshotScratch
+{
+	// writing
+	vector<const Unit*> liveUnits; // sorted, to look pointers up in
+	vector<pair<const FlowField*, GLuint> > fieldIndices; // sorted by field
+	vector<SnapshotUnit> units;
+	vector<SnapshotFlowField> fields;
+	vector<GLuint> costs, freeIds, members;
+	vector<SnapshotFlock> flocks;
+	vector<SnapshotLazer> lazers;
+	vector<SnapshotRocket> rockets;
+	vector<SnapshotPowerUp> powerUps;
+	// reading
+	vector<Unit*> unitsById;
+	vector<shared_ptr<FlowField> > oldFields, newFields;
+};
+static SnapshotScratch scratch;
+
+template <typename T>
+static void append(vector<unsigned char>& blob, const T* items, size_t count)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(items);
+	blob.insert(blob.end(), bytes, bytes + count * sizeof(T));
+}
+
+// where the next array starts, moving past it
+template <typename T>
+static const T* section(const unsigned char*& cursor, uint32_t count)
+{
+	const T* items = reinterpret_cast<const T*>(cursor);
+	cursor += count * sizeof(T);
+	return items;
+}
+
+static void copy2(float* destination, glm::vec2 source)
+{
+	destination[0] = source.x;
+	destination[1] = source.y;
+}
+
+// hazard timers are saved the way they used to be kept, as time left on the fuse and how long the
+// blast lingers - or, once it's gone off, no fuse and the time it has left
+static void timerRecord(const Timer& timer, const Blast& blast, GLfloat time, float& fuse, float& linger)
+{
+	fuse = blast.detonated ? 0.f : timer.due - time;
+	linger = blast.detonated ? timer.due - time : timer.linger;
+}
+
+// the id of a unit flocks or rockets point at, if it's still alive - it's only looked at if it is
+static uint32_t liveId(const Unit* unit)
+{
+	vector<const Unit*>::const_iterator live = std::lower_bound(scratch.liveUnits.begin(), scratch.liveUnits.end(), unit);
+	return live != scratch.liveUnits.end() && *live == unit ? (*live)->id : SNAPSHOT_NONE;
+}
+
+static Timer timerFromRecord(float fuse, float linger, GLboolean detonated, GLfloat time)
+{
+	Timer timer = { time + (detonated ? linger : fuse), linger, TIMER_NONE };
+	return timer;
+}
+
+void Snapshot::write(vector<unsigned char>& blob)
+{
+	// flocks and rockets keep units by pointer, and may still point at ones that have died -
+	// only the living ones are looked up
+	scratch.liveUnits.assign(Game::units.begin(), Game::units.end());
+	std::sort(scratch.liveUnits.begin(), scratch.liveUnits.end());
+
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SNAPSHOT_VERSION;
+	header.width = Game::Width;
+	header.height = Game::Height;
+	header.difficulty = Game::difficulty;
+	header.gameScore = Game::gameScore;
+	header.gameTime = Game::gameTime;
+	header.powerUpSpawnTime = Game::powerUpSpawnTime;
+	header.hazardTime = Game::hazardHandler->gameTime;
+	header.nextLazerTime = Game::hazardHandler->nextLazerTime;
+	header.nextRocketTime = Game::hazardHandler->nextRocketTime;
+	header.randomState = Game::random.state;
+	header.stateHash = Game::stateHash;
+
+	// units, and the flow fields they share
+	vector<SnapshotUnit>& units = scratch.units;
+	vector<SnapshotFlowField>& fields = scratch.fields;
+	vector<GLuint>& costs = scratch.costs;
+	vector<pair<const FlowField*, GLuint> >& fieldIndices = scratch.fieldIndices;
+	units.resize(Game::units.size());
+	fields.clear();
+	costs.clear();
+	fieldIndices.clear();
+	for (GLuint i = 0; i < Game::units.size(); i++)
+	{
+		Unit* unit = Game::units[i];
+		SnapshotUnit& record = units[i];
+		record.id = unit->id;
+		record.flowField = SNAPSHOT_NONE;
+		if (unit->flowField)
+		{
+			const FlowField* field = unit->flowField.get();
+			vector<pair<const FlowField*, GLuint> >::iterator index = std::lower_bound(fieldIndices.begin(), fieldIndices.end(),
+				make_pair(field, GLuint(0)));
+			if (index == fieldIndices.end() || index->first != field)
+			{
+				index = fieldIndices.insert(index, make_pair(field, static_cast<GLuint>(fields.size())));
+				SnapshotFlowField fieldRecord;
+				copy2(fieldRecord.goal, field->goal);
+				fields.push_back(fieldRecord);
+				costs.insert(costs.end(), field->cellCosts().begin(), field->cellCosts().end());
+				header.flowFieldCells = static_cast<uint32_t>(field->cellCosts().size());
+			}
+			record.flowField = index->second;
+		}
+		copy2(record.position, unit->position);
+		copy2(record.prevPosition, unit->prevPosition);
+		copy2(record.destination, unit->destination);
+		copy2(record.movementVector, unit->movementVector);
+		copy2(record.steering, unit->steering);
+		copy2(record.size, unit->size);
+		record.velocity = unit->velocity;
+		record.angle = unit->angle;
+		record.rotation = unit->rotation;
+		record.speedScale = unit->speedScale;
+		record.animationStart = unit->animation.startTime;
+		record.animationFrameDuration = unit->animation.frameDuration;
+		record.animationFrames = unit->animation.frameCount;
+		record.animationLoop = unit->animation.loopMode;
+		record.moving = unit->moving;
+		record.selected = unit->isSelected();
+	}
+	GLuint nextId;
+	vector<GLuint>& freeIds = scratch.freeIds;
+	Unit::saveIds(nextId, freeIds);
+	header.nextUnitId = nextId;
+
+	vector<SnapshotFlock>& flocks = scratch.flocks;
+	vector<GLuint>& members = scratch.members;
+	flocks.resize(Game::flocks.size());
+	members.clear();
+	for (GLuint i = 0; i < Game::flocks.size(); i++)
+	{
+		const Flock& flock = Game::flocks[i];
+		SnapshotFlock& record = flocks[i];
+		copy2(record.destination, flock.destination);
+		copy2(record.position, flock.position);
+		record.angle = flock.angle;
+		record.minX = flock.minX;
+		record.minY = flock.minY;
+		record.maxX = flock.maxX;
+		record.maxY = flock.maxY;
+		record.firstMember = static_cast<uint32_t>(members.size());
+		for (GLuint j = 0; j < flock.units.size(); j++)
+		{
+			uint32_t id = liveId(flock.units[j]);
+			if (id != SNAPSHOT_NONE)
+				members.push_back(id);
+		}
+		record.memberCount = static_cast<uint32_t>(members.size()) - record.firstMember;
+	}
+
+	// hazards and power ups
+	GLfloat hazardTime = Game::hazardHandler->gameTime;
+	LazerArchetype& lazerList = Game::hazardHandler->lazers;
+	vector<SnapshotLazer>& lazers = scratch.lazers;
+	lazers.resize(lazerList.size());
+	for (GLuint i = 0; i < lazerList.size(); i++)
+	{
+		SnapshotLazer& record = lazers[i];
+		const Transform& transform = lazerList.column<Transform>()[i];
+		copy2(record.position, transform.position);
+		copy2(record.size, transform.size);
+		copy2(record.chunkSize, lazerList.column<Beam>()[i].chunkSize);
+		record.rotation = transform.rotation;
+		timerRecord(lazerList.column<Timer>()[i], lazerList.column<Blast>()[i], hazardTime, record.timer, record.duration);
+		record.animationStart = lazerList.column<Animation>()[i].animation.startTime;
+		record.detonated = lazerList.column<Blast>()[i].detonated;
+	}
+	RocketArchetype& rocketList = Game::hazardHandler->rockets;
+	vector<SnapshotRocket>& rockets = scratch.rockets;
+	rockets.resize(rocketList.size());
+	for (GLuint i = 0; i < rocketList.size(); i++)
+	{
+		SnapshotRocket& record = rockets[i];
+		const Transform& transform = rocketList.column<Transform>()[i];
+		const Mover& mover = rocketList.column<Mover>()[i];
+		copy2(record.position, transform.position);
+		copy2(record.destination, mover.destination);
+		copy2(record.size, transform.size);
+		record.rotation = transform.rotation;
+		record.velocity = mover.velocity;
+		record.angularVelocity = mover.angularVelocity;
+		timerRecord(rocketList.column<Timer>()[i], rocketList.column<Blast>()[i], hazardTime, record.timer, record.duration);
+		record.detonated = rocketList.column<Blast>()[i].detonated;
+		record.target = liveId(mover.target);
+	}
+	vector<SnapshotPowerUp>& powerUps = scratch.powerUps;
+	powerUps.resize(Game::powerUps.size());
+	for (GLuint i = 0; i < Game::powerUps.size(); i++)
+	{
+		copy2(powerUps[i].position, Game::powerUps.column<Transform>()[i].position);
+		copy2(powerUps[i].size, Game::powerUps.column<Transform>()[i].size);
+		// power ups never time out - the field's only kept so the format stays the same
+		powerUps[i].timer = 0.f;
+	}
+
+	header.unitCount = static_cast<uint32_t>(units.size());
+	header.freeIdCount = static_cast<uint32_t>(freeIds.size());
+	header.flowFieldCount = static_cast<uint32_t>(fields.size());
+	header.flockCount = static_cast<uint32_t>(flocks.size());
+	header.flockMemberCount = static_cast<uint32_t>(members.size());
+	header.lazerCount = static_cast<uint32_t>(lazers.size());
+	header.rocketCount = static_cast<uint32_t>(rockets.size());
+	header.powerUpCount = static_cast<uint32_t>(powerUps.size());
+	append(blob, &header, 1);
+	append(blob, units.data(), units.size());
+	append(blob, freeIds.data(), freeIds.size());
+	append(blob, fields.data(), fields.size());
+	append(blob, costs.data(), costs.size());
+	append(blob, flocks.data(), flocks.size());
+	append(blob, members.data(), members.size());
+	append(blob, lazers.data(), lazers.size());
+	append(blob, rockets.data(), rockets.size());
+	append(blob, powerUps.data(), powerUps.size());
+}
+
+GLboolean Snapshot::read(const unsigned char* data, size_t size)
+{
+	/// checking
+	SnapshotHeader header;
+	if (size < sizeof(header))
+		return false;
+	memcpy(&header, data, sizeof(header));
+	if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version != SNAPSHOT_VERSION)
+	{
+		std::cout << "ERROR::SNAPSHOT: Not a snapshot, or one of another version" << std::endl;
+		return false;
+	}
+	if (header.width != Game::Width || header.height != Game::Height || header.difficulty > NORMAL
+		|| (header.flowFieldCount > 0 && header.flowFieldCells != FlowField::cellCount(Game::Width, Game::Height)))
+	{
+		std::cout << "ERROR::SNAPSHOT: Snapshot was taken in a different world" << std::endl;
+		return false;
+	}
+	uint64_t expectedSize = sizeof(header)
+		+ uint64_t(header.unitCount) * sizeof(SnapshotUnit)
+		+ uint64_t(header.freeIdCount) * sizeof(uint32_t)
+		+ uint64_t(header.flowFieldCount) * (sizeof(SnapshotFlowField) + uint64_t(header.flowFieldCells) * sizeof(uint32_t))
+		+ uint64_t(header.flockCount) * sizeof(SnapshotFlock)
+		+ uint64_t(header.flockMemberCount) * sizeof(uint32_t)
+		+ uint64_t(header.lazerCount) * sizeof(SnapshotLazer)
+		+ uint64_t(header.rocketCount) * sizeof(SnapshotRocket)
+		+ uint64_t(header.powerUpCount) * sizeof(SnapshotPowerUp);
+	if (size != expectedSize)
+	{
+		std::cout << "ERROR::SNAPSHOT: Snapshot is truncated or corrupt" << std::endl;
+		return false;
+	}
+	const unsigned char* cursor = data + sizeof(header);
+	const SnapshotUnit* unitRecords = section<SnapshotUnit>(cursor, header.unitCount);
+	const uint32_t* freeIds = section<uint32_t>(cursor, header.freeIdCount);
+	const SnapshotFlowField* fieldRecords = section<SnapshotFlowField>(cursor, header.flowFieldCount);
+	const uint32_t* costs = section<uint32_t>(cursor, header.flowFieldCount * header.flowFieldCells);
+	const SnapshotFlock* flockRecords = section<SnapshotFlock>(cursor, header.flockCount);
+	const uint32_t* members = section<uint32_t>(cursor, header.flockMemberCount);
+	const SnapshotLazer* lazerRecords = section<SnapshotLazer>(cursor, header.lazerCount);
+	const SnapshotRocket* rocketRecords = section<SnapshotRocket>(cursor, header.rocketCount);
+	const SnapshotPowerUp* powerUpRecords = section<SnapshotPowerUp>(cursor, header.powerUpCount);
+	for (GLuint i = 0; i < header.unitCount; i++)
+		if (unitRecords[i].flowField != SNAPSHOT_NONE && unitRecords[i].flowField >= header.flowFieldCount)
+			return false;
+	for (GLuint i = 0; i < header.flockCount; i++)
+		if (uint64_t(flockRecords[i].firstMember) + flockRecords[i].memberCount > header.flockMemberCount)
+			return false;
+	// every id below nextUnitId is either a living unit's or free, once - anything else would
+	// have two units share selection and flock membership, or hand a live id out again
+	if (uint64_t(header.unitCount) + header.freeIdCount < header.nextUnitId)
+		return false;
+	vector<GLboolean> idTaken(header.nextUnitId, false);
+	for (uint64_t i = 0; i < uint64_t(header.unitCount) + header.freeIdCount; i++)
+	{
+		uint32_t id = i < header.unitCount ? unitRecords[i].id : freeIds[i - header.unitCount];
+		if (id >= header.nextUnitId || idTaken[id])
+		{
+			std::cout << "ERROR::SNAPSHOT: Snapshot has unit ids that are repeated or out of range" << std::endl;
+			return false;
+		}
+		idTaken[id] = true;
+	}
+
+	/// the world - the same game's is kept, with its hazards and power ups gone, as scrubbing
+	/// through a rewind reads a snapshot every tick. Any other is set up as for a new game
+	HazardHandler* hazards = Game::hazardHandler;
+	if (Game::gamestateInitialized && hazards && header.difficulty == static_cast<uint32_t>(Game::difficulty))
+	{
+		hazards->lazers.clear();
+		hazards->rockets.clear();
+		Game::powerUps.clear();
+	}
+	else
+	{
+		Game::clearGamestate();
+		Game::flocks.clear();
+		Game::difficulty = static_cast<Difficulty>(header.difficulty);
+		Game::InitWorld();
+		hazards = Game::hazardHandler;
+		hazards->init();
+	}
+	hazards->gameTime = header.hazardTime;
+	hazards->nextLazerTime = header.nextLazerTime;
+	hazards->nextRocketTime = header.nextRocketTime;
+	Game::random.state = header.randomState;
+	Game::gameTime = header.gameTime;
+	Game::gameScore = header.gameScore;
+	Game::powerUpSpawnTime = header.powerUpSpawnTime;
+	Game::stateHash = header.stateHash;
+
+	/// flow fields - one the units follow now is kept if it's the same as a saved one, rather than
+	/// working the whole field out again
+	vector<shared_ptr<FlowField> >& oldFields = scratch.oldFields;
+	vector<shared_ptr<FlowField> >& fields = scratch.newFields;
+	oldFields.clear();
+	for (GLuint i = 0; i < Game::units.size(); i++)
+		if (Game::units[i]->flowField && std::find(oldFields.begin(), oldFields.end(), Game::units[i]->flowField) == oldFields.end())
+			oldFields.push_back(Game::units[i]->flowField);
+	fields.assign(header.flowFieldCount, shared_ptr<FlowField>());
+	for (GLuint i = 0; i < header.flowFieldCount; i++)
+	{
+		glm::vec2 goal = glm::vec2(fieldRecords[i].goal[0], fieldRecords[i].goal[1]);
+		const uint32_t* fieldCosts = costs + i * header.flowFieldCells;
+		for (GLuint j = 0; j < oldFields.size() && !fields[i]; j++)
+		{
+			if (oldFields[j]->goal == goal && std::equal(oldFields[j]->cellCosts().begin(), oldFields[j]->cellCosts().end(), fieldCosts))
+			{
+				fields[i] = oldFields[j];
+				oldFields[j] = oldFields.back();
+				oldFields.pop_back();
+			}
+		}
+		if (!fields[i])
+		{
+			fields[i] = allocate_shared<FlowField>(TrackedAllocator<FlowField, MEMORY_FLOW_FIELDS>(), Game::Width, Game::Height);
+			fields[i]->restore(goal, fieldCosts);
+		}
+	}
+
+	/// units - the living ones with a saved unit's id are reused, the rest deleted, and the
+	/// saved ones without a living one made. The selection goes first, as it's kept by id
+	Selection::clear();
+	vector<Unit*>& unitsById = scratch.unitsById;
+	GLuint idCount = header.nextUnitId;
+	for (GLuint i = 0; i < Game::units.size(); i++)
+		idCount = std::max(idCount, Game::units[i]->id + 1);
+	unitsById.assign(idCount, NULL);
+	for (GLuint i = 0; i < Game::units.size(); i++)
+		unitsById[Game::units[i]->id] = Game::units[i];
+	Game::units.clear();
+	for (GLuint i = 0; i < header.unitCount; i++)
+	{
+		const SnapshotUnit& record = unitRecords[i];
+		glm::vec2 position = glm::vec2(record.position[0], record.position[1]);
+		glm::vec2 size = glm::vec2(record.size[0], record.size[1]);
+		Unit* unit = unitsById[record.id];
+		unitsById[record.id] = NULL;
+		if (unit)
+		{
+			unit->position = position;
+			unit->size = size;
+			unit->rotation = record.rotation;
+			unit->velocity = record.velocity;
+		}
+		else
+			unit = new Unit(position, size, ResourceManager::GetTexture("sheep"), glm::vec4(1.0f), true, record.rotation, record.velocity);
+		unit->id = record.id;
+		unit->prevPosition = glm::vec2(record.prevPosition[0], record.prevPosition[1]);
+		unit->destination = glm::vec2(record.destination[0], record.destination[1]);
+		unit->movementVector = glm::vec2(record.movementVector[0], record.movementVector[1]);
+		unit->steering = glm::vec2(record.steering[0], record.steering[1]);
+		unit->angle = record.angle;
+		unit->speedScale = record.speedScale;
+		unit->animation = SpriteAnimation(record.animationStart, record.animationFrames, record.animationFrameDuration,
+			static_cast<AnimationLoop>(record.animationLoop));
+		unit->moving = record.moving != 0;
+		if (record.flowField != SNAPSHOT_NONE)
+			unit->flowField = fields[record.flowField];
+		else
+			unit->flowField.reset();
+		Game::units.push_back(unit);
+	}
+	for (GLuint i = 0; i < unitsById.size(); i++)
+		delete unitsById[i];
+	// the units made took whatever ids were going, and were then given their old ones
+	scratch.freeIds.assign(freeIds, freeIds + header.freeIdCount);
+	Unit::restoreIds(header.nextUnitId, scratch.freeIds);
+	for (GLuint i = 0; i < header.unitCount; i++)
+		if (unitRecords[i].selected)
+			Game::units[i]->select();
+	// the fields are the units' to keep alive now
+	oldFields.clear();
+	fields.clear();
+	unitsById.assign(header.nextUnitId, NULL);
+	for (GLuint i = 0; i < Game::units.size(); i++)
+		unitsById[Game::units[i]->id] = Game::units[i];
+
+	Game::flocks.resize(header.flockCount, Flock(Game::Width, Game::Height));
+	for (GLuint i = 0; i < header.flockCount; i++)
+	{
+		const SnapshotFlock& record = flockRecords[i];
+		Flock& flock = Game::flocks[i];
+		flock.destination = glm::vec2(record.destination[0], record.destination[1]);
+		flock.position = glm::vec2(record.position[0], record.position[1]);
+		flock.angle = record.angle;
+		flock.minX = record.minX;
+		flock.minY = record.minY;
+		flock.maxX = record.maxX;
+		flock.maxY = record.maxY;
+		flock.units.clear();
+		for (GLuint j = record.firstMember; j < record.firstMember + record.memberCount; j++)
+			if (members[j] < unitsById.size() && unitsById[members[j]])
+				flock.units.push_back(unitsById[members[j]]);
+	}
+
+	/// hazards and power ups
+	for (GLuint i = 0; i < header.lazerCount; i++)
+	{
+		const SnapshotLazer& record = lazerRecords[i];
+		Transform transform = { glm::vec2(record.position[0], record.position[1]), glm::vec2(record.size[0], record.size[1]), record.rotation };
+		Sprite sprite = { hazards->lazerSprite, glm::vec4(1.0f) };
+		Animation animation = { glm::vec2(LAZER_FRAMES, 1), 0,
+			SpriteAnimation(record.animationStart, LAZER_FRAMES, LAZER_FRAME_DURATION, ANIMATION_LOOP) };
+		Timer timer = timerFromRecord(record.timer, record.duration, record.detonated != 0, header.hazardTime);
+		Blast blast = { hazards->lazerSPriteDetonated, record.detonated != 0 };
+		Beam beam = { glm::vec2(record.chunkSize[0], record.chunkSize[1]) };
+		hazards->lazers.create(transform, sprite, animation, timer, blast, beam);
+	}
+	for (GLuint i = 0; i < header.rocketCount; i++)
+	{
+		const SnapshotRocket& record = rocketRecords[i];
+		Transform transform = { glm::vec2(record.position[0], record.position[1]), glm::vec2(record.size[0], record.size[1]), record.rotation };
+		Sprite sprite = { hazards->rocketSprite, glm::vec4(1.0f) };
+		Timer timer = timerFromRecord(record.timer, record.duration, record.detonated != 0, header.hazardTime);
+		Blast blast = { hazards->rocketSpriteDetonated, record.detonated != 0 };
+		Mover mover = { glm::vec2(record.destination[0], record.destination[1]), record.velocity, record.angularVelocity,
+			NULL, hazards->rocketSpriteTarget };
+		if (record.target < unitsById.size())
+			mover.target = unitsById[record.target];
+		hazards->rockets.create(transform, sprite, timer, blast, mover);
+	}
+	for (GLuint i = 0; i < header.powerUpCount; i++)
+	{
+		const SnapshotPowerUp& record = powerUpRecords[i];
+		Transform transform = { glm::vec2(record.position[0], record.position[1]), glm::vec2(record.size[0], record.size[1]), 0.f };
+		Sprite sprite = { ResourceManager::GetTexture("Life"), glm::vec4(1.0f) };
+		Game::powerUps.create(transform, sprite);
+	}
+	hazards->reschedule();
+	Game::schedulePowerUps();
+
+	// sleep isn't saved - everyone starts out awake, and settles again within a second
+	Game::unitGrid->build(Game::units);
+	Game::collisionSolver->wakeAll(Game::units);
+	Game::gamestateInitialized = true;
+	return true;
+}
+
+void Snapshot::writeRewind(vector<unsigned char>& blob, vector<glm::vec2>& positions)
+{
+	size_t start = blob.size();
+	write(blob);
+	SnapshotHeader& header = *reinterpret_cast<SnapshotHeader*>(blob.data() + start);
+	SnapshotUnit* units = reinterpret_cast<SnapshotUnit*>(blob.data() + start + sizeof(SnapshotHeader));
+	positions.assign(header.nextUnitId, glm::vec2(0.f));
+	for (GLuint i = 0; i < header.unitCount; i++)
+	{
+		positions[units[i].id] = glm::vec2(units[i].position[0], units[i].position[1]);
+		memset(units[i].position, 0, sizeof(units[i].position));
+		memset(units[i].prevPosition, 0, sizeof(units[i].prevPosition));
+		memset(units[i].steering, 0, sizeof(units[i].steering));
+	}
+}
+
+GLboolean Snapshot::readRewind(vector<unsigned char>& blob, const vector<glm::vec2>& positions)
+{
+	if (blob.size() < sizeof(SnapshotHeader))
+		return false;
+	SnapshotHeader& header = *reinterpret_cast<SnapshotHeader*>(blob.data());
+	if (blob.size() < sizeof(SnapshotHeader) + uint64_t(header.unitCount) * sizeof(SnapshotUnit))
+		return false;
+	// units start the next tick where they are, and Steering works their steering out again
+	SnapshotUnit* units = reinterpret_cast<SnapshotUnit*>(blob.data() + sizeof(SnapshotHeader));
+	for (GLuint i = 0; i < header.unitCount; i++)
+	{
+		if (units[i].id >= positions.size())
+			return false;
+		copy2(units[i].position, positions[units[i].id]);
+		copy2(units[i].prevPosition, positions[units[i].id]);
+	}
+	if (!read(blob.data(), blob.size()))
+		return false;
+	// the positions are only as close as RewindBuffer keeps them, so the hash is of those
+	Game::stateHash = Game::hashState();
+	return true;
+}
+
+GLboolean Snapshot::save(const string& path)
+{
+	vector<unsigned char> blob;
+	write(blob);
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file)
+	{
+		std::cout << "ERROR::SNAPSHOT: Failed to write " << path << std::endl;
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(blob.data()), blob.size());
+	return file.good();
+}
+
+GLboolean Snapshot::load(const string& path)
+{
+	MappedFile file;
+	if (!file.open(path))
+	{
+		std::cout << "ERROR::SNAPSHOT: Failed to open " << path << std::endl;
+		return false;
+	}
+	return read(file.data, file.size);
+}
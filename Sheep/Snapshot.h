@@ -0,0 +1,103 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A snapshot is this header followed by flat arrays of the records below, in the order the
+// header counts them in: units, free unit ids, flow fields, flow field cell costs (cells per
+// field, one field after the other), flocks, flock members (unit ids), lazers, rockets and
+// power ups. Everything is 4 or 8 bytes wide, in the machine's own byte order, so the arrays can
+// be read in place out of a mapped file. Units are referred to by id, never by pointer
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_NONE = 0xFFFFFFFF; // no unit, or no flow field
+struct SnapshotHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t width, height; // of the world - a snapshot only loads into a world of the same size
+	uint32_t difficulty;
+	int32_t gameScore;
+	float gameTime, powerUpSpawnTime;
+	float hazardTime, nextLazerTime, nextRocketTime;
+	uint32_t reserved;
+	uint64_t randomState;
+	uint64_t stateHash; // Game::stateHash as of the tick the snapshot was taken after
+	uint32_t nextUnitId;
+	uint32_t unitCount, freeIdCount;
+	uint32_t flowFieldCount, flowFieldCells;
+	uint32_t flockCount, flockMemberCount;
+	uint32_t lazerCount, rocketCount, powerUpCount;
+};
+
+struct SnapshotUnit
+{
+	uint32_t id;
+	uint32_t flowField; // index among the snapshot's flow fields
+	float position[2], prevPosition[2], destination[2], movementVector[2], steering[2], size[2];
+	float velocity, angle, rotation, speedScale;
+	float animationStart, animationFrameDuration;
+	int32_t animationFrames, animationLoop;
+	uint32_t moving, selected;
+};
+
+struct SnapshotFlowField
+{
+	float goal[2];
+};
+
+struct SnapshotFlock
+{
+	float destination[2], position[2];
+	float angle, minX, minY, maxX, maxY;
+	uint32_t firstMember, memberCount; // range of the flock member array
+};
+
+struct SnapshotLazer
+{
+	float position[2], size[2], chunkSize[2];
+	float rotation, timer, duration, animationStart;
+	uint32_t detonated;
+};
+
+struct SnapshotRocket
+{
+	float position[2], destination[2], size[2];
+	float rotation, velocity, angularVelocity, timer, duration;
+	uint32_t detonated;
+	uint32_t target; // unit id
+};
+
+struct SnapshotPowerUp
+{
+	float position[2], size[2];
+	float timer;
+};
+
+// Saves and restores the whole game - units, flocks, hazards, power ups, timers and the random
+// number generator - as one flat binary blob. Forking a game is reading the same blob into as
+// many runs as needed. Both sides go straight at the game state, so they have to be called from
+// the simulation thread, or while it's held.
+class Snapshot
+{
+public:
+	// appends the game as it is now to blob
+	static void write(vector<unsigned char>& blob);
+	// replaces the game with the one in data - nothing is touched unless all of it checks out. The
+	// same game's units, flocks and flow fields are restored into, rather than made again
+	static GLboolean read(const unsigned char* data, size_t size);
+	// the same, for RewindBuffer - where each unit is goes in positions, by unit id, for the buffer
+	// to keep apart, and what the next tick works out again (prevPosition, steering) is left out
+	static void writeRewind(vector<unsigned char>& blob, vector<glm::vec2>& positions);
+	static GLboolean readRewind(vector<unsigned char>& blob, const vector<glm::vec2>& positions);
+	// the same, to and from files
+	static GLboolean save(const string& path);
+	static GLboolean load(const string& path);
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "StrictFloat.h"
+#include "SpatialGrid.h"
+
+SpatialGrid::SpatialGrid(GLfloat argWidth, GLfloat argHeight, GLfloat argCellSize)
+	: cellSize(argCellSize)
+{
+	columns = std::max(1, static_cast<GLint>(ceil(argWidth / cellSize)));
+	rows = std::max(1, static_cast<GLint>(ceil(argHeight / cellSize)));
+	cellStart.resize(columns * rows + 1);
+}
+
+void SpatialGrid::build(const vector<Unit*>& units, GLboolean swept)
+{
+	GLuint count = static_cast<GLuint>(units.size());
+	// count the units in each cell, shifted up one so the prefix sum gives each cell's start
+	std::fill(cellStart.begin(), cellStart.end(), 0);
+	unitCells.resize(count);
+	maxExtent = 0.f;
+	for (GLuint i = 0; i < count; i++)
+	{
+		unitCells[i] = row(units[i]->position.y) * columns + column(units[i]->position.x);
+		cellStart[unitCells[i] + 1]++;
+		glm::vec2 reach = units[i]->size / 2.f;
+		if (swept)
+			reach += glm::vec2(std::abs(units[i]->position.x - units[i]->prevPosition.x), std::abs(units[i]->position.y - units[i]->prevPosition.y));
+		maxExtent = std::max(maxExtent, std::max(reach.x, reach.y));
+	}
+	for (GLuint cell = 0; cell < columns * rows; cell++)
+		cellStart[cell + 1] += cellStart[cell];
+
+	cursor.assign(cellStart.begin(), cellStart.end() - 1);
+	entries.resize(count);
+	bounds.resize(count);
+	centers.resize(count);
+	for (GLuint i = 0; i < count; i++)
+	{
+		GLuint slot = cursor[unitCells[i]]++;
+		glm::vec2 halfSize = units[i]->size / 2.f;
+		glm::vec2 low = units[i]->position, high = units[i]->position;
+		if (swept)
+		{
+			low = glm::vec2(std::min(low.x, units[i]->prevPosition.x), std::min(low.y, units[i]->prevPosition.y));
+			high = glm::vec2(std::max(high.x, units[i]->prevPosition.x), std::max(high.y, units[i]->prevPosition.y));
+		}
+		entries[slot] = i;
+		bounds[slot] = glm::vec4(low - halfSize, high + halfSize);
+		centers[slot] = units[i]->position;
+	}
+}
+
+void SpatialGrid::query(glm::vec2 min, glm::vec2 max, vector<GLuint>& result) const
+{
+	result.clear();
+	// a unit overlapping the rectangle can have its center at most maxExtent outside of it
+	GLuint firstColumn = column(min.x - maxExtent), lastColumn = column(max.x + maxExtent);
+	GLuint firstRow = row(min.y - maxExtent), lastRow = row(max.y + maxExtent);
+	for (GLuint r = firstRow; r <= lastRow; r++)
+	{
+		for (GLuint c = firstColumn; c <= lastColumn; c++)
+		{
+			GLuint cell = r * columns + c;
+			for (GLuint slot = cellStart[cell]; slot < cellStart[cell + 1]; slot++)
+			{
+				const glm::vec4& box = bounds[slot];
+				if (box.z > min.x && box.x < max.x && box.w > min.y && box.y < max.y)
+					result.push_back(entries[slot]);
+			}
+		}
+	}
+}
+
+GLuint SpatialGrid::nearest(glm::vec2 position, GLfloat radius, GLuint k, GLuint exclude, GLuint* result, GLfloat* distances) const
+{
+	GLuint found = 0;
+	GLfloat radiusSquared = radius * radius;
+	GLuint firstColumn = column(position.x - radius), lastColumn = column(position.x + radius);
+	GLuint firstRow = row(position.y - radius), lastRow = row(position.y + radius);
+	for (GLuint r = firstRow; r <= lastRow; r++)
+	{
+		for (GLuint c = firstColumn; c <= lastColumn; c++)
+		{
+			GLuint cell = r * columns + c;
+			for (GLuint slot = cellStart[cell]; slot < cellStart[cell + 1]; slot++)
+			{
+				glm::vec2 offset = centers[slot] - position;
+				GLfloat distanceSquared = offset.x * offset.x + offset.y * offset.y;
+				if (distanceSquared > radiusSquared || entries[slot] == exclude)
+					continue;
+				// insertion into the sorted list - k is small, so this beats a heap
+				if (found == k && distanceSquared >= distances[k - 1])
+					continue;
+				GLuint i = found < k ? found++ : k - 1;
+				while (i > 0 && distances[i - 1] > distanceSquared)
+				{
+					distances[i] = distances[i - 1];
+					result[i] = result[i - 1];
+					i--;
+				}
+				distances[i] = distanceSquared;
+				result[i] = entries[slot];
+			}
+		}
+	}
+	for (GLuint i = 0; i < found; i++)
+		distances[i] = sqrt(distances[i]);
+	return found;
+}
+
+GLuint SpatialGrid::column(GLfloat x) const
+{
+	GLint c = static_cast<GLint>(floor(x / cellSize));
+	return static_cast<GLuint>(std::min(std::max(c, 0), static_cast<GLint>(columns) - 1));
+}
+
+GLuint SpatialGrid::row(GLfloat y) const
+{
+	GLint r = static_cast<GLint>(floor(y / cellSize));
+	return static_cast<GLuint>(std::min(std::max(r, 0), static_cast<GLint>(rows) - 1));
+}
@@ -0,0 +1,42 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Unit.h"
+
+// Uniform grid over the world that units are bucketed into by their center, for answering
+// "which units overlap this rectangle" without looking at every unit. It's rebuilt from scratch
+// with a counting sort rather than updated, so each cell's units sit next to each other in
+// memory. Units outside of the world go in the nearest edge cell.
+class SpatialGrid
+{
+public:
+	GLfloat cellSize;
+	GLuint columns, rows;
+
+	// constructors
+	SpatialGrid(GLfloat argWidth, GLfloat argHeight, GLfloat argCellSize);
+	// buckets the units - query results are indices into this same vector. Swept bounding boxes
+	// cover the whole way from prevPosition to position, for finding what a unit may have passed
+	void build(const vector<Unit*>& units, GLboolean swept = false);
+	// indices of the units whose bounding box overlaps the rectangle from min to max
+	void query(glm::vec2 min, glm::vec2 max, vector<GLuint>& result) const;
+	// indices of the (up to) k units whose centers are closest to position and within radius,
+	// leaving out the unit at index exclude - nearest first, with their distances. Returns how many
+	GLuint nearest(glm::vec2 position, GLfloat radius, GLuint k, GLuint exclude, GLuint* result, GLfloat* distances) const;
+private:
+	vector<GLuint> cellStart;  // cell c holds entries cellStart[c] up to cellStart[c + 1]
+	vector<GLuint> entries;	   // unit indices, grouped by cell
+	vector<glm::vec4> bounds;  // <vec2 min, vec2 max> of each entry's unit
+	vector<glm::vec2> centers; // position of each entry's unit
+	vector<GLuint> unitCells, cursor;
+	GLfloat maxExtent = 0.f;   // farthest any unit reaches out of its center
+
+	GLuint column(GLfloat x) const;
+	GLuint row(GLfloat y) const;
+};
+
+#endif
@@ -7,73 +7,78 @@
 ** option) any later version.
 ******************************************************************/
 #include "SpriteRenderer.h"
+#include "RenderQueue.h"
+#include "Memory.h"
+#include "ResourceManager.h"
 
 SpriteRenderer::SpriteRenderer()
+	: quadVAO(0), quadVBO(0), stream(nullptr), queue(nullptr)
 {
 
 }
 
-SpriteRenderer::SpriteRenderer(Shader &shader)
+SpriteRenderer::SpriteRenderer(Shader &shader, StreamBuffer *argStream)
 {
 	this->shader = shader;
+	this->stream = argStream;
+	this->queue = nullptr;
 	this->initRenderData();
 }
 
 SpriteRenderer::~SpriteRenderer()
 {
 	glDeleteVertexArrays(1, &this->quadVAO);
+	glDeleteBuffers(1, &this->quadVBO);
+	Memory::untrackGL(GL_OBJECT_VERTEX_ARRAY, this->quadVAO);
+	Memory::untrackGL(GL_OBJECT_BUFFER, this->quadVBO);
 }
 
-void SpriteRenderer::DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size, GLfloat rotate, glm::vec4 color)
+void SpriteRenderer::DrawSprite(TextureHandle texture, glm::vec2 position, glm::vec2 size, GLfloat rotate, glm::vec4 color)
 {
 	DrawSprite(texture, position, size, rotate, color, glm::vec2(1.0f, 1.0f), 0, false, false);
 }
 
-void SpriteRenderer::DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size, GLfloat rotate, glm::vec4 color,
-	glm::vec2 argSampleDimensions, GLint argSampleIndex, GLboolean flipXAxis, GLboolean flipYAxis)
+void SpriteRenderer::DrawSprite(TextureHandle texture, glm::vec2 position, glm::vec2 size, GLfloat rotate, glm::vec4 color,
+	glm::vec2 argSampleDimensions, GLint argSampleIndex, GLboolean flipXAxis, GLboolean flipYAxis,
+	const SpriteAnimation& argAnimation)
 {
-	// Prepare transformations
-	this->shader.Use();
-	glm::mat4 model;
-	model = glm::translate(model, glm::vec3(position, 0.0f));  // First translate (transformations are: scale happens first, then rotation and finally translation happens; reversed order)
-
-															   // model = glm::translate(model, glm::vec3(0.5f * size.x, 0.5f * size.y, 0.0f)); // Move origin of rotation to center of quad
-	model = glm::rotate(model, rotate, glm::vec3(0.0f, 0.0f, 1.0f)); // Then rotate
-																	 // model = glm::translate(model, glm::vec3(-0.5f * size.x, -0.5f * size.y, 0.0f)); // Move origin back
-
-	model = glm::scale(model, glm::vec3(size, 1.0f)); // Last scale
-
-	this->shader.SetMatrix4("model", model);
-
-	// Render textured quad
-	this->shader.SetVector4f("spriteColor", color);
-
-	// do math for the desired sample
-	glm::vec2 sampleDivider = argSampleDimensions; // dimensions by which we divide the picture
-	this->shader.SetVector2f("sampleDivider", sampleDivider); 
-	// I'm gonna pretend that I've turned the image into an array, and this portion will use
-	// math similar to pointer arithmetic to get the sample offset
-	glm::vec2 sampleOffset = glm::vec2((argSampleIndex % (int) sampleDivider.x) * 1.f, 
-										(argSampleIndex / (int) sampleDivider.y) * 1.f);
-	this->shader.SetVector2f("sampleOffset", sampleOffset);
-
-	// set the boolean values for flipping sample across vertical or horizontal axis
-	this->shader.SetBoolean("mirrorXAxis", flipXAxis);
-	this->shader.SetBoolean("mirrorYAxis", flipYAxis);
-
+	SpriteInstance instance;
+	instance.transform = glm::vec4(position, size);
+	instance.color = color;
+	// the dimensions by which we divide the picture, and the sample to start from - the
+	// shader works out which sample is showing from there
+	instance.sample = glm::vec4(argSampleDimensions, argSampleIndex * 1.f, 0.f);
+	// the rotation, plus the values for flipping sample across vertical or horizontal axis
+	instance.rotation = glm::vec4(rotate, flipXAxis ? 1.f : 0.f, flipYAxis ? 1.f : 0.f, 0.f);
+	instance.animation = glm::vec4(argAnimation.startTime, argAnimation.frameCount * 1.f,
+		argAnimation.frameDuration, argAnimation.loopMode * 1.f);
+	if (this->queue)
+	{
+		this->queue->submit(*this, texture, instance);
+		return;
+	}
+
+	// Write this sprite's instance data straight into the stream buffer
+	GLintptr offset;
+	SpriteInstance* mapped = static_cast<SpriteInstance*>(this->stream->map(sizeof(SpriteInstance), offset));
+	if (!mapped)
+		return;
+	*mapped = instance;
+	this->stream->unmap();
 
+	this->shader.Use();
 	glActiveTexture(GL_TEXTURE0);
-	texture.Bind();
+	ResourceManager::GetTexture(texture).Bind();
 
 	glBindVertexArray(this->quadVAO);
-	glDrawArrays(GL_TRIANGLES, 0, 6);
+	this->bindInstances(offset);
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 1);
 	glBindVertexArray(0);
 }
 
 void SpriteRenderer::initRenderData()
 {
 	// Configure VAO/VBO
-	GLuint VBO;
 	GLfloat vertices[] = {
 		// Pos      // Tex
 		-.5f, +.5f, 0.0f, 1.0f,
@@ -86,14 +91,32 @@ void SpriteRenderer::initRenderData()
 	};
 
 	glGenVertexArrays(1, &this->quadVAO);
-	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &this->quadVBO);
 
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	Memory::trackGL(GL_OBJECT_VERTEX_ARRAY, this->quadVAO, 0);
+	Memory::trackGL(GL_OBJECT_BUFFER, this->quadVBO, sizeof(vertices));
 
 	glBindVertexArray(this->quadVAO);
 	glEnableVertexAttribArray(0);
 	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)0);
+	// per-instance attributes - 1 through 5 each hold one vec4 of a SpriteInstance
+	for (GLuint attribute = 1; attribute <= SPRITE_INSTANCE_ATTRIBUTES; attribute++)
+	{
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
+}
+
+void SpriteRenderer::bindInstances(GLintptr offset)
+{
+	// expects the quad VAO to be bound - stream->map() leaves the stream buffer bound to GL_ARRAY_BUFFER
+	glBindBuffer(GL_ARRAY_BUFFER, this->stream->ID);
+	for (GLuint attribute = 1; attribute <= SPRITE_INSTANCE_ATTRIBUTES; attribute++)
+		glVertexAttribPointer(attribute, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance),
+			(GLvoid*)(offset + (attribute - 1) * sizeof(glm::vec4)));
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
@@ -15,28 +15,68 @@
 
 #include "texture2D.h"
 #include "shader.h"
+#include "StreamBuffer.h"
+#include "TextureHandle.h"
 
 #include <iostream>
 using namespace std;
 
+// How an animated sprite steps through its samples. The current frame is worked out in the
+// sprite shader from the global time uniform, so nothing has to touch the sprite while it plays
+enum AnimationLoop {
+	ANIMATION_LOOP = 0, // wraps back to the first frame
+	ANIMATION_ONCE = 1  // holds the last frame
+};
+
+struct SpriteAnimation
+{
+	GLfloat startTime;	   // time at which the first frame was shown
+	GLint frameCount;	   // a still sprite has just the one frame
+	GLfloat frameDuration; // seconds each frame is shown for
+	AnimationLoop loopMode;
+
+	SpriteAnimation()
+		: startTime(0.f), frameCount(1), frameDuration(1.f), loopMode(ANIMATION_LOOP) {}
+	SpriteAnimation(GLfloat argStartTime, GLint argFrameCount, GLfloat argFrameDuration, AnimationLoop argLoopMode)
+		: startTime(argStartTime), frameCount(argFrameCount), frameDuration(argFrameDuration), loopMode(argLoopMode) {}
+};
+
+// Per-sprite data, streamed to the GPU as instanced vertex attributes
+struct SpriteInstance
+{
+	glm::vec4 transform; // <vec2 position, vec2 size>
+	glm::vec4 color;
+	glm::vec4 sample;	 // <vec2 sampleDivider, first sample index, unused>
+	glm::vec4 rotation;	 // <rotation, mirrorXAxis, mirrorYAxis, unused>
+	glm::vec4 animation; // <startTime, frameCount, frameDuration, loopMode>
+};
+
+class RenderQueue;
+
+const GLuint SPRITE_INSTANCE_ATTRIBUTES = sizeof(SpriteInstance) / sizeof(glm::vec4);
 
 class SpriteRenderer
 {
 public:
 	// Constructor (inits shaders/shapes)
 	SpriteRenderer();
-	SpriteRenderer(Shader &shaderglm);
+	SpriteRenderer(Shader &shaderglm, StreamBuffer *argStream);
 	// Destructor
 	~SpriteRenderer();
 	// Renders a defined quad textured with given sprite
-	void DrawSprite(Texture2D &texture, glm::vec2 position, glm::vec2 size = glm::vec2(10, 10), GLfloat rotate = 0.0f, glm::vec4 color = glm::vec4(1.0f));
-	void DrawSprite(Texture2D & texture, glm::vec2 position, glm::vec2 size, GLfloat rotate, glm::vec4 color,
-		glm::vec2 argSampleDimensions, GLint argSampleIndex, GLboolean flipXAxis, GLboolean flipYAxis);
+	void DrawSprite(TextureHandle texture, glm::vec2 position, glm::vec2 size = glm::vec2(10, 10), GLfloat rotate = 0.0f, glm::vec4 color = glm::vec4(1.0f));
+	void DrawSprite(TextureHandle texture, glm::vec2 position, glm::vec2 size, GLfloat rotate, glm::vec4 color,
+		glm::vec2 argSampleDimensions, GLint argSampleIndex, GLboolean flipXAxis, GLboolean flipYAxis,
+		const SpriteAnimation& argAnimation = SpriteAnimation());
 	// Render state
 	Shader shader;
-	GLuint quadVAO;
+	GLuint quadVAO, quadVBO;
+	StreamBuffer *stream; // per-frame instance data is sub-allocated from here
+	RenderQueue *queue;	  // when set, sprites are queued up here instead of being drawn right away
 	// Initializes and configures the quad's buffer and vertex attributes
 	void initRenderData();
+	// Points the per-instance attributes at instance data starting at offset in the stream buffer
+	void bindInstances(GLintptr offset);
 };
 
 #endif
@@ -0,0 +1,79 @@
+#include "StrictFloat.h"
+#include "Steering.h"
+
+#include <algorithm>
+
+void Steering::update(const vector<Unit*>& units, const SpatialGrid& grid)
+{
+	GLuint count = static_cast<GLuint>(units.size());
+	positionX.resize(count); positionY.resize(count);
+	headingX.resize(count); headingY.resize(count);
+	speed.resize(count); moving.resize(count); toGoal.resize(count);
+	separationX.assign(count, 0.f); separationY.assign(count, 0.f);
+	alignmentX.assign(count, 0.f); alignmentY.assign(count, 0.f); aligned.assign(count, 0.f);
+	steeringX.resize(count); steeringY.resize(count); speedScale.resize(count);
+
+	// gather - movementVector is y up, while positions are y down
+	for (GLuint i = 0; i < count; i++)
+	{
+		const Unit* unit = units[i];
+		positionX[i] = unit->position.x;
+		positionY[i] = unit->position.y;
+		headingX[i] = unit->movementVector.x;
+		headingY[i] = -unit->movementVector.y;
+		speed[i] = unit->velocity;
+		moving[i] = unit->moving ? 1.f : 0.f;
+		glm::vec2 offset = unit->destination - unit->position;
+		toGoal[i] = sqrt(offset.x * offset.x + offset.y * offset.y);
+	}
+
+	// neighbors - only moving units steer, but they steer around everyone
+	GLuint found[STEERING_MAX_NEIGHBORS];
+	GLfloat distances[STEERING_MAX_NEIGHBORS];
+	GLuint k = std::min(neighbors, STEERING_MAX_NEIGHBORS);
+	for (GLuint i = 0; i < count; i++)
+	{
+		if (moving[i] == 0.f)
+			continue;
+		GLuint n = grid.nearest(glm::vec2(positionX[i], positionY[i]), neighborRadius, k, i, found, distances);
+		for (GLuint j = 0; j < n; j++)
+		{
+			GLuint other = found[j];
+			GLfloat distance = std::max(distances[j], .001f);
+			GLfloat push = std::max(0.f, 1.f - distance / separationRadius);
+			separationX[i] += (positionX[i] - positionX[other]) / distance * push;
+			separationY[i] += (positionY[i] - positionY[other]) / distance * push;
+			alignmentX[i] += headingX[other] * moving[other];
+			alignmentY[i] += headingY[other] * moving[other];
+			aligned[i] += moving[other];
+		}
+	}
+
+	// combine - no branches, so this vectorizes
+	for (GLuint i = 0; i < count; i++)
+	{
+		GLfloat alignedCount = std::max(aligned[i], 1.f);
+		GLfloat hasAligned = std::min(aligned[i], 1.f);
+		GLfloat alignX = (alignmentX[i] / alignedCount - headingX[i]) * hasAligned;
+		GLfloat alignY = (alignmentY[i] / alignedCount - headingY[i]) * hasAligned;
+		steeringX[i] = (separationX[i] * separationWeight + alignX * alignmentWeight) * speed[i] * moving[i];
+		steeringY[i] = (separationY[i] * separationWeight + alignY * alignmentWeight) * speed[i] * moving[i];
+		speedScale[i] = std::min(1.f, std::max(minArrivalSpeed, toGoal[i] / arrivalRadius));
+	}
+
+	// scatter
+	for (GLuint i = 0; i < count; i++)
+	{
+		units[i]->steering = glm::vec2(steeringX[i], steeringY[i]);
+		units[i]->speedScale = speedScale[i];
+	}
+}
+
+void Steering::reset(const vector<Unit*>& units)
+{
+	for (GLuint i = 0; i < units.size(); i++)
+	{
+		units[i]->steering = glm::vec2(0.f);
+		units[i]->speedScale = 1.f;
+	}
+}
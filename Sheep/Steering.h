@@ -0,0 +1,43 @@
+#ifndef STEERING_H
+#define STEERING_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Unit.h"
+#include "SpatialGrid.h"
+
+// most neighbors a unit steers by
+const GLuint STEERING_MAX_NEIGHBORS = 8;
+
+// Boids-style local steering, so moving units give each other room before they overlap rather
+// than getting pushed apart after. Each moving unit looks at its nearest few neighbors and gets
+//  - separation: pushed away from neighbors closer than separationRadius, harder the closer
+//  - alignment: turned toward the average heading of its moving neighbors
+//  - arrival: slowed down within arrivalRadius of its destination
+// The result goes into Unit::steering and Unit::speedScale, which move() applies. The units are
+// gathered into flat arrays first, so the math runs as tight loops over all of them at once.
+class Steering
+{
+public:
+	GLuint neighbors = 6;
+	GLfloat neighborRadius = 100.f;
+	GLfloat separationRadius = 60.f;
+	GLfloat separationWeight = 1.f;
+	GLfloat alignmentWeight = .3f;
+	GLfloat arrivalRadius = 50.f;
+	GLfloat minArrivalSpeed = .25f; // fraction of full speed that arriving units slow down to
+
+	// grid has to have been built from units
+	void update(const vector<Unit*>& units, const SpatialGrid& grid);
+	// takes all steering back off of the units
+	static void reset(const vector<Unit*>& units);
+private:
+	// one entry per unit
+	vector<GLfloat> positionX, positionY, headingX, headingY, speed, moving, toGoal;
+	vector<GLfloat> separationX, separationY, alignmentX, alignmentY, aligned;
+	vector<GLfloat> steeringX, steeringY, speedScale;
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "StreamBuffer.h"
+#include "Memory.h"
+
+#include <iostream>
+
+StreamBuffer::StreamBuffer(GLsizeiptr argCapacity)
+	: capacity(argCapacity), persistent(GLEW_ARB_buffer_storage)
+{
+	glGenBuffers(1, &ID);
+	glBindBuffer(GL_ARRAY_BUFFER, ID);
+	if (persistent)
+	{
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_ARRAY_BUFFER, capacity, NULL, flags);
+		mapped = static_cast<GLubyte*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, capacity, flags));
+		if (!mapped)
+		{
+			// storage is immutable now, so start over with a buffer that can be orphaned
+			std::cout << "ERROR::STREAM_BUFFER: Persistent mapping failed, falling back to orphaning" << std::endl;
+			glDeleteBuffers(1, &ID);
+			glGenBuffers(1, &ID);
+			glBindBuffer(GL_ARRAY_BUFFER, ID);
+			persistent = false;
+		}
+	}
+	if (!persistent)
+		glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	Memory::trackGL(GL_OBJECT_BUFFER, ID, capacity);
+}
+
+StreamBuffer::~StreamBuffer()
+{
+	for (GLuint i = 0; i < STREAM_BUFFER_FRAMES; i++)
+		if (fences[i])
+			glDeleteSync(fences[i]);
+	if (mapped)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, ID);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	glDeleteBuffers(1, &ID);
+	Memory::untrackGL(GL_OBJECT_BUFFER, ID);
+}
+
+void* StreamBuffer::map(GLsizeiptr size, GLintptr& offset, GLsizeiptr alignment)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, ID);
+	GLintptr aligned = (head + alignment - 1) / alignment * alignment;
+	if (persistent)
+	{
+		// each frame writes only into its own region of the ring
+		GLintptr regionStart = frame * frameSize();
+		if (size > frameSize())
+			return nullptr;
+		if (aligned + size > regionStart + frameSize())
+		{
+			// this frame ran out of room - let the GPU catch up on what's been drawn so far and
+			// reuse the region from the start
+			GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			waitFor(fence);
+			aligned = regionStart;
+		}
+		head = aligned + size;
+		offset = aligned;
+		return mapped + aligned;
+	}
+
+	if (size > capacity)
+		return nullptr;
+	if (aligned + size > capacity)
+	{
+		// orphan the storage - the driver keeps the old block alive for draws still in flight
+		glBufferData(GL_ARRAY_BUFFER, capacity, NULL, GL_STREAM_DRAW);
+		aligned = 0;
+	}
+	head = aligned + size;
+	offset = aligned;
+	return glMapBufferRange(GL_ARRAY_BUFFER, aligned, size,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void StreamBuffer::unmap()
+{
+	// the persistent mapping is coherent, so writes are visible to the next draw as is
+	if (!persistent)
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+void StreamBuffer::endFrame()
+{
+	if (!persistent)
+		return;
+	if (fences[frame])
+		glDeleteSync(fences[frame]);
+	fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	frame = (frame + 1) % STREAM_BUFFER_FRAMES;
+	// the region we're moving into was last written STREAM_BUFFER_FRAMES frames ago
+	waitFor(fences[frame]);
+	head = frame * frameSize();
+}
+
+void StreamBuffer::waitFor(GLsync& fence)
+{
+	if (!fence)
+		return;
+	GLbitfield flags = 0;
+	GLuint64 timeout = 0;
+	while (true)
+	{
+		GLenum result = glClientWaitSync(fence, flags, timeout);
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+			break;
+		// flush on the second attempt so the fence is guaranteed to get to the GPU
+		flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		timeout = 1000000; // 1ms
+	}
+	glDeleteSync(fence);
+	fence = 0;
+}
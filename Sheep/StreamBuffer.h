@@ -0,0 +1,44 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <GL/glew.h>
+
+// Number of frames the GPU is allowed to lag behind the CPU before a write into the ring waits
+const GLuint STREAM_BUFFER_FRAMES = 3;
+
+// Ring buffer that per-frame vertex and instance data is sub-allocated from. Where
+// ARB_buffer_storage is available the buffer is persistently mapped and each frame's
+// region is guarded by a fence, so writes never make the driver sync implicitly. Elsewhere
+// each allocation is an unsynchronized map of fresh space, and the buffer is orphaned
+// when the ring wraps around.
+class StreamBuffer
+{
+public:
+	GLuint ID;
+	GLsizeiptr capacity;
+	GLboolean persistent;
+
+	// constructors
+	StreamBuffer(GLsizeiptr argCapacity);
+	~StreamBuffer();
+	// allocation - the returned pointer is writable until unmap(), and offset is where
+	// the data starts in the buffer object, for use with glVertexAttribPointer
+	void* map(GLsizeiptr size, GLintptr& offset, GLsizeiptr alignment = 16);
+	void unmap();
+	// frame pacing - fences off everything written this frame and moves on to the next region
+	void endFrame();
+	// largest single allocation that map() will hand out
+	GLsizeiptr maxAllocation() const { return persistent ? frameSize() : capacity; }
+private:
+	GLubyte* mapped = nullptr; // base of the persistent mapping
+	GLintptr head = 0;		   // next free byte
+	GLuint frame = 0;
+	GLsync fences[STREAM_BUFFER_FRAMES] = {};
+	StreamBuffer(const StreamBuffer&);
+	StreamBuffer& operator=(const StreamBuffer&);
+
+	GLsizeiptr frameSize() const { return capacity / STREAM_BUFFER_FRAMES; }
+	void waitFor(GLsync& fence);
+};
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef STRICT_FLOAT_H
+#define STRICT_FLOAT_H
+
+#include <float.h>
+
+// Included first by every file the simulation does float math in, ahead of any header with inline
+// math of its own, so a game comes out the same from every build. That's float math done op for
+// op in single precision: no fused multiply-adds, which compilers otherwise make wherever the
+// instruction set has them and which round differently than the multiply and add they replace,
+// and no fast-math, which reorders and approximates as it pleases. Fixed point builds still run
+// the collision solver, steering, swept tests and flow fields in float, so this is what keeps
+// those replaying the same too. Tools/StateHash checks two builds against each other.
+#if defined(__FAST_MATH__) || defined(_M_FP_FAST)
+#error "the simulation can't be built with fast-math - it would round differently from build to build"
+#endif
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+#error "the simulation has to keep floats in single precision - on 32 bit x86, build with -msse2 -mfpmath=sse"
+#endif
+
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#elif defined(_MSC_VER)
+#pragma fp_contract(off)
+#endif
+
+#endif
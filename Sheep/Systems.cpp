@@ -0,0 +1,97 @@
+#include "StrictFloat.h"
+#include "Systems.h"
+#include "Fixed.h"
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif //_USE_MATH_DEFINES
+#include <math.h>
+
+// how close a rocket has to get to its destination to go off
+const GLfloat ROCKET_DETONATION_DISTANCE = 25.f;
+
+void rocketsArrived(const Transform* transforms, const Mover* movers, const Blast* blasts, GLuint count, vector<GLuint>& arrived)
+{
+	arrived.clear();
+	for (GLuint i = 0; i < count; i++)
+	{
+		if (blasts[i].detonated)
+			continue;
+		glm::vec2 position = transforms[i].position, destination = movers[i].destination;
+		if (simLength(toScalar(position.x) - toScalar(destination.x), toScalar(position.y) - toScalar(destination.y))
+			< toScalar(ROCKET_DETONATION_DISTANCE))
+			arrived.push_back(i);
+	}
+}
+
+void followTargets(Mover* movers, GLuint count)
+{
+	for (GLuint i = 0; i < count; i++)
+		if (movers[i].target)
+			movers[i].destination = movers[i].target->position;
+}
+
+void drawSprites(SpriteRenderer& renderer, const Transform* transforms, const Sprite* sprites, GLuint count)
+{
+	for (GLuint i = 0; i < count; i++)
+		renderer.DrawSprite(sprites[i].texture, transforms[i].position, transforms[i].size, transforms[i].rotation, sprites[i].color);
+}
+
+void drawLazers(SpriteRenderer& renderer, const Transform* transforms, const Sprite* sprites, const Animation* animations,
+	const Blast* blasts, const Beam* beams, GLuint count, GLfloat worldWidth, GLfloat worldHeight)
+{
+	for (GLuint i = 0; i < count; i++)
+	{
+		glm::vec2 position = transforms[i].position, chunkSize = beams[i].chunkSize;
+		GLfloat rotation = transforms[i].rotation;
+		TextureHandle texture = blasts[i].detonated ? blasts[i].texture : sprites[i].texture;
+		GLfloat sine, cosine;
+		fastSinCos(rotation, sine, cosine);
+		// check if the line will intersect with the x-axis
+		// if it doesn't intersect with the X-axis, then it must intersect with the y-axis
+		GLboolean bXAxis = abs(fastAtan2(position.y, position.x)) < abs(rotation);
+		glm::vec2 farPoint;
+		GLfloat hypotenuse;
+		if (bXAxis)
+		{
+			if (rotation != M_PI / 2 && rotation != -M_PI / 2)
+			{
+				hypotenuse = (worldWidth - position.x) / cosine;
+				farPoint = glm::vec2(worldWidth, position.y + hypotenuse * sine);
+			}
+			else farPoint = glm::vec2(worldWidth, position.y);
+		}
+		else
+		{
+			if (rotation != 0 && rotation != -M_PI && rotation != M_PI)
+			{
+				hypotenuse = (worldHeight - position.y) / sine;
+				farPoint = glm::vec2(position.x + hypotenuse * cosine, worldHeight);
+			}
+			else farPoint = glm::vec2(position.x, worldHeight);
+		}
+		while (farPoint.x > -chunkSize.x && farPoint.y > -chunkSize.y)
+		{
+			renderer.DrawSprite(texture, farPoint, chunkSize, rotation, sprites[i].color,
+				animations[i].sampleDimensions, animations[i].sampleFrame, false, false, animations[i].animation);
+			farPoint -= glm::vec2(chunkSize.x * cosine, chunkSize.x * sine);
+		}
+	}
+}
+
+void drawRockets(SpriteRenderer& renderer, const Transform* transforms, const Sprite* sprites, const Blast* blasts,
+	const Mover* movers, GLuint count)
+{
+	for (GLuint i = 0; i < count; i++)
+	{
+		const Transform& transform = transforms[i];
+		// if not detonated, draw the rocket and draw the lazer on the target
+		if (!blasts[i].detonated)
+		{
+			renderer.DrawSprite(sprites[i].texture, transform.position, transform.size, -transform.rotation, sprites[i].color);
+			renderer.DrawSprite(movers[i].targetTexture, movers[i].destination, transform.size, 0, sprites[i].color);
+		}
+		else
+			renderer.DrawSprite(blasts[i].texture, transform.position, transform.size, 0, sprites[i].color);
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef SYSTEMS_H
+#define SYSTEMS_H
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+#include "Components.h"
+#include "SpriteRenderer.h"
+#include "Unit.h"
+
+using namespace std;
+
+// Systems - each runs down the packed component arrays of count entities, as handed out by
+// Archetype::column(). None of them add or remove entities; they leave that to whoever owns
+// the archetype, once they're done
+
+/// movement
+// points destinations at targets - targets are cleared when they die, so they're all alive
+void followTargets(Mover* movers, GLuint count);
+// homing itself, and the hits of detonated hazards, are batched in HazardKernels
+// the slots of the rockets that haven't gone off, but are close enough to their destination to
+// go off - their fuses going out is up to the timers
+void rocketsArrived(const Transform* transforms, const Mover* movers, const Blast* blasts, GLuint count, vector<GLuint>& arrived);
+
+/// rendering
+void drawSprites(SpriteRenderer& renderer, const Transform* transforms, const Sprite* sprites, GLuint count);
+void drawLazers(SpriteRenderer& renderer, const Transform* transforms, const Sprite* sprites, const Animation* animations,
+	const Blast* blasts, const Beam* beams, GLuint count, GLfloat worldWidth, GLfloat worldHeight);
+void drawRockets(SpriteRenderer& renderer, const Transform* transforms, const Sprite* sprites, const Blast* blasts,
+	const Mover* movers, GLuint count);
+
+#endif
@@ -0,0 +1,109 @@
+#include "Telemetry.h"
+
+#include <chrono>
+#include <iostream>
+#include <string.h>
+
+static const char TELEMETRY_MAGIC[4] = { 'S', 'H', 'T', 'L' };
+
+TelemetryRecord Telemetry::current;
+FILE* Telemetry::file = nullptr;
+TelemetryRecord Telemetry::blocks[2][TELEMETRY_BUFFER_RECORDS];
+uint32_t Telemetry::filling = 0;
+uint32_t Telemetry::buffered = 0;
+uint32_t Telemetry::nextTick = 0;
+std::thread Telemetry::writer;
+std::mutex Telemetry::mutex;
+std::condition_variable Telemetry::wake;
+uint32_t Telemetry::handedBlock = 0;
+std::atomic<uint32_t> Telemetry::handedRecords(0);
+bool Telemetry::quit = false;
+
+bool Telemetry::open(const std::string& path)
+{
+	close();
+	file = fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		std::cout << "ERROR::TELEMETRY: Failed to open " << path << std::endl;
+		return false;
+	}
+	// records are buffered here already
+	setvbuf(file, NULL, _IONBF, 0);
+	TelemetryHeader header;
+	memcpy(header.magic, TELEMETRY_MAGIC, sizeof(header.magic));
+	header.version = TELEMETRY_VERSION;
+	header.recordSize = sizeof(TelemetryRecord);
+	header.reserved = 0;
+	fwrite(&header, sizeof(header), 1, file);
+	nextTick = 0;
+	quit = false;
+	writer = std::thread(&Telemetry::write);
+	return true;
+}
+
+void Telemetry::close()
+{
+	if (!file)
+		return;
+	handOff();
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wake.notify_one();
+	writer.join();
+	fclose(file);
+	file = nullptr;
+}
+
+void Telemetry::commit()
+{
+	if (file)
+	{
+		current.tick = nextTick++;
+		blocks[filling][buffered++] = current;
+		if (buffered == TELEMETRY_BUFFER_RECORDS)
+			handOff();
+	}
+	memset(&current, 0, sizeof(current));
+}
+
+void Telemetry::handOff()
+{
+	if (buffered == 0)
+		return;
+	// only if the writer's still on the last block, 256 ticks on - ticking faster than the game does
+	if (handedRecords.load(std::memory_order_acquire))
+	{
+		wake.notify_one();
+		while (handedRecords.load(std::memory_order_acquire))
+			std::this_thread::yield();
+	}
+	handedBlock = filling;
+	handedRecords.store(buffered, std::memory_order_release);
+	filling ^= 1;
+	buffered = 0;
+}
+
+void Telemetry::write()
+{
+	while (true)
+	{
+		bool quitting;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait_for(lock, std::chrono::milliseconds(TELEMETRY_WRITE_INTERVAL),
+				[] { return quit || handedRecords.load(std::memory_order_acquire) > 0; });
+			quitting = quit;
+		}
+		// whatever's been handed over is written out before quitting
+		if (uint32_t records = handedRecords.load(std::memory_order_acquire))
+		{
+			fwrite(blocks[handedBlock], sizeof(TelemetryRecord), records, file);
+			handedRecords.store(0, std::memory_order_release);
+		}
+		if (quitting)
+			return;
+	}
+}
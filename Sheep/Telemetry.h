@@ -0,0 +1,71 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <thread>
+
+// A telemetry file is this header followed by one record per tick, back to back, in the
+// machine's own byte order. Tools/TelemetryToCsv.cpp turns one into a spreadsheet
+const uint32_t TELEMETRY_VERSION = 1;
+struct TelemetryHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t recordSize;
+	uint32_t reserved;
+};
+
+struct TelemetryRecord
+{
+	uint32_t tick;			// counted since the file was opened, across games
+	float gameTime;
+	float tickDuration;		// seconds the simulation spent on the tick
+	uint32_t units, movingUnits;
+	uint32_t lazers, rockets, powerUps;
+	uint32_t kills;
+	uint32_t pairEvaluations; // overlap tests done by the collision solver
+	uint64_t stateHash;
+};
+
+// records kept in memory before they're written out together
+const uint32_t TELEMETRY_BUFFER_RECORDS = 256;
+// how often the writer checks for a full block, in milliseconds - a block lasts 256 ticks
+const uint32_t TELEMETRY_WRITE_INTERVAL = 250;
+
+// Per-tick metrics, streamed to a file. The simulation fills in current as it goes through a
+// tick and commit()s it at the end. Records collect in one of two fixed blocks, and a full one is
+// handed to a writer thread of its own while the other fills up - so a tick costs a copy of 48
+// bytes and at most an atomic store, and it never waits on the disk, or on waking the writer up,
+// which just checks on its own every so often. It's only woken if the last block's still waiting
+// by the time the next one's full. It can stay on all the time. Without an open file, commit()
+// just starts the next record.
+class Telemetry
+{
+public:
+	static TelemetryRecord current;
+
+	static bool open(const std::string& path);
+	static void close();
+	static void commit();
+private:
+	static FILE* file;
+	static TelemetryRecord blocks[2][TELEMETRY_BUFFER_RECORDS];
+	static uint32_t filling, buffered, nextTick; // the block being filled, and how much of it is
+	// the block handed to the writer, and how much of it - 0 once it's written
+	static uint32_t handedBlock;
+	static std::atomic<uint32_t> handedRecords;
+	static std::thread writer;
+	static std::mutex mutex;
+	static std::condition_variable wake;
+	static bool quit;
+
+	static void handOff();
+	static void write();
+};
+
+#endif
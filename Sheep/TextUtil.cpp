@@ -1,11 +1,15 @@
 #include "TextUtil.h"
 
+#include <string.h>
+
 GLuint TextUtil::VAO;
-GLuint TextUtil::VBO;
-std::map<GLchar, Character> TextUtil::Characters;
+StreamBuffer* TextUtil::stream;
+std::map<GLchar, Character, std::less<GLchar>, TrackedAllocator<std::pair<const GLchar, Character>, MEMORY_GLYPHS> > TextUtil::Characters;
 
-void TextUtil::init()
+void TextUtil::init(StreamBuffer* argStream)
 {
+	stream = argStream;
+
 	// set up text rendering
 	FT_Library ft;
 	if (FT_Init_FreeType(&ft))
@@ -46,6 +50,7 @@ void TextUtil::init()
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		Memory::trackGL(GL_OBJECT_TEXTURE, texture, face->glyph->bitmap.width * face->glyph->bitmap.rows);
 		// Now store character for later use
 		Character character = {
 			texture,
@@ -60,39 +65,34 @@ void TextUtil::init()
 	FT_Done_Face(face);
 	FT_Done_FreeType(ft);
 
-	// Configure VAO/VBO for texture quads
+	// Configure VAO for texture quads - the vertices themselves are streamed in RenderText
 	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBO);
+	Memory::trackGL(GL_OBJECT_VERTEX_ARRAY, VAO, 0);
 	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER, VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
 	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindVertexArray(0);
 }
 
-void TextUtil::RenderText(Shader & shader, std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec4 color)
+void TextUtil::RenderText(Shader & shader, const std::string& text, GLfloat x, GLfloat y, GLfloat scale, glm::vec4 color)
 {
-	// Activate corresponding render state	
-	shader.Use();
-	glUniform4f(glGetUniformLocation(shader.ID, "textColor"), color.x, color.y, color.z, color.a);
-	glActiveTexture(GL_TEXTURE0);
-	glBindVertexArray(VAO);
-
-	// Iterate through all characters
-	std::string::const_iterator c;
-	for (c = text.begin(); c != text.end(); c++)
+	if (text.empty())
+		return;
+	// Write the quads of the whole string into the stream buffer up front, rather than
+	// updating a buffer between the draws of each glyph
+	GLintptr offset;
+	GLfloat (*vertices)[6][4] = static_cast<GLfloat(*)[6][4]>(stream->map(sizeof(GLfloat) * 6 * 4 * text.size(), offset));
+	if (!vertices)
+		return;
+	for (unsigned int i = 0; i < text.size(); i++)
 	{
-		Character ch = Characters[*c];
+		Character ch = Characters[text[i]];
 
 		GLfloat xpos = x + ch.Bearing.x * scale;
 		GLfloat ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
 
 		GLfloat w = ch.Size.x * scale;
 		GLfloat h = ch.Size.y * scale;
-		// Update VBO for each character
-		GLfloat vertices[6][4] = {
+		GLfloat quad[6][4] = {
 			{ xpos,     ypos + h,   0.0, 0.0 },
 			{ xpos,     ypos,       0.0, 1.0 },
 			{ xpos + w, ypos,       1.0, 1.0 },
@@ -101,18 +101,27 @@ void TextUtil::RenderText(Shader & shader, std::string text, GLfloat x, GLfloat
 			{ xpos + w, ypos,       1.0, 1.0 },
 			{ xpos + w, ypos + h,   1.0, 0.0 }
 		};
-		// Render glyph texture over quad
-		glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-		// Update content of VBO memory
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // Be sure to use glBufferSubData and not glBufferData
-
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		// Render quad
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		memcpy(vertices[i], quad, sizeof(quad));
 		// Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
 		x += (ch.Advance >> 6) * scale; // Bitshift by 6 to get value in pixels (2^6 = 64 (divide amount of 1/64th pixels by 64 to get amount of pixels))
 	}
+	stream->unmap();
+
+	// Activate corresponding render state	
+	shader.Use();
+	glUniform4f(glGetUniformLocation(shader.ID, "textColor"), color.x, color.y, color.z, color.a);
+	glActiveTexture(GL_TEXTURE0);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, stream->ID);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)offset);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// Render each glyph texture over its quad
+	for (unsigned int i = 0; i < text.size(); i++)
+	{
+		glBindTexture(GL_TEXTURE_2D, Characters[text[i]].TextureID);
+		glDrawArrays(GL_TRIANGLES, 6 * i, 6);
+	}
 	glBindVertexArray(0);
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
@@ -18,6 +18,8 @@
 #include <glm/gtc/type_ptr.hpp>
 // GL includes
 #include "Shader.h"
+#include "StreamBuffer.h"
+#include "Memory.h"
 
 /// Holds all state information relevant to a character as loaded using FreeType
 struct Character {
@@ -30,12 +32,13 @@ struct Character {
 class TextUtil
 {
 public:
-	static GLuint VAO, VBO;
-	static std::map<GLchar, Character> Characters;
+	static GLuint VAO;
+	static StreamBuffer* stream; // glyph quads are sub-allocated from here each frame
+	static std::map<GLchar, Character, std::less<GLchar>, TrackedAllocator<std::pair<const GLchar, Character>, MEMORY_GLYPHS> > Characters;
 
-	static void init();
+	static void init(StreamBuffer* argStream);
 
-	static void RenderText(Shader &shader, std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec4 color);
+	static void RenderText(Shader &shader, const std::string& text, GLfloat x, GLfloat y, GLfloat scale, glm::vec4 color);
 };
 
 #endif
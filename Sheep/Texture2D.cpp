@@ -9,21 +9,43 @@
 #include <iostream>
 
 #include "texture2D.h"
+#include "Memory.h"
 
 
 Texture2D::Texture2D()
-	: Width(0), Height(0), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_S(GL_REPEAT), Wrap_T(GL_REPEAT), Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR)
+	: ID(0), Width(0), Height(0), Internal_Format(GL_RGB), Image_Format(GL_RGB), Wrap_S(GL_REPEAT), Wrap_T(GL_REPEAT), Filter_Min(GL_LINEAR), Filter_Max(GL_LINEAR)
 {
-	glGenTextures(1, &this->ID);
+	// the texture object is only created once there's an image for it, so textures can be
+	// default constructed (every Drawable does) away from the GL thread
 }
 
-void Texture2D::Generate(GLuint width, GLuint height, unsigned char* data)
+void Texture2D::Generate(GLuint width, GLuint height, const unsigned char* data, GLuint mipLevels)
 {
 	this->Width = width;
 	this->Height = height;
 	// Create Texture
+	if (!this->ID)
+		glGenTextures(1, &this->ID);
 	glBindTexture(GL_TEXTURE_2D, this->ID);
-	glTexImage2D(GL_TEXTURE_2D, 0, this->Internal_Format, width, height, 0, this->Image_Format, GL_UNSIGNED_BYTE, data);
+	// rows are tightly packed, RGB images don't have to be 4-byte aligned - only for these uploads
+	GLint alignment;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	GLuint levelWidth = width, levelHeight = height;
+	size_t bytes = 0;
+	for (GLuint level = 0; level < mipLevels; level++)
+	{
+		glTexImage2D(GL_TEXTURE_2D, level, this->Internal_Format, levelWidth, levelHeight, 0, this->Image_Format, GL_UNSIGNED_BYTE, data);
+		size_t levelBytes = static_cast<size_t>(levelWidth) * levelHeight * BytesPerPixel();
+		bytes += levelBytes;
+		if (data)
+			data += levelBytes;
+		levelWidth = levelWidth > 1 ? levelWidth / 2 : 1;
+		levelHeight = levelHeight > 1 ? levelHeight / 2 : 1;
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipLevels - 1);
+	Memory::trackGL(GL_OBJECT_TEXTURE, this->ID, bytes);
 	// Set Texture wrap and filter modes
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, this->Wrap_S);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, this->Wrap_T);
@@ -36,4 +58,13 @@ void Texture2D::Generate(GLuint width, GLuint height, unsigned char* data)
 void Texture2D::Bind() const
 {
 	glBindTexture(GL_TEXTURE_2D, this->ID);
+}
+
+GLuint Texture2D::BytesPerPixel() const
+{
+	if (this->Image_Format == GL_RGBA)
+		return 4;
+	if (this->Image_Format == GL_RED)
+		return 1;
+	return 3;
 }
\ No newline at end of file
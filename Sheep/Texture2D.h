@@ -16,7 +16,7 @@
 class Texture2D
 {
 public:
-	// Holds the ID of the texture object, used for all texture operations to reference to this particlar texture
+	// Holds the ID of the texture object, used for all texture operations to reference to this particlar texture - 0 until Generate()
 	GLuint ID;
 	// Texture image dimensions
 	GLuint Width, Height; // Width and height of loaded image in pixels
@@ -30,10 +30,12 @@ public:
 	GLuint Filter_Max; // Filtering mode if texture pixels > screen pixels
 					   // Constructor (sets default texture modes)
 	Texture2D();
-	// Generates texture from image data
-	void Generate(GLuint width, GLuint height, unsigned char* data);
+	// Generates texture from image data - when mipLevels > 1, data holds every level back to back, each half the size of the last
+	void Generate(GLuint width, GLuint height, const unsigned char* data, GLuint mipLevels = 1);
 	// Binds the texture as the current active GL_TEXTURE_2D texture object
 	void Bind() const;
+	// Number of bytes per pixel for the loaded image format
+	GLuint BytesPerPixel() const;
 };
 
 #endif
\ No newline at end of file
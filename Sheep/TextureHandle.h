@@ -0,0 +1,23 @@
+#ifndef TEXTURE_HANDLE_H
+#define TEXTURE_HANDLE_H
+
+#include <GL/glew.h>
+
+// A texture as the things that draw it hold on to it - an index into ResourceManager's texture
+// table, which owns the GL texture itself. It's a single int, so entities carry it around and copy
+// it for free, and making one never touches GL. The default handle refers to no texture, and
+// draws with texture 0 bound
+class TextureHandle
+{
+public:
+	GLuint index;
+
+	// constructors
+	TextureHandle() : index(0) {}
+	explicit TextureHandle(GLuint argIndex) : index(argIndex) {}
+	GLboolean valid() const { return index != 0; }
+	bool operator==(TextureHandle other) const { return index == other.index; }
+	bool operator!=(TextureHandle other) const { return index != other.index; }
+};
+
+#endif
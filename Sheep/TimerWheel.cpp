@@ -0,0 +1,172 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+#include <math.h>
+
+static const GLuint TIMER_INDEX_BITS = 20;
+static const GLuint TIMER_INDEX_MASK = (1 << TIMER_INDEX_BITS) - 1;
+static const GLuint TIMER_NODE_NONE = 0xFFFFFFFF;
+
+TimerWheel::TimerWheel(GLfloat argResolution)
+	: resolution(argResolution)
+{
+	clear();
+}
+
+void TimerWheel::clear(GLfloat time)
+{
+	nodes.clear();
+	freeNodes.clear();
+	for (GLuint level = 0; level < TIMER_WHEEL_LEVELS; level++)
+		for (GLuint slot = 0; slot < TIMER_WHEEL_SLOTS; slot++)
+			heads[level][slot] = tails[level][slot] = TIMER_NODE_NONE;
+	now = tickOf(time);
+	scheduled = 0;
+	count = 0;
+}
+
+TimerId TimerWheel::schedule(GLfloat time, GLuint kind, GLuint target)
+{
+	GLuint node;
+	if (!freeNodes.empty())
+	{
+		node = freeNodes.back();
+		freeNodes.pop_back();
+	}
+	else
+	{
+		node = static_cast<GLuint>(nodes.size());
+		nodes.push_back(Node());
+		nodes[node].generation = 0;
+	}
+	Node& timer = nodes[node];
+	timer.tick = std::max(tickOf(time), now + 1);
+	timer.sequence = scheduled++;
+	timer.event.kind = kind;
+	timer.event.target = target;
+	timer.live = true;
+	insert(node);
+	count++;
+	return node | (timer.generation << TIMER_INDEX_BITS);
+}
+
+void TimerWheel::cancel(TimerId id)
+{
+	GLuint node = nodeOf(id);
+	if (node == TIMER_NODE_NONE)
+		return;
+	unlink(node);
+	nodes[node].live = false;
+	nodes[node].generation++;
+	freeNodes.push_back(node);
+	count--;
+}
+
+GLboolean TimerWheel::pending(TimerId id) const
+{
+	return nodeOf(id) != TIMER_NODE_NONE;
+}
+
+void TimerWheel::advance(GLfloat time, vector<TimerEvent>& fired)
+{
+	uint64_t target = tickOf(time);
+	while (now < target)
+	{
+		now++;
+		// at the start of each run of 64 ticks, the level above has the next run's timers
+		if ((now & (TIMER_WHEEL_SLOTS - 1)) == 0)
+			cascade(1);
+		GLuint slot = now & (TIMER_WHEEL_SLOTS - 1);
+		while (heads[0][slot] != TIMER_NODE_NONE)
+		{
+			GLuint node = heads[0][slot];
+			fired.push_back(nodes[node].event);
+			unlink(node);
+			nodes[node].live = false;
+			nodes[node].generation++;
+			freeNodes.push_back(node);
+			count--;
+		}
+	}
+}
+
+uint64_t TimerWheel::tickOf(GLfloat time) const
+{
+	// rounded, so a time that took a few float steps to add up still lands on its tick
+	return time > 0.f ? static_cast<uint64_t>(llround(time / resolution)) : 0;
+}
+
+GLuint TimerWheel::nodeOf(TimerId id) const
+{
+	if (id == TIMER_NONE)
+		return TIMER_NODE_NONE;
+	GLuint node = id & TIMER_INDEX_MASK;
+	if (node >= nodes.size() || !nodes[node].live || nodes[node].generation << TIMER_INDEX_BITS != (id & ~TIMER_INDEX_MASK))
+		return TIMER_NODE_NONE;
+	return node;
+}
+
+void TimerWheel::insert(GLuint node)
+{
+	// the lowest level whose span reaches the tick - each level covers 64 of the one below
+	Node& timer = nodes[node];
+	uint64_t delta = timer.tick - now;
+	GLuint level = 0;
+	while (level + 1 < TIMER_WHEEL_LEVELS && delta >= (uint64_t(1) << (TIMER_WHEEL_BITS * (level + 1))))
+		level++;
+	// past the top level's reach, it waits in the top level's furthest slot and goes around again
+	uint64_t tick = timer.tick;
+	uint64_t reach = uint64_t(1) << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS);
+	if (delta >= reach)
+		tick = now + reach - 1;
+	timer.level = level;
+	timer.slot = (tick >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+	// a first level slot is a single tick, and fires in the order its timers were scheduled - one
+	// cascaded down can have been scheduled before ones already there. New ones go on the end
+	timer.next = TIMER_NODE_NONE;
+	timer.prev = tails[level][timer.slot];
+	while (level == 0 && timer.prev != TIMER_NODE_NONE && nodes[timer.prev].sequence > timer.sequence)
+	{
+		timer.next = timer.prev;
+		timer.prev = nodes[timer.prev].prev;
+	}
+	if (timer.prev != TIMER_NODE_NONE)
+		nodes[timer.prev].next = node;
+	else
+		heads[level][timer.slot] = node;
+	if (timer.next != TIMER_NODE_NONE)
+		nodes[timer.next].prev = node;
+	else
+		tails[level][timer.slot] = node;
+}
+
+void TimerWheel::unlink(GLuint node)
+{
+	Node& timer = nodes[node];
+	if (timer.prev != TIMER_NODE_NONE)
+		nodes[timer.prev].next = timer.next;
+	else
+		heads[timer.level][timer.slot] = timer.next;
+	if (timer.next != TIMER_NODE_NONE)
+		nodes[timer.next].prev = timer.prev;
+	else
+		tails[timer.level][timer.slot] = timer.prev;
+}
+
+void TimerWheel::cascade(GLuint level)
+{
+	if (level >= TIMER_WHEEL_LEVELS)
+		return;
+	GLuint slot = (now >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1);
+	// the level above empties into this one first, when this one is starting over too
+	if (slot == 0)
+		cascade(level + 1);
+	GLuint node = heads[level][slot];
+	heads[level][slot] = tails[level][slot] = TIMER_NODE_NONE;
+	while (node != TIMER_NODE_NONE)
+	{
+		GLuint next = nodes[node].next;
+		insert(node);
+		node = next;
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <GL/glew.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+// a scheduled event - how long it's been pending is the wheel's business, what it means the owner's
+typedef GLuint TimerId;
+const TimerId TIMER_NONE = 0xFFFFFFFF;
+struct TimerEvent
+{
+	GLuint kind;
+	GLuint target; // usually an Entity
+};
+
+// 4 levels of 64 slots - a timer can be set up to 64^4 ticks ahead, about three days at 60 ticks a second
+const GLuint TIMER_WHEEL_LEVELS = 4;
+const GLuint TIMER_WHEEL_BITS = 6;
+const GLuint TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_BITS;
+
+// Events due at points in sim time, fired once the clock passes them. Time is kept in ticks of
+// resolution seconds. The first level holds a slot per tick of the next 64; each level after that
+// holds a slot per 64 slots of the one below, and a slot is cascaded down into the level below
+// when the clock gets to it. Scheduling and cancelling are constant time, and advancing costs as
+// much as the ticks passed and the events fired or cascaded, however many are pending. Events
+// that fire on the same tick come out in the order they were scheduled.
+class TimerWheel
+{
+public:
+	GLfloat resolution;
+
+	// constructors
+	TimerWheel(GLfloat argResolution = 1.f / 60.f);
+	// forgets every timer, with the clock set to time
+	void clear(GLfloat time = 0.f);
+	// scheduling - a time that's already gone fires on the next advance
+	TimerId schedule(GLfloat time, GLuint kind, GLuint target);
+	void cancel(TimerId id); // fine to call with TIMER_NONE, or a timer that's fired already
+	GLboolean pending(TimerId id) const;
+	GLuint size() const { return count; }
+	// moves the clock forward to time, appending the events that came due to fired
+	void advance(GLfloat time, vector<TimerEvent>& fired);
+private:
+	// ids are the node's index in the low bits, and the generation that the node was on
+	// when scheduled in the high ones, so an id goes stale once its timer fires or is cancelled
+	struct Node
+	{
+		uint64_t tick;
+		uint64_t sequence; // when it was scheduled, for the order events on the same tick fire in
+		TimerEvent event;
+		GLuint prev, next; // within the slot
+		GLuint generation;
+		GLuint level, slot;
+		GLboolean live;
+	};
+	vector<Node> nodes;
+	vector<GLuint> freeNodes;
+	GLuint heads[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS], tails[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+	uint64_t now; // the last tick that's been fired
+	uint64_t scheduled;
+	GLuint count;
+
+	uint64_t tickOf(GLfloat time) const;
+	GLuint nodeOf(TimerId id) const;
+	void insert(GLuint node);
+	void unlink(GLuint node);
+	void cascade(GLuint level);
+};
+
+#endif
@@ -0,0 +1,293 @@
+// Times rockets the way they were kept before archetypes - each its own allocation, a Hazard
+// subclass updated and hit tested through virtual calls, in a vector of pointers erased from
+// when one goes away - against the archetype columns they're kept in now. Both do the same
+// homing and the same blast test against the same herd each tick, with rockets running out and
+// new ones spawned in their place, so the difference is the storage and the calls.
+// usage: ArchetypeBenchmark [ticks]
+#include "../Archetype.h"
+#include "../Components.h"
+#include "../Fixed.h"
+#include "../Random.h"
+
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+const GLuint UNITS = 1000;
+const GLfloat DELTA_TIME = 1 / 60.f;
+
+// into -pi..pi, like boundNegPiToPi - without CollisionUtil, which brings all of Unit with it
+static GLfloat wrapAngle(GLfloat argAngle)
+{
+	return argAngle - 2 * FAST_PI * floorf((argAngle + FAST_PI) / (2 * FAST_PI));
+}
+
+/// before - the fields and calls of the Drawable, Hazard and Rocket classes archetypes replaced
+class OldDrawable
+{
+public:
+	glm::vec2 position, size;
+	TextureHandle sprite;
+	glm::vec4 color;
+	GLfloat rotation;
+	GLboolean bDraw;
+
+	virtual ~OldDrawable() {}
+	virtual GLboolean inHitbox(glm::vec2 argPosition) = 0;
+};
+
+class OldHazard : public OldDrawable, public Tracked<MEMORY_HAZARDS>
+{
+public:
+	GLfloat timer, duration;
+	GLboolean detonated;
+	TextureHandle detonatedSprite;
+	GLfloat worldWidth, worldHeight;
+
+	virtual void update(GLfloat deltaTime) = 0;
+};
+
+class OldRocket : public OldHazard
+{
+public:
+	glm::vec2 destination;
+	GLfloat velocity, angularVelocity;
+	TextureHandle targetSprite;
+
+	void update(GLfloat deltaTime)
+	{
+		if (!detonated)
+		{
+			GLfloat goalAngle = -simAtan2(destination.y - position.y, destination.x - position.x);
+			GLfloat angleDifference = wrapAngle(rotation - goalAngle);
+			GLfloat angleChange = (angularVelocity + fabsf(angleDifference) / 2) * deltaTime;
+			rotation += angleDifference < 0 ? angleChange : angleDifference > 0 ? -angleChange : 0;
+			GLfloat step = velocity * deltaTime / (1 + fabsf(angleDifference)), sine, cosine;
+			simSinCos(rotation, sine, cosine);
+			position.x += cosine * step;
+			position.y -= sine * step;
+			if (simLength(position.x - destination.x, position.y - destination.y) < 25)
+				detonated = true;
+		}
+		if (detonated)
+			duration -= deltaTime;
+		else
+			timer -= deltaTime;
+	}
+	GLboolean inHitbox(glm::vec2 argPosition)
+	{
+		return simLength(position.x - argPosition.x, position.y - argPosition.y) < size.x;
+	}
+};
+
+/// after - as HazardHandler keeps them
+typedef Archetype<MEMORY_HAZARDS, Transform, Sprite, Timer, Blast, Mover> RocketArchetype;
+
+// each rocket's timer and duration come out of the same numbers in both
+struct Spawn
+{
+	glm::vec2 position, destination;
+	GLfloat rotation, timer, duration;
+};
+
+static Spawn spawn(Random& random)
+{
+	Spawn s;
+	s.position = glm::vec2(random.uniform(0.f, 800.f), random.uniform(0.f, 600.f));
+	s.destination = glm::vec2(random.uniform(0.f, 800.f), random.uniform(0.f, 600.f));
+	s.rotation = random.uniform(-3.f, 3.f);
+	s.timer = random.uniform(.5f, 3.f);
+	s.duration = random.uniform(.1f, .5f);
+	return s;
+}
+
+static OldRocket* oldRocket(const Spawn& s)
+{
+	OldRocket* rocket = new OldRocket();
+	rocket->position = s.position;
+	rocket->size = glm::vec2(50, 50);
+	rocket->color = glm::vec4(1.f);
+	rocket->rotation = s.rotation;
+	rocket->bDraw = true;
+	rocket->timer = s.timer;
+	rocket->duration = s.duration;
+	rocket->detonated = false;
+	rocket->worldWidth = 800;
+	rocket->worldHeight = 600;
+	rocket->destination = s.destination;
+	rocket->velocity = 100.f;
+	rocket->angularVelocity = .5f;
+	return rocket;
+}
+
+static void newRocket(RocketArchetype& rockets, const Spawn& s)
+{
+	Transform transform = { s.position, glm::vec2(50, 50), s.rotation };
+	Sprite sprite = { TextureHandle(), glm::vec4(1.f) };
+	Timer timer = { s.timer, s.duration, TIMER_NONE };
+	Blast blast = { TextureHandle(), false };
+	Mover mover = { s.destination, 100.f, .5f, NULL, TextureHandle() };
+	rockets.create(transform, sprite, timer, blast, mover);
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double since(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// microseconds per tick spent in each part, and a count of the hits so the work isn't thrown away
+struct Result
+{
+	double update, hits, churn;
+	GLuint kills;
+};
+
+static Result runBefore(GLuint count, GLuint ticks, const std::vector<glm::vec2>& units)
+{
+	Random random(count);
+	std::vector<OldHazard*> rockets;
+	for (GLuint i = 0; i < count; i++)
+		rockets.push_back(oldRocket(spawn(random)));
+	Result result = { 0, 0, 0, 0 };
+	for (GLuint tick = 0; tick < ticks; tick++)
+	{
+		Clock::time_point start = Clock::now();
+		for (GLuint i = 0; i < rockets.size(); i++)
+		{
+			rockets[i]->update(DELTA_TIME);
+			if (rockets[i]->timer <= 0)
+				rockets[i]->detonated = true;
+		}
+		result.update += since(start);
+
+		start = Clock::now();
+		for (GLuint i = 0; i < rockets.size(); i++)
+			if (rockets[i]->detonated)
+				for (GLuint j = 0; j < units.size(); j++)
+					result.kills += rockets[i]->inHitbox(units[j]);
+		result.hits += since(start);
+
+		// the ones that have gone away, and as many new ones
+		start = Clock::now();
+		GLuint removed = 0;
+		for (GLuint i = 0; i < rockets.size(); )
+		{
+			if (rockets[i]->detonated && rockets[i]->duration <= 0)
+			{
+				delete rockets[i];
+				rockets.erase(rockets.begin() + i);
+				removed++;
+			}
+			else
+				i++;
+		}
+		for (GLuint i = 0; i < removed; i++)
+			rockets.push_back(oldRocket(spawn(random)));
+		result.churn += since(start);
+	}
+	for (GLuint i = 0; i < rockets.size(); i++)
+		delete rockets[i];
+	return result;
+}
+
+static Result runAfter(GLuint count, GLuint ticks, const std::vector<glm::vec2>& units)
+{
+	Random random(count);
+	RocketArchetype rockets;
+	for (GLuint i = 0; i < count; i++)
+		newRocket(rockets, spawn(random));
+	std::vector<Entity> expired;
+	Result result = { 0, 0, 0, 0 };
+	for (GLuint tick = 0; tick < ticks; tick++)
+	{
+		Clock::time_point start = Clock::now();
+		Transform* transforms = rockets.column<Transform>();
+		Timer* timers = rockets.column<Timer>();
+		Blast* blasts = rockets.column<Blast>();
+		const Mover* movers = rockets.column<Mover>();
+		for (GLuint i = 0; i < rockets.size(); i++)
+		{
+			Transform& transform = transforms[i];
+			if (!blasts[i].detonated)
+			{
+				const glm::vec2& destination = movers[i].destination;
+				GLfloat goalAngle = -simAtan2(destination.y - transform.position.y, destination.x - transform.position.x);
+				GLfloat angleDifference = wrapAngle(transform.rotation - goalAngle);
+				GLfloat angleChange = (movers[i].angularVelocity + fabsf(angleDifference) / 2) * DELTA_TIME;
+				transform.rotation += angleDifference < 0 ? angleChange : angleDifference > 0 ? -angleChange : 0;
+				GLfloat step = movers[i].velocity * DELTA_TIME / (1 + fabsf(angleDifference)), sine, cosine;
+				simSinCos(transform.rotation, sine, cosine);
+				transform.position.x += cosine * step;
+				transform.position.y -= sine * step;
+				if (simLength(transform.position.x - destination.x, transform.position.y - destination.y) < 25)
+					blasts[i].detonated = true;
+			}
+			if (blasts[i].detonated)
+				timers[i].linger -= DELTA_TIME;
+			else
+				timers[i].due -= DELTA_TIME;
+			if (timers[i].due <= 0)
+				blasts[i].detonated = true;
+		}
+		result.update += since(start);
+
+		start = Clock::now();
+		for (GLuint i = 0; i < rockets.size(); i++)
+			if (blasts[i].detonated)
+			{
+				glm::vec2 position = transforms[i].position;
+				GLfloat reach = transforms[i].size.x;
+				for (GLuint j = 0; j < units.size(); j++)
+					result.kills += simLength(position.x - units[j].x, position.y - units[j].y) < reach;
+			}
+		result.hits += since(start);
+
+		start = Clock::now();
+		expired.clear();
+		for (GLuint i = 0; i < rockets.size(); i++)
+			if (blasts[i].detonated && timers[i].linger <= 0)
+				expired.push_back(rockets.entity(i));
+		for (GLuint i = 0; i < expired.size(); i++)
+			rockets.destroy(expired[i]);
+		for (GLuint i = 0; i < expired.size(); i++)
+			newRocket(rockets, spawn(random));
+		result.churn += since(start);
+	}
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	GLuint ticks = argc > 1 ? static_cast<GLuint>(atoi(argv[1])) : 600;
+	if (!ticks)
+	{
+		std::cout << "usage: " << argv[0] << " [ticks]" << std::endl;
+		return 1;
+	}
+	Random random(1);
+	std::vector<glm::vec2> units(UNITS);
+	for (GLuint i = 0; i < UNITS; i++)
+		units[i] = glm::vec2(random.uniform(0.f, 800.f), random.uniform(0.f, 600.f));
+
+	std::cout << "rockets,layout,update us/tick,hits us/tick,spawn and remove us/tick,total us/tick,kills" << std::endl;
+	const GLuint counts[] = { 100, 1000, 10000 };
+	for (GLuint c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+	{
+		Result before = runBefore(counts[c], ticks, units), after = runAfter(counts[c], ticks, units);
+		if (before.kills != after.kills)
+			std::cout << "ERROR::BENCHMARK: the two layouts hit different units with " << counts[c] << " rockets" << std::endl;
+		const Result* results[] = { &before, &after };
+		const char* names[] = { "objects", "archetype" };
+		for (GLuint r = 0; r < 2; r++)
+		{
+			const Result& result = *results[r];
+			std::cout << counts[c] << ',' << names[r] << ',' << result.update / ticks << ',' << result.hits / ticks << ','
+				<< result.churn / ticks << ',' << (result.update + result.hits + result.churn) / ticks << ','
+				<< result.kills << std::endl;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,127 @@
+// Runs an Archetype against a plain map from entity to its components, creating and destroying
+// entities at random - destroyed ones as well, and ENTITY_NONE - so slots are moved around and
+// indices handed out again. Every live entity has to be alive and find its own components, the
+// columns have to stay packed, and every destroyed one has to stay stale, so destroying it again
+// leaves whoever has its index now alone.
+// usage: ArchetypeTest
+#include "../Archetype.h"
+#include "../Random.h"
+#include "Check.h"
+
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <vector>
+
+const GLuint STEPS = 20000;
+
+struct Label { GLuint value; };
+struct Weight { GLfloat value; };
+
+typedef Archetype<MEMORY_UNITS, Label, Weight> TestArchetype;
+
+// every entity the map has is alive with its own components, at a slot that leads back to it
+static bool matches(TestArchetype& archetype, const std::map<Entity, GLuint>& expected)
+{
+	if (archetype.size() != expected.size())
+	{
+		std::cout << "ERROR::ARCHETYPE: " << archetype.size() << " entities, not " << expected.size() << std::endl;
+		return false;
+	}
+	for (std::map<Entity, GLuint>::const_iterator it = expected.begin(); it != expected.end(); ++it)
+	{
+		Entity entity = it->first;
+		if (!archetype.alive(entity) || archetype.slot(entity) >= archetype.size() || archetype.entity(archetype.slot(entity)) != entity
+			|| archetype.get<Label>(entity).value != it->second || archetype.get<Weight>(entity).value != it->second * .5f)
+		{
+			std::cout << "ERROR::ARCHETYPE: entity " << entity << " lost its components" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool againstMap()
+{
+	TestArchetype archetype;
+	std::map<Entity, GLuint> expected;
+	std::vector<Entity> dead;
+	std::set<GLuint> indices;
+	Random random(5);
+	GLuint created = 0, reused = 0;
+	for (GLuint step = 0; step < STEPS; step++)
+	{
+		GLuint roll = random.below(10);
+		if (roll < 5 || expected.empty())
+		{
+			Label label = { created };
+			Weight weight = { created * .5f };
+			Entity entity = archetype.create(label, weight);
+			if (expected.count(entity))
+			{
+				std::cout << "ERROR::ARCHETYPE: entity " << entity << " handed out twice" << std::endl;
+				return false;
+			}
+			reused += !indices.insert(entity & ENTITY_INDEX_MASK).second;
+			expected[entity] = created++;
+		}
+		else if (roll < 9)
+		{
+			std::map<Entity, GLuint>::iterator it = expected.begin();
+			std::advance(it, random.below(static_cast<GLuint>(expected.size())));
+			archetype.destroy(it->first);
+			dead.push_back(it->first);
+			expected.erase(it);
+		}
+		else
+		{
+			// stale ones, which have to be left as they are
+			archetype.destroy(ENTITY_NONE);
+			if (!dead.empty())
+			{
+				Entity entity = pick(random, dead);
+				if (archetype.alive(entity))
+				{
+					std::cout << "ERROR::ARCHETYPE: destroyed entity " << entity << " is alive" << std::endl;
+					return false;
+				}
+				archetype.destroy(entity);
+			}
+		}
+		if (!matches(archetype, expected))
+			return false;
+	}
+	std::cout << created << " created, " << dead.size() << " destroyed, " << reused << " indices reused" << std::endl;
+	return reused > 0;
+}
+
+int main()
+{
+	int failures = 0;
+
+	/// one at a time
+	TestArchetype archetype;
+	Label labels[] = { { 1 }, { 2 }, { 3 } };
+	Weight weights[] = { { .5f }, { 1.f }, { 1.5f } };
+	Entity first = archetype.create(labels[0], weights[0]);
+	Entity second = archetype.create(labels[1], weights[1]);
+	Entity third = archetype.create(labels[2], weights[2]);
+	archetype.destroy(first);
+	failures += !check("destroying moves the last into the gap", !archetype.alive(first) && archetype.size() == 2
+		&& archetype.slot(third) == 0 && archetype.column<Label>()[0].value == 3 && archetype.get<Weight>(second).value == 1.f);
+	Entity fourth = archetype.create(labels[0], weights[0]);
+	failures += !check("a reused index gets a new id", (fourth & ENTITY_INDEX_MASK) == (first & ENTITY_INDEX_MASK)
+		&& fourth != first && !archetype.alive(first) && archetype.alive(fourth));
+	archetype.destroy(first);
+	archetype.destroy(ENTITY_NONE);
+	failures += !check("and destroying the stale one leaves it alone", archetype.alive(fourth) && archetype.size() == 3
+		&& archetype.get<Label>(fourth).value == 1);
+	archetype.clear();
+	failures += !check("clear", archetype.empty() && !archetype.alive(second));
+
+	/// against the map
+	failures += !check("against a map", againstMap());
+
+	return failures ? 1 : 0;
+}
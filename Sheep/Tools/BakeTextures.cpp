@@ -0,0 +1,38 @@
+// Bakes images into the texture cache ahead of time, so the first launch uploads straight from the
+// blobs instead of decoding every PNG. An image whose blob is already current is left alone. Run
+// it from where the game runs, with the paths the game loads them by, as those name the blobs.
+// -mipmaps bakes a mip chain for the images after it, and -rgb bakes the images after it without
+// alpha, like the game's GL_FALSE textures; -rgba goes back to alpha. `make bake` does the game's.
+// usage: BakeTextures [-mipmaps] [-rgb|-rgba] <image>...
+#include "../ResourceManager.h"
+
+#include <iostream>
+#include <string.h>
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: BakeTextures [-mipmaps] [-rgb|-rgba] <image>..." << std::endl;
+		return 1;
+	}
+	GLboolean alpha = GL_TRUE, mipmaps = GL_FALSE;
+	int failures = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "-mipmaps"))
+			mipmaps = GL_TRUE;
+		else if (!strcmp(argv[i], "-rgb"))
+			alpha = GL_FALSE;
+		else if (!strcmp(argv[i], "-rgba"))
+			alpha = GL_TRUE;
+		else if (ResourceManager::BakeTexture(argv[i], alpha, mipmaps))
+			std::cout << argv[i] << std::endl;
+		else
+		{
+			std::cout << "ERROR::TEXTURE: Failed to bake " << argv[i] << std::endl;
+			failures++;
+		}
+	}
+	return failures ? 1 : 0;
+}
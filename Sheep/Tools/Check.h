@@ -0,0 +1,26 @@
+// What the test tools share. Each check prints its name and whether it passed, and main adds up
+// the ones that didn't for its exit code. The randomised ones run the code under test next to a
+// plain container doing the same the slow, obvious way, seeded so a failure comes back every run,
+// and pick() what to work on from it.
+#ifndef CHECK_H
+#define CHECK_H
+
+#include "../Random.h"
+
+#include <iostream>
+#include <vector>
+
+inline bool check(const char* name, bool passed)
+{
+	std::cout << name << ": " << (passed ? "ok" : "FAILED") << std::endl;
+	return passed;
+}
+
+// one of items at random - there has to be one
+template <typename T>
+T& pick(Random& random, std::vector<T>& items)
+{
+	return items[random.below(static_cast<GLuint>(items.size()))];
+}
+
+#endif
@@ -0,0 +1,168 @@
+// Checks FastMath's functions against double precision libm, failing if any is off by more than
+// its comment promises, then times them against the float libm calls they stand in for.
+// usage: FastMathAccuracy
+#include "../FastMath.h"
+#include "../Random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif //_USE_MATH_DEFINES
+#include <math.h>
+
+const GLuint SAMPLES = 4000000;
+const GLuint TIMED = 1 << 16; // values per timed pass - small enough to stay in cache
+const GLuint PASSES = 200;
+
+// the promised bounds
+const double ATAN2_BOUND = 2e-6;
+const double SIN_COS_BOUND = 4e-7;
+const double SIN_COS_RANGE = 1000.0;
+const double DIRECTION_BOUND = 2e-7;
+const double LOG_BOUND = 1e-6;
+// Random::normal's draws, over this many - their mean and deviation have to come out close to asked for
+const GLuint NORMAL_SAMPLES = 1000000;
+const double NORMAL_BOUND = .01;
+
+static bool check(const char* name, double error, double bound)
+{
+	bool within = error <= bound;
+	std::cout << name << ": max error " << error << " (bound " << bound << ")" << (within ? "" : " - OVER") << std::endl;
+	return within;
+}
+
+// nanoseconds per value of f over the whole of the input, best of a few runs
+template<typename F>
+static double time(F f)
+{
+	double best = 1e30;
+	for (GLuint run = 0; run < 5; run++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (GLuint pass = 0; pass < PASSES; pass++)
+			f();
+		std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		best = std::min(best, elapsed.count() / (static_cast<double>(PASSES) * TIMED));
+	}
+	return best;
+}
+
+static void report(const char* name, double fast, double libm)
+{
+	std::cout << name << ": " << fast << " ns, libm " << libm << " ns, " << libm / fast << "x" << std::endl;
+}
+
+int main()
+{
+	Random random(12345);
+	bool passed = true;
+
+	/// accuracy
+	// coordinates both far apart and close to the origin, and every mix of the two
+	double error = 0;
+	for (GLuint i = 0; i < SAMPLES; i++)
+	{
+		GLfloat y = i % 2 ? random.uniform(-1000.f, 1000.f) : random.uniform(-5.f, 5.f);
+		GLfloat x = i % 3 ? random.uniform(-1000.f, 1000.f) : random.uniform(-5.f, 5.f);
+		double difference = fabs(fastAtan2(y, x) - atan2(static_cast<double>(y), static_cast<double>(x)));
+		// pi and -pi are the same way
+		error = std::max(error, std::min(difference, fabs(difference - 2 * M_PI)));
+	}
+	passed &= check("fastAtan2", error, ATAN2_BOUND);
+
+	error = 0;
+	for (GLuint i = 0; i < SAMPLES; i++)
+	{
+		GLfloat angle = random.uniform(static_cast<GLfloat>(-SIN_COS_RANGE), static_cast<GLfloat>(SIN_COS_RANGE));
+		GLfloat sine, cosine;
+		fastSinCos(angle, sine, cosine);
+		error = std::max(error, fabs(sine - sin(static_cast<double>(angle))));
+		error = std::max(error, fabs(cosine - cos(static_cast<double>(angle))));
+		error = std::max(error, fabs(fastSin(angle) - sin(static_cast<double>(angle))));
+		error = std::max(error, fabs(fastCos(angle) - cos(static_cast<double>(angle))));
+	}
+	passed &= check("fastSinCos, fastSin, fastCos", error, SIN_COS_BOUND);
+
+	error = 0;
+	for (GLuint i = 0; i < SAMPLES; i++)
+	{
+		GLfloat x = random.uniform(-5.f, 5.f), y = random.uniform(-5.f, 5.f);
+		GLfloat directionX, directionY;
+		fastDirection(x, y, directionX, directionY);
+		double heading = atan2(static_cast<double>(y), static_cast<double>(x));
+		error = std::max(error, fabs(directionX - cos(heading)));
+		error = std::max(error, fabs(directionY - sin(heading)));
+	}
+	passed &= check("fastDirection", error, DIRECTION_BOUND);
+
+	// every value Random::normal takes the log of, which is every multiple of 2^-24 up to 1
+	error = 0;
+	for (GLuint i = 1; i <= 1u << 24; i++)
+	{
+		GLfloat value = i * (1.f / 16777216.f);
+		error = std::max(error, fabs(fastLog(value) - log(static_cast<double>(value))));
+	}
+	passed &= check("fastLog", error, LOG_BOUND);
+
+	double sum = 0, squares = 0;
+	Random draws(54321);
+	for (GLuint i = 0; i < NORMAL_SAMPLES; i++)
+	{
+		double draw = draws.normal(0.f, 1.f);
+		sum += draw;
+		squares += draw * draw;
+	}
+	double mean = sum / NORMAL_SAMPLES, deviation = sqrt(squares / NORMAL_SAMPLES - mean * mean);
+	passed &= check("Random::normal mean", fabs(mean), NORMAL_BOUND);
+	passed &= check("Random::normal deviation", fabs(deviation - 1.0), NORMAL_BOUND);
+
+	GLfloat directionX, directionY;
+	fastDirection(0.f, 0.f, directionX, directionY);
+	if (fastAtan2(0.f, 0.f) != 0.f || directionX != 1.f || directionY != 0.f)
+	{
+		std::cout << "ERROR::FAST_MATH: (0, 0) should give an angle of 0 and a direction of (1, 0)" << std::endl;
+		passed = false;
+	}
+
+	/// speed - over arrays, the way the simulation calls them, so the fast ones get to vectorise
+	std::vector<GLfloat> x(TIMED), y(TIMED), angle(TIMED), logValue(TIMED), outA(TIMED), outB(TIMED);
+	for (GLuint i = 0; i < TIMED; i++)
+	{
+		x[i] = random.uniform(-1000.f, 1000.f);
+		y[i] = random.uniform(-1000.f, 1000.f);
+		angle[i] = random.uniform(static_cast<GLfloat>(-SIN_COS_RANGE), static_cast<GLfloat>(SIN_COS_RANGE));
+		logValue[i] = random.uniform(1.f / 16777216.f, 1.f);
+	}
+	GLfloat* a = outA.data();
+	GLfloat* b = outB.data();
+	const GLfloat* xs = x.data();
+	const GLfloat* ys = y.data();
+	const GLfloat* angles = angle.data();
+	const GLfloat* logs = logValue.data();
+
+	report("atan2", time([&] { for (GLuint i = 0; i < TIMED; i++) a[i] = fastAtan2(ys[i], xs[i]); }),
+		time([&] { for (GLuint i = 0; i < TIMED; i++) a[i] = atan2f(ys[i], xs[i]); }));
+	report("sin", time([&] { for (GLuint i = 0; i < TIMED; i++) a[i] = fastSin(angles[i]); }),
+		time([&] { for (GLuint i = 0; i < TIMED; i++) a[i] = sinf(angles[i]); }));
+	report("cos", time([&] { for (GLuint i = 0; i < TIMED; i++) a[i] = fastCos(angles[i]); }),
+		time([&] { for (GLuint i = 0; i < TIMED; i++) a[i] = cosf(angles[i]); }));
+	report("sin and cos", time([&] { for (GLuint i = 0; i < TIMED; i++) fastSinCos(angles[i], a[i], b[i]); }),
+		time([&] { for (GLuint i = 0; i < TIMED; i++) { a[i] = sinf(angles[i]); b[i] = cosf(angles[i]); } }));
+	report("log", time([&] { for (GLuint i = 0; i < TIMED; i++) a[i] = fastLog(logs[i]); }),
+		time([&] { for (GLuint i = 0; i < TIMED; i++) a[i] = logf(logs[i]); }));
+	// what fastDirection replaces is the heading worked out and then turned back into a direction
+	report("direction", time([&] { for (GLuint i = 0; i < TIMED; i++) fastDirection(xs[i], ys[i], a[i], b[i]); }),
+		time([&] { for (GLuint i = 0; i < TIMED; i++) { GLfloat h = atan2f(ys[i], xs[i]); a[i] = cosf(h); b[i] = sinf(h); } }));
+
+	// so the timed loops have something to be kept for
+	GLfloat checksum = 0;
+	for (GLuint i = 0; i < TIMED; i++)
+		checksum += a[i] + b[i];
+	std::cout << "(checksum " << checksum << ")" << std::endl;
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+// Orders 5000 sheep across the world, once walking in a straight line (Flock::setDestination) and
+// once following a flow field (Flock::setFlowDestination), and reports how much work the collision
+// solver did and how long it took them all to get there. It's done over open ground, with a wall
+// of idle sheep in the way that has a gap in the middle, and with the herd scattered about in
+// eight flocks, the way a box selection over a spread out herd ends up - there, straight line
+// flocks each center themselves on the destination and pile into each other, and the flow field
+// is built once and shared by all eight. Ticks run the way UpdateGame runs them with steering off,
+// as it is by default: every unit moves, then the solver pushes them apart. A straight line order
+// keeps each flock's shape, so each sheep has a destination of its own; a flow field sends them
+// all to the one point, and they pile up around it - so their miss is about the size of the pile,
+// and they stop once they run into it, rather than once they're there.
+// usage: FlowFieldBenchmark
+#include "../CollisionSolver.h"
+#include "../Flock.h"
+#include "../FlowField.h"
+#include "../Selection.h"
+#include "../Unit.h"
+#include "../WorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+const GLuint UNITS = 5000;
+const GLfloat WORLD_WIDTH = 8000.f, WORLD_HEIGHT = 6000.f;
+const GLfloat UNIT_SIZE = 50.f, UNIT_SPACING = 55.f, UNIT_VELOCITY = 100.f;
+const GLuint HERD_ROWS = 100; // the herd that's ordered starts out as a block this many sheep tall
+const GLfloat WALL_X = 4000.f, GAP_TOP = 2400.f, GAP_BOTTOM = 3600.f;
+const GLuint WALL_COLUMNS = 3;
+const GLuint SCATTERED_FLOCKS = 8, SCATTERED_COLUMNS = 4; // in two rows, along the top and bottom
+const GLfloat SCATTERED_SPACING = 1500.f, SCATTERED_BOTTOM = 4500.f;
+const glm::vec2 GOAL = glm::vec2(6800.f, 3000.f);
+const GLfloat DELTA_TIME = 1 / 60.f;
+const GLuint MAX_TICKS = 60 * 300;
+
+enum Ground { OPEN, WALL, SCATTERED };
+enum Pathing { STRAIGHT, FLOW_FIELD };
+
+struct Result
+{
+	GLuint ticks;				// until every ordered sheep stopped, MAX_TICKS if they didn't
+	uint64_t pairEvaluations;	// over all of those ticks
+	double orderMs, simulateMs; // giving the order, and the ticks after it
+	GLfloat meanMiss;			// how far from their destinations they stopped, on average
+};
+
+static Unit* sheep(glm::vec2 position)
+{
+	return new Unit(position, glm::vec2(UNIT_SIZE, UNIT_SIZE), TextureHandle(), glm::vec4(1.0f), true, 0.0f, UNIT_VELOCITY);
+}
+
+static Result run(WorkerPool& pool, Ground ground, Pathing pathing)
+{
+	typedef std::chrono::steady_clock Clock;
+	vector<Unit*> units;
+	// the wall first, so the herd fills out the rest of the count
+	if (ground == WALL)
+		for (GLuint column = 0; column < WALL_COLUMNS; column++)
+			for (GLfloat y = UNIT_SPACING / 2; y < WORLD_HEIGHT; y += UNIT_SPACING)
+				if (y < GAP_TOP || y > GAP_BOTTOM)
+					units.push_back(sheep(glm::vec2(WALL_X + column * UNIT_SPACING, y)));
+	GLuint wallCount = static_cast<GLuint>(units.size());
+	GLuint flockCount = ground == SCATTERED ? SCATTERED_FLOCKS : 1;
+	GLuint perFlock = (UNITS - wallCount + flockCount - 1) / flockCount;
+	GLuint flockRows = ground == SCATTERED ? static_cast<GLuint>(ceil(sqrt(static_cast<GLfloat>(perFlock)))) : HERD_ROWS;
+	vector<Flock> flocks(flockCount, Flock(WORLD_WIDTH, WORLD_HEIGHT));
+	for (GLuint i = 0; units.size() < UNITS; i++)
+	{
+		GLuint f = i / perFlock, j = i % perFlock;
+		glm::vec2 corner(100.f, 100.f);
+		if (ground == SCATTERED)
+			corner += glm::vec2((f % SCATTERED_COLUMNS) * SCATTERED_SPACING, (f / SCATTERED_COLUMNS) * SCATTERED_BOTTOM);
+		Unit* unit = sheep(corner + glm::vec2((j / flockRows) * UNIT_SPACING, (j % flockRows) * UNIT_SPACING));
+		units.push_back(unit);
+		unit->select();
+		flocks[f].add(unit);
+	}
+
+	Result result = { MAX_TICKS, 0, 0, 0, 0.f };
+	Clock::time_point start = Clock::now();
+	if (pathing == FLOW_FIELD)
+	{
+		shared_ptr<FlowField> field = buildFlowField(GOAL, WORLD_WIDTH, WORLD_HEIGHT, units);
+		for (GLuint f = 0; f < flockCount; f++)
+			flocks[f].setFlowDestination(field, 0.f);
+	}
+	else
+		for (GLuint f = 0; f < flockCount; f++)
+			flocks[f].setDestination(GOAL, 0.f);
+	result.orderMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	CollisionSolver solver(&pool, WORLD_WIDTH, WORLD_HEIGHT, 100.f);
+	start = Clock::now();
+	for (GLuint tick = 0; tick < MAX_TICKS; tick++)
+	{
+		for (GLuint i = 0; i < units.size(); i++)
+			units[i]->move(DELTA_TIME);
+		solver.solve(units);
+		result.pairEvaluations += solver.pairEvaluations;
+		GLboolean moving = false;
+		for (GLuint i = wallCount; i < units.size() && !moving; i++)
+			moving = units[i]->moving;
+		if (!moving)
+		{
+			result.ticks = tick + 1;
+			break;
+		}
+	}
+	result.simulateMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	for (GLuint i = wallCount; i < units.size(); i++)
+		result.meanMiss += glm::length(units[i]->destination - units[i]->position);
+	result.meanMiss /= units.size() - wallCount;
+	Selection::clear();
+	for (GLuint i = 0; i < units.size(); i++)
+		delete units[i];
+	return result;
+}
+
+int main()
+{
+	GLuint cores = std::max(2u, std::thread::hardware_concurrency());
+	WorkerPool pool(cores - 2);
+	std::cout << "ground,pathing,ticks to arrive,pair evaluations,pair evaluations per tick,order ms,simulation ms,mean miss" << std::endl;
+	const char* grounds[] = { "open", "wall", "scattered" };
+	for (GLuint ground = OPEN; ground <= SCATTERED; ground++)
+		for (GLuint pathing = STRAIGHT; pathing <= FLOW_FIELD; pathing++)
+		{
+			Result result = run(pool, static_cast<Ground>(ground), static_cast<Pathing>(pathing));
+			std::cout << grounds[ground] << ',' << (pathing == FLOW_FIELD ? "flow field" : "straight") << ',';
+			if (result.ticks < MAX_TICKS)
+				std::cout << result.ticks;
+			else
+				std::cout << "over " << MAX_TICKS;
+			std::cout << ',' << result.pairEvaluations << ',' << result.pairEvaluations / result.ticks << ','
+				<< result.orderMs << ',' << result.simulateMs << ',' << result.meanMiss << std::endl;
+		}
+	return 0;
+}
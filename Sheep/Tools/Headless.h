@@ -0,0 +1,66 @@
+// A game set up and played without a window, for the tools that play one - what InitVariables,
+// InitGraphics and InitGamestate set up, less anything drawn. The herd is bigger than a game starts
+// with, and is ordered about every couple of seconds the way right clicks do, in straight lines and
+// along flow fields, with steering on for every other pair of orders - so the solver, steering and
+// flow fields all get crowds to work on, next to the hazards and power ups.
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include "../Game.h"
+#include "../ResourceManager.h"
+#include "../Selection.h"
+
+#include <algorithm>
+#include <thread>
+
+const GLuint HEADLESS_WIDTH = 800, HEADLESS_HEIGHT = 600;
+const GLuint HEADLESS_COLUMNS = 10, HEADLESS_ROWS = 6;
+const GLfloat HEADLESS_DELTA_TIME = 1 / 60.f;
+const GLuint HEADLESS_TICKS_PER_ORDER = 120;
+
+inline void startHeadless(uint64_t seed, Difficulty difficulty)
+{
+	// textures are only ever handed around, so empty ones do
+	const char* textures[] = { "sheep", "selectionBox", "Lazer", "LazerExploded", "Rocket", "RocketExploded", "RocketTarget", "Life" };
+	for (GLuint i = 0; i < sizeof(textures) / sizeof(textures[0]); i++)
+		ResourceManager::Textures[textures[i]] = TextureHandle();
+	Game::InitVariables(HEADLESS_WIDTH, HEADLESS_HEIGHT);
+	Game::difficulty = difficulty;
+	GLuint cores = std::max(2u, std::thread::hardware_concurrency());
+	Game::workers = new WorkerPool(cores - 2);
+	Game::collisionSolver = new CollisionSolver(Game::workers, HEADLESS_WIDTH, HEADLESS_HEIGHT, UNIT_GRID_CELL_SIZE);
+	for (GLuint i = 0; i < HEADLESS_COLUMNS; i++)
+		for (GLuint j = 0; j < HEADLESS_ROWS; j++)
+			Game::units.push_back(new Unit(glm::vec2(130 + i * 60, 150 + j * 60), glm::vec2(50, 50),
+				ResourceManager::GetTexture("sheep"), glm::vec4(1.0f), true, 0.0f, 100.f));
+	Game::random.seed(seed);
+	Game::InitWorld();
+	Game::unitGrid->build(Game::units);
+	Game::gameScore = 0;
+	Game::gameTime = 0;
+	Game::hazardHandler->init();
+	Game::powerUpSpawnTime = Game::gameTime + 10.f;
+	Game::schedulePowerUps();
+	Game::gamestateInitialized = true;
+}
+
+// the orders for tick, if it's time for some - they come from a generator of their own, so they
+// don't change what the game draws
+inline void orderHeadless(Random& orders, GLuint tick)
+{
+	if (tick % HEADLESS_TICKS_PER_ORDER)
+		return;
+	GLuint order = tick / HEADLESS_TICKS_PER_ORDER;
+	GLboolean steer = order / 2 % 2 == 1;
+	if (Game::steeringEnabled && !steer)
+		Steering::reset(Game::units);
+	Game::steeringEnabled = steer;
+	Game::pathingMode = order % 2 ? PATHING_FLOW_FIELD : PATHING_STRAIGHT;
+	Selection::clear();
+	for (GLuint i = 0; i < Game::units.size(); i++)
+		if (orders.below(3))
+			Game::units[i]->select();
+	Game::orderSelection(glm::vec2(orders.uniform(50.f, HEADLESS_WIDTH - 50.f), orders.uniform(50.f, HEADLESS_HEIGHT - 50.f)));
+}
+
+#endif
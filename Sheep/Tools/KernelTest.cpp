@@ -0,0 +1,159 @@
+// Runs every variant of the hazard kernels the CPU supports against the scalar ones, and fails if
+// any of them comes out different by so much as a bit. Each is picked the way the game picks it,
+// by setting SHEEP_ISA and calling Kernels::init(), so the selection gets checked too. Build it with
+// -mfma or -march=native as well, to check none of them picked up fused multiply-adds.
+// usage: KernelTest
+#include "../Kernels.h"
+#include "../Random.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif //_USE_MATH_DEFINES
+#include <math.h>
+
+static void forceIsa(const char* name)
+{
+#ifdef _MSC_VER
+	_putenv_s("SHEEP_ISA", name);
+#else
+	setenv("SHEEP_ISA", name, 1);
+#endif
+}
+
+// value, or one of the floats an ulp or two either side of it
+static GLfloat nudge(Random& random, GLfloat value)
+{
+	for (GLuint steps = random.below(5); steps > 0; steps--)
+		value = nextafterf(value, steps % 2 ? 1e9f : -1e9f);
+	return value;
+}
+
+// true if kernels come out the same as the scalar ones on made up input
+static bool matchesScalar(const KernelTable& kernels)
+{
+	KernelTable reference;
+	scalarKernels(reference);
+	// odd sizes for the leftovers after the vectors, and headings on and around the edges - dead
+	// rockets, right on their goal, and half a turn either way
+	const GLuint sizes[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 64, 67, 1000 };
+	GLfloat pi = static_cast<GLfloat>(M_PI);
+	Random random(12345);
+	for (GLuint s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+	{
+		GLuint count = sizes[s];
+		std::vector<Scalar> heading(count), goalAngle(count), angularVelocity(count), velocity(count), live(count);
+		std::vector<Scalar> x(count), y(count), radius(count);
+		for (GLuint i = 0; i < count; i++)
+		{
+			goalAngle[i] = toScalar(random.uniform(-pi, pi));
+			switch (random.below(4))
+			{
+			case 0:
+				heading[i] = goalAngle[i];
+				break;
+			case 1:
+				heading[i] = goalAngle[i] + toScalar(random.below(2) ? pi : -pi);
+				break;
+			default:
+				heading[i] = toScalar(random.uniform(-pi, pi));
+			}
+			angularVelocity[i] = toScalar(random.uniform(0.f, 1.f));
+			velocity[i] = toScalar(random.uniform(0.f, 200.f));
+			live[i] = random.below(4) ? Scalar(1) : Scalar(0);
+			x[i] = toScalar(random.uniform(-100.f, 900.f));
+			y[i] = toScalar(random.uniform(-100.f, 700.f));
+			radius[i] = toScalar(random.uniform(10.f, 40.f));
+		}
+		std::vector<Scalar> expectedHeading(heading), expectedStep(count), actualHeading(heading), actualStep(count);
+		Scalar dt = toScalar(1 / 60.f);
+		reference.turnRockets(expectedHeading.data(), expectedStep.data(), goalAngle.data(), angularVelocity.data(),
+			velocity.data(), live.data(), count, dt);
+		kernels.turnRockets(actualHeading.data(), actualStep.data(), goalAngle.data(), angularVelocity.data(),
+			velocity.data(), live.data(), count, dt);
+		if (count && (memcmp(expectedHeading.data(), actualHeading.data(), count * sizeof(Scalar))
+			|| memcmp(expectedStep.data(), actualStep.data(), count * sizeof(Scalar))))
+		{
+			std::cout << "ERROR::KERNELS: turnRockets differs with " << count << " rockets" << std::endl;
+			return false;
+		}
+
+		// each hazard has half the units spread about at random, and the rest right on the edge of
+		// where it hits, give or take an ulp - where a rounding difference turns into a different hit
+		std::vector<GLint> expectedHits(count, 0), actualHits(count, 0);
+		for (GLuint hazard = 0; hazard < 8; hazard++)
+		{
+			GLfloat originX = random.uniform(0.f, 800.f), originY = random.uniform(0.f, 600.f);
+			GLfloat angle = random.uniform(-pi, pi), reach = random.uniform(50.f, 150.f);
+			Scalar sine, cosine;
+			simSinCos(toScalar(angle), sine, cosine);
+			GLfloat sineF = toFloat(sine), cosineF = toFloat(cosine);
+			for (GLuint i = 0; i < count; i++)
+				if (i % 2)
+				{
+					// off the beam by its radius, anywhere along it
+					GLfloat along = random.uniform(-500.f, 500.f), off = toFloat(radius[i]) * (random.below(2) ? 1.f : -1.f);
+					x[i] = toScalar(nudge(random, originX + along * cosineF + off * sineF));
+					y[i] = toScalar(nudge(random, originY + along * sineF - off * cosineF));
+				}
+			reference.beamHits(x.data(), y.data(), radius.data(), expectedHits.data(), count, toScalar(originX), toScalar(originY), sine, cosine);
+			kernels.beamHits(x.data(), y.data(), radius.data(), actualHits.data(), count, toScalar(originX), toScalar(originY), sine, cosine);
+			if (expectedHits != actualHits)
+			{
+				std::cout << "ERROR::KERNELS: beamHits differs with " << count << " units" << std::endl;
+				return false;
+			}
+			for (GLuint i = 0; i < count; i++)
+				if (i % 2)
+				{
+					// reach away from the blast, any which way
+					GLfloat direction = random.uniform(-pi, pi);
+					x[i] = toScalar(nudge(random, originX + reach * cosf(direction)));
+					y[i] = toScalar(nudge(random, originY + reach * sinf(direction)));
+				}
+			reference.blastHits(x.data(), y.data(), expectedHits.data(), count, toScalar(originX), toScalar(originY), toScalar(reach));
+			kernels.blastHits(x.data(), y.data(), actualHits.data(), count, toScalar(originX), toScalar(originY), toScalar(reach));
+			if (expectedHits != actualHits)
+			{
+				std::cout << "ERROR::KERNELS: blastHits differs with " << count << " units" << std::endl;
+				return false;
+			}
+			// the hits of the next hazard are flagged on top of fresh ones
+			std::fill(expectedHits.begin(), expectedHits.end(), 0);
+			std::fill(actualHits.begin(), actualHits.end(), 0);
+		}
+	}
+	return true;
+}
+
+int main()
+{
+	int failures = 0;
+	for (GLint i = 0; i < KERNEL_ISA_COUNT; i++)
+	{
+		KernelIsa isa = static_cast<KernelIsa>(i);
+		if (!Kernels::supported(isa))
+		{
+			std::cout << Kernels::name(isa) << ": not supported here, skipped" << std::endl;
+			continue;
+		}
+		forceIsa(Kernels::name(isa));
+		Kernels::init();
+		if (Kernels::isa != isa)
+		{
+			std::cout << "ERROR::KERNELS: SHEEP_ISA=" << Kernels::name(isa) << " picked " << Kernels::name(Kernels::isa) << std::endl;
+			failures++;
+			continue;
+		}
+		bool same = matchesScalar(Kernels::active);
+		std::cout << Kernels::name(isa) << ": " << (same ? "same as scalar" : "DIFFERENT") << std::endl;
+		if (!same)
+			failures++;
+	}
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+// Checks Memory's books: that the tagged containers and objects add to their tag's bytes, blocks
+// and peak as they grow and take it all back as they go - from several threads at once as well -
+// that GL objects are counted by kind and registering one again just resizes it, and that
+// MemoryReport only formats the lines whose figures changed, into the strings already there.
+// usage: MemoryTest
+#include "../Memory.h"
+#include "Check.h"
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+typedef std::vector<int, TrackedAllocator<int, MEMORY_FLOCKS> > FlockInts;
+
+struct TrackedUnit : public Tracked<MEMORY_UNITS>
+{
+	double payload[8];
+};
+
+int main()
+{
+	int failures = 0;
+
+	/// tags
+	size_t bytes = Memory::bytes(MEMORY_FLOCKS), peak = Memory::peak(MEMORY_FLOCKS);
+	{
+		FlockInts ints;
+		ints.reserve(1000);
+		failures += !check("a container adds what it holds", Memory::bytes(MEMORY_FLOCKS) == bytes + 1000 * sizeof(int)
+			&& Memory::peak(MEMORY_FLOCKS) >= peak + 1000 * sizeof(int));
+		FlockInts more(ints);
+		more.reserve(3000);
+		failures += !check("and another", Memory::bytes(MEMORY_FLOCKS) == bytes + 4000 * sizeof(int));
+	}
+	failures += !check("and takes it back", Memory::bytes(MEMORY_FLOCKS) == bytes
+		&& Memory::peak(MEMORY_FLOCKS) >= bytes + 4000 * sizeof(int));
+	size_t units = Memory::bytes(MEMORY_UNITS);
+	TrackedUnit* unit = new TrackedUnit();
+	failures += !check("an object adds itself", Memory::bytes(MEMORY_UNITS) == units + sizeof(TrackedUnit)
+		&& Memory::bytes(MEMORY_FLOCKS) == bytes);
+	delete unit;
+	failures += !check("and takes itself back", Memory::bytes(MEMORY_UNITS) == units);
+
+	// all at once - the totals are atomic, so they come back to where they started
+	std::vector<std::thread> threads;
+	for (GLuint t = 0; t < 4; t++)
+		threads.push_back(std::thread([] {
+			for (GLuint i = 0; i < 10000; i++)
+			{
+				FlockInts ints(1 + i % 64);
+				delete new TrackedUnit();
+			}
+		}));
+	for (GLuint t = 0; t < threads.size(); t++)
+		threads[t].join();
+	failures += !check("from several threads", Memory::bytes(MEMORY_FLOCKS) == bytes && Memory::bytes(MEMORY_UNITS) == units);
+
+	/// GL objects
+	std::vector<std::string> lines;
+	Memory::trackGL(GL_OBJECT_TEXTURE, 7, 4096);
+	Memory::trackGL(GL_OBJECT_TEXTURE, 8, 1024);
+	Memory::trackGL(GL_OBJECT_TEXTURE, 7, 2048);
+	Memory::trackGL(GL_OBJECT_BUFFER, 7, 512);
+	Memory::trackGL(GL_OBJECT_BUFFER, 0, 512);
+	Memory::report(lines);
+	failures += !check("GL objects by kind", lines.size() == MEMORY_REPORT_LINES
+		&& lines[MEMORY_TAG_COUNT + GL_OBJECT_TEXTURE].find("2 live,      3.0 kB") != std::string::npos
+		&& lines[MEMORY_TAG_COUNT + GL_OBJECT_BUFFER].find("1 live,      0.5 kB") != std::string::npos);
+	Memory::untrackGL(GL_OBJECT_TEXTURE, 7);
+	Memory::untrackGL(GL_OBJECT_TEXTURE, 8);
+	Memory::untrackGL(GL_OBJECT_BUFFER, 7);
+	Memory::report(lines);
+	failures += !check("and gone", lines[MEMORY_TAG_COUNT + GL_OBJECT_TEXTURE].find("0 live") != std::string::npos);
+
+	/// the overlay
+	MemoryReport report;
+	bool formatted = report.update();
+	std::vector<std::string> first(report.lines());
+	const char* flocksLine = report.lines()[MEMORY_FLOCKS].data();
+	failures += !check("the report formats everything the first time", formatted && report.lines() == lines);
+	failures += !check("and nothing when nothing changed", !report.update() && report.lines() == first);
+	{
+		FlockInts ints(256);
+		bool changed = report.update();
+		GLuint differ = 0;
+		for (GLuint i = 0; i < MEMORY_REPORT_LINES; i++)
+			differ += report.lines()[i] != first[i];
+		failures += !check("only the line that changed", changed && differ == 1 && report.lines()[MEMORY_FLOCKS] != first[MEMORY_FLOCKS]
+			&& report.lines()[MEMORY_FLOCKS].data() == flocksLine);
+	}
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+// Records a made up game into a RewindBuffer - a herd walking about, turning, stopping, getting
+// nudged and growing and shrinking, next to state bytes that change a few at a time - and then
+// seeks every tick it still has: scrubbing back a tick at a time, forward again, and jumping about.
+// Every tick has to come back with the state exactly as recorded and every unit within 1/8 of a
+// pixel, the tolerance it's dead reckoned to. It's done twice, once after cutting the recording
+// short with truncate() and recording on from there. The buffer's given a small budget, so old
+// ticks get dropped along the way, and it fails if what it says it uses goes over the budget, or
+// if what the F3 overlay counts against rewind isn't that plus the working copies of the last
+// tick and the cursor, give or take.
+// usage: RewindTest
+#include "../Memory.h"
+#include "../Random.h"
+#include "../RewindBuffer.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+const GLuint TICKS = 60 * 60;
+const GLuint STATE_SIZE = 2000, UNITS = 200;
+const size_t BUDGET = 96 << 10;
+const GLfloat TOLERANCE = 1 / 8.f;
+
+struct Tick
+{
+	vector<unsigned char> state;
+	vector<glm::vec2> positions;
+};
+
+// the game, a tick at a time
+class MadeUpGame
+{
+public:
+	vector<unsigned char> state;
+	vector<glm::vec2> positions, velocities;
+
+	MadeUpGame() : state(STATE_SIZE), positions(UNITS), velocities(UNITS, glm::vec2(0.f)), random(7)
+	{
+		for (GLuint i = 0; i < UNITS; i++)
+			positions[i] = glm::vec2(random.uniform(0.f, 800.f), random.uniform(0.f, 600.f));
+	}
+
+	void tick()
+	{
+		for (GLuint changes = random.below(16); changes > 0; changes--)
+			pick(random, state) = static_cast<unsigned char>(random.next());
+		// the herd grows or shrinks now and again, and the state with it
+		if (random.below(200) == 0)
+		{
+			GLuint size = static_cast<GLuint>(positions.size()) + random.below(20) - 10;
+			positions.resize(size, glm::vec2(400.f, 300.f));
+			velocities.resize(size, glm::vec2(0.f));
+			state.resize(STATE_SIZE + size, 0x5A);
+		}
+		for (GLuint i = 0; i < positions.size(); i++)
+		{
+			GLuint what = random.below(100);
+			if (what == 0)
+				velocities[i] = glm::vec2(random.uniform(-3.f, 3.f), random.uniform(-3.f, 3.f));
+			else if (what == 1)
+				velocities[i] = glm::vec2(0.f);
+			positions[i] += velocities[i];
+			// pushed about by its neighbours
+			if (what == 2)
+				positions[i] += glm::vec2(random.uniform(-.4f, .4f), random.uniform(-.4f, .4f));
+		}
+	}
+private:
+	Random random;
+};
+
+static bool matches(const Tick& expected, const vector<unsigned char>& state, const vector<glm::vec2>& positions)
+{
+	if (state != expected.state || positions.size() != expected.positions.size())
+		return false;
+	for (GLuint i = 0; i < positions.size(); i++)
+		if (fabs(positions[i].x - expected.positions[i].x) > TOLERANCE || fabs(positions[i].y - expected.positions[i].y) > TOLERANCE)
+			return false;
+	return true;
+}
+
+// seeks tick and compares it with what was recorded
+static bool seekAndCheck(RewindBuffer& buffer, const vector<Tick>& history, GLuint tick)
+{
+	vector<unsigned char> state;
+	vector<glm::vec2> positions;
+	if (!buffer.seek(tick, state, positions) || !matches(history[tick], state, positions))
+	{
+		std::cout << "ERROR::REWIND: tick " << tick << " didn't come back as recorded" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+static bool withinBudget(const RewindBuffer& buffer, const MadeUpGame& game)
+{
+	// the last tick and the cursor, each a state and four ints a unit, and a little for the
+	// deque's bookkeeping
+	size_t working = 2 * (game.state.size() + game.positions.size() * 4 * sizeof(GLint)) + 4096;
+	size_t counted = Memory::bytes(MEMORY_REWIND);
+	if (buffer.memoryUsed() > buffer.budget || counted < buffer.memoryUsed() || counted > buffer.memoryUsed() + working)
+	{
+		std::cout << "ERROR::REWIND: " << buffer.memoryUsed() << " bytes used, " << counted
+			<< " counted, against a budget of " << buffer.budget << std::endl;
+		return false;
+	}
+	return true;
+}
+
+// records from game's tick on until TICKS, then seeks every tick the buffer has left
+static bool recordAndSeek(RewindBuffer& buffer, MadeUpGame& game, vector<Tick>& history)
+{
+	bool passed = true;
+	while (history.size() < TICKS)
+	{
+		game.tick();
+		Tick tick = { game.state, game.positions };
+		history.push_back(tick);
+		buffer.record(game.state, game.positions);
+		passed = passed && withinBudget(buffer, game);
+	}
+	if (buffer.lastTick() != TICKS - 1 || buffer.firstTick() == 0)
+	{
+		std::cout << "ERROR::REWIND: kept ticks " << buffer.firstTick() << " to " << buffer.lastTick()
+			<< ", when the budget should have dropped some" << std::endl;
+		return false;
+	}
+	std::cout << "kept ticks " << buffer.firstTick() << " to " << buffer.lastTick() << " in " << buffer.memoryUsed()
+		<< " bytes, " << Memory::bytes(MEMORY_REWIND) << " counted" << std::endl;
+
+	for (GLuint tick = buffer.lastTick(); tick >= buffer.firstTick() && passed; tick--)
+		passed = seekAndCheck(buffer, history, tick);
+	for (GLuint tick = buffer.firstTick(); tick <= buffer.lastTick() && passed; tick++)
+		passed = seekAndCheck(buffer, history, tick);
+	Random jumps(3);
+	for (GLuint i = 0; i < 200 && passed; i++)
+		passed = seekAndCheck(buffer, history, buffer.firstTick() + jumps.below(buffer.lastTick() - buffer.firstTick() + 1));
+	return passed;
+}
+
+int main()
+{
+	int failures = 0;
+	RewindBuffer buffer(BUDGET, TICKS, REWIND_BUFFER_KEYFRAME_INTERVAL);
+	MadeUpGame game;
+	vector<Tick> history;
+	failures += !check("recorded", recordAndSeek(buffer, game, history));
+
+	// back a little way, and carrying on from there - the game goes back with it
+	GLuint back = buffer.lastTick() - 300;
+	vector<unsigned char> state;
+	vector<glm::vec2> positions;
+	buffer.seek(back, state, positions);
+	buffer.truncate(back);
+	history.resize(back + 1);
+	game.state = state;
+	game.positions = positions;
+	failures += !check("truncated and recorded on", recordAndSeek(buffer, game, history));
+
+	return failures ? 1 : 0;
+}
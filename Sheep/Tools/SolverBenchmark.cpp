@@ -0,0 +1,208 @@
+// Compares CollisionSolver with the collision pass UpdateGame had before it, which moved each
+// unit and then pushed it out of every other unit, in storage order - so it tested all n^2 pairs
+// a tick. Both get the same herds, and the same ticks: a packed herd standing on top of itself,
+// pushed apart until no two sheep overlap by more than a pixel, and a herd all ordered to the one
+// point, run until every sheep has stopped. Reported are the pair tests it took, the ticks, the
+// time, and the worst overlap left at the end.
+// After that, the ordered herd is left standing around for a while, and the time CollisionSolver
+// and the unit grid take a tick is reported from before and after the herd falls asleep - the grid
+// is only rebuilt while somebody's awake, the way UpdateGame does it.
+// usage: SolverBenchmark
+#include "../CollisionSolver.h"
+#include "../CollisionUtil.h"
+#include "../Selection.h"
+#include "../SpatialGrid.h"
+#include "../Unit.h"
+#include "../WorkerPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+const GLuint UNITS = 2000, HERD_ROWS = 40;
+const GLfloat WORLD_WIDTH = 4000.f, WORLD_HEIGHT = 3000.f;
+const GLfloat UNIT_SIZE = 50.f, UNIT_VELOCITY = 100.f;
+const GLfloat PACKED_SPACING = 35.f, ORDERED_SPACING = 55.f; // units are 50 across
+const glm::vec2 GOAL = glm::vec2(3000.f, 1500.f);
+const GLfloat SETTLED_OVERLAP = 1.f;
+const GLfloat DELTA_TIME = 1 / 60.f;
+const GLuint MAX_TICKS = 60 * 20;
+const GLuint IDLE_TICKS = 60 * 5;
+const GLuint CELL_SIZE = 100;
+
+enum Herd { PACKED, ORDERED };
+enum Solver { ALL_PAIRS, JACOBI };
+
+struct Result
+{
+	GLuint ticks;				// until the herd settled, MAX_TICKS if it didn't
+	uint64_t pairEvaluations;	// over all of those ticks
+	double ms;
+	GLfloat overlap;			// the worst left between any two sheep
+};
+
+// the pass CollisionSolver replaced, as it was
+static uint64_t allPairs(vector<Unit*>& units, GLfloat dt)
+{
+	uint64_t evaluations = 0;
+	for (unsigned int i = 0; i < units.size(); i++)
+	{
+		units[i]->move(dt);
+		for (unsigned int j = 0; j < units.size(); j++)
+		{
+			if (i == j)
+				continue;
+			evaluations++;
+			if (doesPenetrate(units[i], units[j]))
+			{
+				units[i]->position -= penetrationVector(units[i], units[j]);
+				if (!units[j]->moving)
+				{
+					units[i]->stop();
+					units[j]->stop();
+				}
+			}
+		}
+	}
+	return evaluations;
+}
+
+static GLfloat worstOverlap(const vector<Unit*>& units)
+{
+	GLfloat worst = 0.f;
+	for (GLuint i = 0; i < units.size(); i++)
+		for (GLuint j = i + 1; j < units.size(); j++)
+			worst = std::max(worst, units[i]->radius() + units[j]->radius() - glm::distance(units[i]->position, units[j]->position));
+	return worst;
+}
+
+static vector<Unit*> makeHerd(Herd herd)
+{
+	vector<Unit*> units;
+	GLfloat spacing = herd == PACKED ? PACKED_SPACING : ORDERED_SPACING;
+	for (GLuint i = 0; i < UNITS; i++)
+	{
+		units.push_back(new Unit(glm::vec2(200.f + (i / HERD_ROWS) * spacing, 200.f + (i % HERD_ROWS) * spacing),
+			glm::vec2(UNIT_SIZE, UNIT_SIZE), TextureHandle(), glm::vec4(1.0f), true, 0.0f, UNIT_VELOCITY));
+		if (herd == ORDERED)
+			units[i]->setDestination(GOAL, 0.f);
+	}
+	return units;
+}
+
+static Result run(WorkerPool& pool, Herd herd, Solver solver)
+{
+	typedef std::chrono::steady_clock Clock;
+	vector<Unit*> units = makeHerd(herd);
+
+	Result result = { MAX_TICKS, 0, 0, 0.f };
+	CollisionSolver jacobi(&pool, WORLD_WIDTH, WORLD_HEIGHT, CELL_SIZE);
+	Clock::time_point start = Clock::now();
+	for (GLuint tick = 0; tick < MAX_TICKS; tick++)
+	{
+		if (solver == ALL_PAIRS)
+			result.pairEvaluations += allPairs(units, DELTA_TIME);
+		else
+		{
+			for (GLuint i = 0; i < units.size(); i++)
+				units[i]->move(DELTA_TIME);
+			jacobi.solve(units);
+			result.pairEvaluations += jacobi.pairEvaluations;
+		}
+		GLboolean settled = true;
+		if (herd == PACKED)
+		{
+			// off the clock, as neither solver needs it
+			Clock::time_point paused = Clock::now();
+			settled = worstOverlap(units) <= SETTLED_OVERLAP;
+			start += Clock::now() - paused;
+		}
+		else
+			for (GLuint i = 0; i < units.size() && settled; i++)
+				settled = !units[i]->moving;
+		if (settled)
+		{
+			result.ticks = tick + 1;
+			break;
+		}
+	}
+	result.ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	result.overlap = worstOverlap(units);
+
+	for (GLuint i = 0; i < units.size(); i++)
+		delete units[i];
+	return result;
+}
+
+// the ordered herd, brought to a stop and then left to stand
+static void idle(WorkerPool& pool)
+{
+	typedef std::chrono::steady_clock Clock;
+	vector<Unit*> units = makeHerd(ORDERED);
+	CollisionSolver solver(&pool, WORLD_WIDTH, WORLD_HEIGHT, CELL_SIZE);
+	SpatialGrid grid(WORLD_WIDTH, WORLD_HEIGHT, CELL_SIZE);
+	GLboolean stopped = false;
+	for (GLuint tick = 0; tick < MAX_TICKS && !stopped; tick++)
+	{
+		for (GLuint i = 0; i < units.size(); i++)
+			units[i]->move(DELTA_TIME);
+		solver.solve(units);
+		grid.build(units);
+		stopped = true;
+		for (GLuint i = 0; i < units.size() && stopped; i++)
+			stopped = !units[i]->moving;
+	}
+
+	// <solver, grid> microseconds and ticks, awake and asleep
+	double solveUs[2] = { 0, 0 }, gridUs[2] = { 0, 0 };
+	GLuint ticks[2] = { 0, 0 }, asleepAt = 0;
+	for (GLuint tick = 0; tick < IDLE_TICKS; tick++)
+	{
+		Clock::time_point start = Clock::now();
+		for (GLuint i = 0; i < units.size(); i++)
+			units[i]->move(DELTA_TIME);
+		solver.solve(units);
+		Clock::time_point solved = Clock::now();
+		if (solver.awakeCount() > 0)
+			grid.build(units);
+		Clock::time_point built = Clock::now();
+		GLuint asleep = solver.awakeCount() == 0 ? 1 : 0;
+		if (asleep && !ticks[1])
+			asleepAt = tick;
+		solveUs[asleep] += std::chrono::duration<double, std::micro>(solved - start).count();
+		gridUs[asleep] += std::chrono::duration<double, std::micro>(built - solved).count();
+		ticks[asleep]++;
+	}
+
+	std::cout << std::endl << "idle herd,ticks,solver us per tick,grid us per tick" << std::endl;
+	const char* states[] = { "awake", "asleep" };
+	for (GLuint state = 0; state < 2; state++)
+		std::cout << states[state] << ',' << ticks[state] << ',' << (ticks[state] ? solveUs[state] / ticks[state] : 0) << ','
+			<< (ticks[state] ? gridUs[state] / ticks[state] : 0) << std::endl;
+	std::cout << "(asleep " << asleepAt << " ticks after stopping)" << std::endl;
+	for (GLuint i = 0; i < units.size(); i++)
+		delete units[i];
+}
+
+int main()
+{
+	GLuint cores = std::max(2u, std::thread::hardware_concurrency());
+	WorkerPool pool(cores - 2);
+	std::cout << "herd,solver,ticks to settle,pair evaluations,pair evaluations per tick,ms,worst overlap" << std::endl;
+	for (GLuint herd = PACKED; herd <= ORDERED; herd++)
+		for (GLuint solver = ALL_PAIRS; solver <= JACOBI; solver++)
+		{
+			Result result = run(pool, static_cast<Herd>(herd), static_cast<Solver>(solver));
+			std::cout << (herd == PACKED ? "packed" : "ordered") << ',' << (solver == JACOBI ? "jacobi" : "all pairs") << ',';
+			if (result.ticks < MAX_TICKS)
+				std::cout << result.ticks;
+			else
+				std::cout << "over " << MAX_TICKS;
+			std::cout << ',' << result.pairEvaluations << ',' << result.pairEvaluations / result.ticks << ','
+				<< result.ms << ',' << result.overlap << std::endl;
+		}
+	idle(pool);
+	return 0;
+}
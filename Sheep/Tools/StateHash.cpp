@@ -0,0 +1,46 @@
+// Plays a game headless - no window, nothing drawn - from a seed, and prints Game::stateHash once
+// a second of game time and once at the end. The game is the one in Headless.h, so the solver,
+// steering and flow fields all get crowds to work on, next to the hazards and power ups. Two builds
+// that print the same lines for the same arguments played the same game; the first line that
+// differs is about when they drifted apart. The game stops once the herd is down to its last few,
+// like it would.
+// usage: StateHash [ticks] [seed] [simple|normal]
+#include "Headless.h"
+
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+const GLuint TICKS_PER_HASH = 60;
+
+static void printHash(GLuint tick)
+{
+	std::cout << tick << ' ' << std::hex << std::setw(16) << std::setfill('0') << Game::stateHash
+		<< std::dec << ' ' << Game::units.size() << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	GLuint ticks = argc > 1 ? static_cast<GLuint>(atoi(argv[1])) : 60 * 60;
+	uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+	if (!ticks || (argc > 3 && strcmp(argv[3], "simple") && strcmp(argv[3], "normal")))
+	{
+		std::cout << "usage: " << argv[0] << " [ticks] [seed] [simple|normal]" << std::endl;
+		return 1;
+	}
+	startHeadless(seed, argc > 3 && !strcmp(argv[3], "normal") ? NORMAL : SIMPLE);
+
+	Random orders(seed);
+	GLuint tick = 0;
+	for (; tick < ticks && Game::State != GAME_END; tick++)
+	{
+		orderHeadless(orders, tick);
+		Game::UpdateGame(HEADLESS_DELTA_TIME);
+		if ((tick + 1) % TICKS_PER_HASH == 0)
+			printHash(tick + 1);
+	}
+	if (tick % TICKS_PER_HASH)
+		printHash(tick);
+	return 0;
+}
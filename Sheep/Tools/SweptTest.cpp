@@ -0,0 +1,155 @@
+// Fires fast units at thin and standing ones, with ticks a tenth of a second long - six times what
+// the game runs at, and long enough for them to cover more than their own width, and a thin unit's
+// too, in one tick. They're run through CollisionSolver the way UpdateGame runs them, and the test
+// fails if any of them ends up on the far side of what it was fired at. Each case is checked to
+// really be one a discrete overlap test would miss, by the mover's positions straddling the target
+// without overlapping it. sweptPenetrate is checked on its own first, power ups included.
+// usage: SweptTest
+#include "../CollisionSolver.h"
+#include "../CollisionUtil.h"
+#include "../Selection.h"
+#include "../Unit.h"
+#include "../WorkerPool.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+const GLfloat WORLD_WIDTH = 2000.f, WORLD_HEIGHT = 1000.f;
+const GLfloat DELTA_TIME = 1 / 10.f;
+const GLuint TICKS = 30;
+
+static Unit* unit(glm::vec2 position, GLfloat size, GLfloat velocity)
+{
+	return new Unit(position, glm::vec2(size, size), TextureHandle(), glm::vec4(1.0f), true, 0.0f, velocity);
+}
+
+static bool near(GLfloat a, GLfloat b)
+{
+	return fabs(a - b) < 1e-4f;
+}
+
+// a few ticks of UpdateGame with the clock stopped - movers and targets both
+static void tick(vector<Unit*>& units, CollisionSolver& solver)
+{
+	for (GLuint i = 0; i < units.size(); i++)
+		units[i]->move(DELTA_TIME);
+	solver.solve(units);
+}
+
+// the movers (the units from first on) fired right, at the targets before them - true if none got
+// past the target column at targetX, and if the discrete test would have let at least one through
+static bool fire(WorkerPool& pool, vector<Unit*>& units, GLuint first, GLfloat targetX, GLboolean letSleep)
+{
+	CollisionSolver solver(&pool, WORLD_WIDTH, WORLD_HEIGHT, 100.f);
+	if (letSleep)
+	{
+		// nobody's been ordered yet, so everybody settles
+		for (GLuint t = 0; t < 4 * SOLVER_SLEEP_TICKS && solver.awakeCount() > 0; t++)
+			tick(units, solver);
+		if (solver.awakeCount() > 0)
+		{
+			std::cout << "ERROR::SWEPT: the targets never fell asleep" << std::endl;
+			return false;
+		}
+	}
+	for (GLuint i = first; i < units.size(); i++)
+		units[i]->setDestination(glm::vec2(WORLD_WIDTH - 100.f, units[i]->position.y), 0.f);
+
+	bool held = true, wouldTunnel = false;
+	for (GLuint t = 0; t < TICKS; t++)
+	{
+		// where the movers would go unhindered this tick, and whether that skips the target
+		for (GLuint i = first; i < units.size(); i++)
+		{
+			GLfloat reach = units[i]->radius() + units[0]->radius();
+			GLfloat from = units[i]->position.x, to = from + units[i]->velocity * DELTA_TIME;
+			if (units[i]->moving && from < targetX - reach && to > targetX + reach)
+				wouldTunnel = true;
+		}
+		tick(units, solver);
+		for (GLuint i = first; i < units.size(); i++)
+			if (units[i]->position.x > targetX)
+				held = false;
+	}
+	if (!wouldTunnel)
+		std::cout << "ERROR::SWEPT: nothing here would have tunnelled - the case tests nothing" << std::endl;
+	return held && wouldTunnel;
+}
+
+int main()
+{
+	WorkerPool pool(2);
+	int failures = 0;
+
+	/// sweptPenetrate
+	GLfloat time = -1.f;
+	// 200 across a radius 5 circle centered at 100 - they touch once the mover's 70 along
+	failures += !check("head on", sweptPenetrate(glm::vec2(0.f), glm::vec2(200.f, 0.f), 25.f,
+		glm::vec2(100.f, 0.f), glm::vec2(100.f, 0.f), 5.f, time) && near(time, 70.f / 200.f));
+	failures += !check("passing by", !sweptPenetrate(glm::vec2(0.f), glm::vec2(200.f, 0.f), 25.f,
+		glm::vec2(100.f, 31.f), glm::vec2(100.f, 31.f), 5.f, time));
+	failures += !check("overlapping from the start", sweptPenetrate(glm::vec2(0.f), glm::vec2(200.f, 0.f), 25.f,
+		glm::vec2(10.f, 0.f), glm::vec2(10.f, 0.f), 5.f, time) && time == 0.f);
+	failures += !check("stopping short", !sweptPenetrate(glm::vec2(0.f), glm::vec2(60.f, 0.f), 25.f,
+		glm::vec2(100.f, 0.f), glm::vec2(100.f, 0.f), 5.f, time));
+	// both moving, 100 a tick each way, 150 apart - 50 of it closed, at a closing speed of 200
+	failures += !check("both moving", sweptPenetrate(glm::vec2(0.f), glm::vec2(100.f, 0.f), 25.f,
+		glm::vec2(200.f, 0.f), glm::vec2(100.f, 0.f), 25.f, time) && near(time, .75f));
+	// a sheep walking clean over a power up in one tick, the way UpdateGame tests them
+	failures += !check("over a power up", sweptPenetrate(glm::vec2(0.f, 10.f), glm::vec2(150.f, 10.f), 25.f,
+		glm::vec2(75.f, 0.f), glm::vec2(75.f, 0.f), 25.f, time) && time > 0.f && time < 1.f);
+
+	/// through the solver
+	// a thin standing unit, 10 across, and a sheep at 1000 a second - 100 a tick, so from 600 it
+	// would land at 700, either side of it
+	vector<Unit*> units;
+	units.push_back(unit(glm::vec2(650.f, 500.f), 10.f, 100.f));
+	units.push_back(unit(glm::vec2(100.f, 500.f), 50.f, 1000.f));
+	failures += !check("fast sheep at a thin one", fire(pool, units, 1, 650.f, false));
+	for (GLuint i = 0; i < units.size(); i++)
+		delete units[i];
+
+	// a column of standing sheep, and a row of even faster ones fired at it, four widths a tick
+	units.clear();
+	for (GLfloat y = 100.f; y <= 900.f; y += 50.f)
+		units.push_back(unit(glm::vec2(1000.f, y), 50.f, 100.f));
+	GLuint first = static_cast<GLuint>(units.size());
+	for (GLuint i = 0; i < 8; i++)
+		units.push_back(unit(glm::vec2(100.f + i * 37.f, 150.f + i * 100.f), 50.f, 2000.f));
+	failures += !check("fast sheep at a standing column", fire(pool, units, first, 1000.f, false));
+	for (GLuint i = 0; i < units.size(); i++)
+		delete units[i];
+
+	// the same, with the column asleep by the time they get there
+	units.clear();
+	for (GLfloat y = 100.f; y <= 900.f; y += 50.f)
+		units.push_back(unit(glm::vec2(1000.f, y), 50.f, 100.f));
+	first = static_cast<GLuint>(units.size());
+	for (GLuint i = 0; i < 8; i++)
+		units.push_back(unit(glm::vec2(100.f + i * 37.f, 150.f + i * 100.f), 50.f, 2000.f));
+	failures += !check("fast sheep at a sleeping column", fire(pool, units, first, 1000.f, true));
+	for (GLuint i = 0; i < units.size(); i++)
+		delete units[i];
+
+	// two fast sheep head on - 150 a tick each, so 300 closer a tick, from 1000 apart
+	units.clear();
+	units.push_back(unit(glm::vec2(500.f, 500.f), 50.f, 1500.f));
+	units.push_back(unit(glm::vec2(1500.f, 500.f), 50.f, 1500.f));
+	units[0]->setDestination(glm::vec2(1900.f, 500.f), 0.f);
+	units[1]->setDestination(glm::vec2(100.f, 500.f), 0.f);
+	CollisionSolver solver(&pool, WORLD_WIDTH, WORLD_HEIGHT, 100.f);
+	bool kept = true;
+	for (GLuint t = 0; t < TICKS; t++)
+	{
+		tick(units, solver);
+		kept = kept && units[0]->position.x < units[1]->position.x;
+	}
+	failures += !check("fast sheep head on", kept);
+	for (GLuint i = 0; i < units.size(); i++)
+		delete units[i];
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+// Plays the headless game from Headless.h, 60 ticks a second like Simulation runs it, and times
+// every tick the way TickGame does - the update and the Telemetry::commit after it - with telemetry
+// streamed to file, or off without one. Run it both ways on the same seed to compare. Reported are the time a tick takes, and the time commit
+// takes on its own, on average and at worst - the worst is where a write of a full block would
+// show up, if it held up the tick.
+// usage: TelemetryOverhead [ticks] [seed] [file]
+#include "Headless.h"
+#include "../Telemetry.h"
+
+#include <chrono>
+#include <iostream>
+#include <stdlib.h>
+#include <thread>
+
+int main(int argc, char* argv[])
+{
+	typedef std::chrono::steady_clock Clock;
+	GLuint ticks = argc > 1 ? static_cast<GLuint>(atoi(argv[1])) : 60 * 60;
+	uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1;
+	if (!ticks)
+	{
+		std::cout << "usage: " << argv[0] << " [ticks] [seed] [file]" << std::endl;
+		return 1;
+	}
+	if (argc > 3 && !Telemetry::open(argv[3]))
+		return 1;
+	startHeadless(seed, NORMAL);
+
+	Random orders(seed);
+	double tickUs = 0, commitUs = 0, worstCommitUs = 0;
+	Clock::time_point nextTick = Clock::now();
+	GLuint tick = 0;
+	for (; tick < ticks && Game::State != GAME_END; tick++)
+	{
+		nextTick += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<GLfloat>(HEADLESS_DELTA_TIME));
+		std::this_thread::sleep_until(nextTick);
+		orderHeadless(orders, tick);
+		Clock::time_point start = Clock::now();
+		Game::UpdateGame(HEADLESS_DELTA_TIME);
+		Clock::time_point updated = Clock::now();
+		Telemetry::commit();
+		Clock::time_point committed = Clock::now();
+		double commit = std::chrono::duration<double, std::micro>(committed - updated).count();
+		tickUs += std::chrono::duration<double, std::micro>(committed - start).count();
+		commitUs += commit;
+		worstCommitUs = std::max(worstCommitUs, commit);
+	}
+	Telemetry::close();
+
+	std::cout << "telemetry,ticks,us per tick,commit us per tick,worst commit us" << std::endl;
+	std::cout << (argc > 3 ? "on" : "off") << ',' << tick << ',' << tickUs / tick << ',' << commitUs / tick << ','
+		<< worstCommitUs << std::endl;
+	return 0;
+}
@@ -0,0 +1,83 @@
+// Streams records through Telemetry the way the game does, and reads the file back. Every record
+// committed has to be there, in order and as it was filled in - the blocks the writer thread
+// writes out, and the part block close() hands it at the end - including when the ticks come much
+// faster than the writer checks for blocks, so the simulation has to wait on it now and again. A
+// second file is opened after the first is closed, to check the writer starts over cleanly.
+// usage: TelemetryTest [file]
+#include "../Telemetry.h"
+#include "Check.h"
+
+#include <iostream>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+static void fill(TelemetryRecord& record, uint32_t tick)
+{
+	record.gameTime = tick / 60.f;
+	record.tickDuration = .001f;
+	record.units = tick % 97;
+	record.movingUnits = tick % 13;
+	record.kills = tick % 3;
+	record.pairEvaluations = tick * 7;
+	record.stateHash = 0x9E3779B97F4A7C15ULL * (tick + 1);
+}
+
+// commits count records, a millisecond apart when paced, and checks the file holds them all
+static bool roundTrip(const char* path, uint32_t count, bool paced)
+{
+	if (!Telemetry::open(path))
+		return false;
+	for (uint32_t tick = 0; tick < count; tick++)
+	{
+		fill(Telemetry::current, tick);
+		Telemetry::commit();
+		if (paced)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	Telemetry::close();
+
+	FILE* file = fopen(path, "rb");
+	if (!file)
+	{
+		std::cout << "ERROR::TELEMETRY: " << path << " wasn't written" << std::endl;
+		return false;
+	}
+	TelemetryHeader header;
+	std::vector<TelemetryRecord> records(count + 1);
+	bool read = fread(&header, sizeof(header), 1, file) == 1;
+	size_t found = read ? fread(records.data(), sizeof(TelemetryRecord), records.size(), file) : 0;
+	fclose(file);
+	if (!read || memcmp(header.magic, "SHTL", 4) || header.version != TELEMETRY_VERSION
+		|| header.recordSize != sizeof(TelemetryRecord)
+		|| found != count)
+	{
+		std::cout << "ERROR::TELEMETRY: " << found << " records in " << path << ", not " << count << std::endl;
+		return false;
+	}
+	for (uint32_t tick = 0; tick < count; tick++)
+	{
+		TelemetryRecord expected;
+		memset(&expected, 0, sizeof(expected));
+		fill(expected, tick);
+		expected.tick = tick;
+		if (memcmp(&expected, &records[tick], sizeof(expected)))
+		{
+			std::cout << "ERROR::TELEMETRY: record " << tick << " came back different" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	std::string path = argc > 1 ? argv[1] : "telemetry_test.bin";
+	int failures = 0;
+	failures += !check("a part block", roundTrip(path.c_str(), 100, false));
+	failures += !check("blocks, as fast as they come", roundTrip(path.c_str(), 20 * TELEMETRY_BUFFER_RECORDS + 37, false));
+	failures += !check("blocks, paced", roundTrip(path.c_str(), 3 * TELEMETRY_BUFFER_RECORDS + 1, true));
+	failures += !check("whole blocks only", roundTrip(path.c_str(), 2 * TELEMETRY_BUFFER_RECORDS, false));
+	remove(path.c_str());
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,50 @@
+// Turns a telemetry file written by the game into CSV, one row per tick.
+// usage: TelemetryToCsv <telemetry file> [csv file]   (the CSV goes to stdout without one)
+#include "../Telemetry.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <string.h>
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: " << argv[0] << " <telemetry file> [csv file]" << std::endl;
+		return 1;
+	}
+	std::ifstream in(argv[1], std::ios::binary);
+	TelemetryHeader header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || memcmp(header.magic, "SHTL", 4) != 0)
+	{
+		std::cout << "ERROR::TELEMETRY: " << argv[1] << " is not a telemetry file" << std::endl;
+		return 1;
+	}
+	if (header.version != TELEMETRY_VERSION || header.recordSize != sizeof(TelemetryRecord))
+	{
+		std::cout << "ERROR::TELEMETRY: " << argv[1] << " was written by another version of the game" << std::endl;
+		return 1;
+	}
+	std::ofstream file;
+	if (argc > 2)
+		file.open(argv[2]);
+	std::ostream& out = argc > 2 ? file : std::cout;
+
+	out << "tick,gameTime,tickDuration,units,movingUnits,lazers,rockets,powerUps,kills,pairEvaluations,stateHash\n";
+	// a few thousand ticks at a time - a game that ran for hours makes a big file
+	std::vector<TelemetryRecord> records(4096);
+	while (in)
+	{
+		in.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(TelemetryRecord));
+		size_t count = static_cast<size_t>(in.gcount()) / sizeof(TelemetryRecord);
+		for (size_t i = 0; i < count; i++)
+		{
+			const TelemetryRecord& r = records[i];
+			out << r.tick << ',' << r.gameTime << ',' << r.tickDuration << ',' << r.units << ',' << r.movingUnits << ','
+				<< r.lazers << ',' << r.rockets << ',' << r.powerUps << ',' << r.kills << ',' << r.pairEvaluations << ','
+				<< std::hex << r.stateHash << std::dec << '\n';
+		}
+	}
+	return 0;
+}
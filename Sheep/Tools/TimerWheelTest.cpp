@@ -0,0 +1,139 @@
+// Runs a TimerWheel against a plain list of timers that's searched through every tick, with
+// thousands of timers set at random from a tick to over an hour ahead - so they're cascaded down
+// from every level - cancelled at random along the way, and the clock moved on by uneven steps.
+// Both have to fire the same events on the same ticks, in the order they were scheduled. Ids are
+// checked on their own first: one goes stale once its timer fires or is cancelled, and stays stale
+// when its node is reused, so cancelling it again leaves the new timer alone. Last, a timer past
+// the top level's reach goes around and still fires on its tick.
+// usage: TimerWheelTest
+#include "../Random.h"
+#include "../TimerWheel.h"
+#include "Check.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+const GLfloat RESOLUTION = 1 / 60.f;
+const GLuint TICKS = 60 * 60 * 8;
+const GLuint MAX_AHEAD = 60 * 60 * 70; // past 64^3 ticks, so the top level is used too
+
+static GLfloat timeOf(uint64_t tick)
+{
+	return static_cast<GLfloat>(tick) * RESOLUTION;
+}
+
+// the timer as the list keeps it
+struct Expected
+{
+	uint64_t tick;
+	TimerId id;
+	GLuint sequence;
+	GLboolean live;
+};
+
+static bool againstList()
+{
+	TimerWheel wheel(RESOLUTION);
+	vector<Expected> list;
+	vector<TimerEvent> fired;
+	Random random(11);
+	uint64_t now = 0;
+	GLuint sequence = 0, firedCount = 0;
+	while (now < TICKS)
+	{
+		// a few new timers, and a few old ones cancelled - some of those have fired already
+		for (GLuint i = random.below(6); i > 0; i--)
+		{
+			GLuint ahead = random.below(4) ? random.below(200) : random.below(MAX_AHEAD);
+			Expected timer = { now + std::max(ahead, 1u), 0, sequence, true };
+			timer.id = wheel.schedule(timeOf(timer.tick), 0, sequence++);
+			list.push_back(timer);
+		}
+		for (GLuint i = random.below(3); i > 0 && !list.empty(); i--)
+		{
+			Expected& timer = pick(random, list);
+			if (timer.live != wheel.pending(timer.id))
+			{
+				std::cout << "ERROR::TIMER_WHEEL: timer " << timer.sequence << " pending is wrong" << std::endl;
+				return false;
+			}
+			wheel.cancel(timer.id);
+			timer.live = false;
+		}
+
+		uint64_t next = now + 1 + random.below(random.below(10) ? 3 : 200);
+		fired.clear();
+		wheel.advance(timeOf(next), fired);
+		// what should have fired, by tick and then by when it was scheduled
+		vector<Expected> due;
+		for (GLuint i = 0; i < list.size(); i++)
+			if (list[i].live && list[i].tick <= next)
+			{
+				due.push_back(list[i]);
+				list[i].live = false;
+			}
+		std::sort(due.begin(), due.end(), [](const Expected& a, const Expected& b)
+			{ return a.tick != b.tick ? a.tick < b.tick : a.sequence < b.sequence; });
+		if (fired.size() != due.size())
+		{
+			std::cout << "ERROR::TIMER_WHEEL: " << fired.size() << " fired by tick " << next << ", not " << due.size() << std::endl;
+			return false;
+		}
+		for (GLuint i = 0; i < due.size(); i++)
+			if (fired[i].target != due[i].sequence)
+			{
+				std::cout << "ERROR::TIMER_WHEEL: timer " << fired[i].target << " fired by tick " << next
+					<< " in place of timer " << due[i].sequence << std::endl;
+				return false;
+			}
+		firedCount += static_cast<GLuint>(due.size());
+		now = next;
+		// fired and cancelled ones are done with
+		list.erase(std::remove_if(list.begin(), list.end(), [](const Expected& timer) { return !timer.live; }), list.end());
+		if (wheel.size() != list.size())
+		{
+			std::cout << "ERROR::TIMER_WHEEL: " << wheel.size() << " pending, not " << list.size() << std::endl;
+			return false;
+		}
+	}
+	std::cout << sequence << " scheduled, " << firedCount << " fired, " << list.size() << " left" << std::endl;
+	return true;
+}
+
+int main()
+{
+	int failures = 0;
+
+	/// ids
+	TimerWheel wheel(RESOLUTION);
+	vector<TimerEvent> fired;
+	TimerId first = wheel.schedule(timeOf(10), 1, 100);
+	wheel.cancel(first);
+	TimerId second = wheel.schedule(timeOf(10), 2, 200);
+	failures += !check("a cancelled id goes stale", !wheel.pending(first) && wheel.pending(second) && first != second);
+	wheel.cancel(first);
+	failures += !check("and cancelling it again leaves its node's next timer alone", wheel.pending(second) && wheel.size() == 1);
+	wheel.advance(timeOf(10), fired);
+	TimerId third = wheel.schedule(timeOf(20), 3, 300);
+	wheel.cancel(second);
+	failures += !check("a fired id goes stale", fired.size() == 1 && fired[0].target == 200 && !wheel.pending(second) && wheel.pending(third));
+	wheel.cancel(TIMER_NONE);
+	failures += !check("no timer's fine to cancel", wheel.size() == 1);
+
+	/// against the list
+	failures += !check("against a list", againstList());
+
+	/// past the top level
+	// in ticks of a second, as floats only hit every other tick out there
+	TimerWheel distant(1.f);
+	fired.clear();
+	uint64_t far = (uint64_t(1) << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) + 1024;
+	distant.schedule(static_cast<GLfloat>(far), 4, 400);
+	distant.advance(static_cast<GLfloat>(far - 2), fired);
+	bool early = !fired.empty();
+	distant.advance(static_cast<GLfloat>(far), fired);
+	failures += !check("past the top level's reach", !early && fired.size() == 1 && fired[0].target == 400);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,43 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// Passes values from one writer thread to one reader thread without either side ever waiting
+// on the other. The writer fills back() and publish()es it, and the reader calls update() to
+// pick up the newest published value before reading front(). One slot belongs to each side and
+// the third is the one being passed between them, so a reader that falls behind just skips
+// values, and the writer never touches what's being read.
+template <typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer(const T& initial)
+		: slots{ initial, initial, initial }, middle(1), backIndex(2), frontIndex(0) {}
+
+	// writer side
+	T& back() { return slots[backIndex]; }
+	void publish()
+	{
+		backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX;
+	}
+	// reader side - returns whether there was anything new
+	bool update()
+	{
+		if (!(middle.load(std::memory_order_relaxed) & FRESH))
+			return false;
+		frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX;
+		return true;
+	}
+	T& front() { return slots[frontIndex]; }
+private:
+	static const unsigned int INDEX = 3;  // bits of middle that hold the slot index
+	static const unsigned int FRESH = 4;  // set in middle when it was published after the reader last looked
+	T slots[3];
+	std::atomic<unsigned int> middle;
+	unsigned int backIndex, frontIndex;
+	TripleBuffer(const TripleBuffer&);
+	TripleBuffer& operator=(const TripleBuffer&);
+};
+
+#endif
@@ -1,51 +1,133 @@
+#include "StrictFloat.h"
 #include "Unit.h"
 #include <iostream>
 
-Unit::Unit(glm::vec2 argPos, glm::vec2 argSize, Texture2D argSprite, glm::vec4 argColor, GLboolean argDraw, GLfloat argRotation, GLfloat argVelocity)
+GLuint Unit::nextId = 0;
+vector<GLuint> Unit::freeIds;
+
+Unit::Unit(glm::vec2 argPos, glm::vec2 argSize, TextureHandle argSprite, glm::vec4 argColor, GLboolean argDraw, GLfloat argRotation, GLfloat argVelocity)
 	: velocity(argVelocity)
 {
 	position = argPos;
+	prevPosition = argPos;
 	size = argSize;
 	sprite = argSprite;
 	color = argColor;
 	rotation = argRotation;
 	bDraw = argDraw;
+	// reusing ids keeps them, and the selection bitset, as small as the herd
+	if (freeIds.empty())
+		id = nextId++;
+	else
+	{
+		id = freeIds.back();
+		freeIds.pop_back();
+	}
+}
+
+Unit::~Unit()
+{
+	// the next unit to get this id mustn't start out selected
+	Selection::remove(this);
+	freeIds.push_back(id);
+}
+
+void Unit::saveIds(GLuint& argNextId, vector<GLuint>& argFreeIds)
+{
+	argNextId = nextId;
+	argFreeIds = freeIds;
+}
+
+void Unit::restoreIds(GLuint argNextId, const vector<GLuint>& argFreeIds)
+{
+	nextId = argNextId;
+	freeIds = argFreeIds;
 }
 
 // movement
-void Unit::setDestination(glm::vec2 argDestination)
+void Unit::setDestination(glm::vec2 argDestination, GLfloat argTime)
 {
 	// argDestination -= glm::vec2(radius(), radius());
+	flowField.reset();
 	if (position != argDestination)
 	{
 		destination = argDestination;
-		angle = -atan2(destination.y - position.y, destination.x - position.x);
-		movementVector = glm::vec2(cos(angle),sin(angle));
+		aim();
+		// start walking, unless we're already mid-stride
+		if (!moving)
+			animation = SpriteAnimation(argTime, UNIT_WALK_FRAMES, UNIT_WALK_FRAME_DURATION, ANIMATION_LOOP);
 		moving = true;
 	}
 }
 
+void Unit::setDestination(glm::vec2 argDestination, GLfloat argTime, shared_ptr<FlowField> argFlowField)
+{
+	setDestination(argDestination, argTime);
+	if (moving)
+		flowField = argFlowField;
+}
+
+void Unit::aim()
+{
+	Scalar offsetX = toScalar(destination.x) - toScalar(position.x), offsetY = toScalar(destination.y) - toScalar(position.y);
+	angle = toFloat(-simAtan2(offsetY, offsetX));
+	// pointing along the angle is just the offset, normalised - movementVector is y up
+	Scalar directionX, directionY;
+	simDirection(offsetX, offsetY, directionX, directionY);
+	movementVector = glm::vec2(toFloat(directionX), toFloat(-directionY));
+}
+
+void Unit::followFlowField(GLfloat deltaTime)
+{
+	// the last stretch is walked straight, as the field's cells are too coarse to get there
+	if (flowField->nearGoal(position))
+	{
+		flowField.reset();
+		aim();
+		return;
+	}
+	glm::vec2 direction = flowField->direction(position);
+	angle = toFloat(-simAtan2(toScalar(direction.y), toScalar(direction.x)));
+	Scalar directionX, directionY;
+	simDirection(toScalar(direction.x), toScalar(direction.y), directionX, directionY);
+	movementVector = glm::vec2(toFloat(directionX), toFloat(-directionY));
+	Scalar speed = toScalar(velocity) * toScalar(speedScale), dt = toScalar(deltaTime);
+	position.x = toFloat(toScalar(position.x) + (toScalar(direction.x) * speed + toScalar(steering.x)) * dt);
+	position.y = toFloat(toScalar(position.y) + (toScalar(direction.y) * speed + toScalar(steering.y)) * dt);
+}
+
 void Unit::move(GLfloat deltaTime)
 {
-	glm::vec2 velocityVector = movementVector * velocity * deltaTime;
+	prevPosition = position;
+	if (moving && flowField)
+	{
+		followFlowField(deltaTime);
+		return;
+	}
+	Scalar dt = toScalar(deltaTime);
+	Scalar step = toScalar(velocity) * toScalar(speedScale) * dt;
+	glm::vec2 velocityVector = glm::vec2(toFloat(toScalar(movementVector.x) * step), toFloat(toScalar(movementVector.y) * step));
 	if (moving)
 	{
 		if (position.x < destination.x)
 		{
-			position.x = std::min(position.x + velocityVector.x, destination.x);
+			position.x = std::min(toFloat(toScalar(position.x) + toScalar(velocityVector.x)), destination.x);
 		}
 		else if (position.x > destination.x)
 		{
-			position.x = std::max(position.x + velocityVector.x, destination.x);
+			position.x = std::max(toFloat(toScalar(position.x) + toScalar(velocityVector.x)), destination.x);
 		}
 		if (position.y < destination.y)
 		{
-			position.y = std::min(position.y - velocityVector.y, destination.y);
+			position.y = std::min(toFloat(toScalar(position.y) - toScalar(velocityVector.y)), destination.y);
 		}
 		else if (position.y > destination.y)
 		{
-			position.y = std::max(position.y - velocityVector.y, destination.y);
+			position.y = std::max(toFloat(toScalar(position.y) - toScalar(velocityVector.y)), destination.y);
 		}
+		// sideways nudges from local steering - they don't count against the heading below
+		position.x = toFloat(toScalar(position.x) + toScalar(steering.x) * dt);
+		position.y = toFloat(toScalar(position.y) + toScalar(steering.y) * dt);
 		if ((position.x < destination.x && velocityVector.x < 0)
 			|| (position.x > destination.x && velocityVector.x > 0)
 			|| (position.y < destination.y && velocityVector.y > 0)
@@ -57,31 +139,38 @@ void Unit::move(GLfloat deltaTime)
 void Unit::stop()
 {
 	moving = false;
+	flowField.reset();
+	steering = glm::vec2(0.f);
+	speedScale = 1.f;
 	sampleFrame = 0;
+	animation = SpriteAnimation();
 }
 
 // selection
 void Unit::select()
 {
-	selected = true;
-	color = glm::vec4(0.7f, 0.7f, 1.0f, 1.0f);
+	Selection::add(this);
 }
 void Unit::deselect()
 {
-	selected = false;
-	color = glm::vec4(1.0f);
+	Selection::remove(this);
+}
+GLboolean Unit::isSelected()
+{
+	return Selection::contains(id);
 }
 
 // rendering
 void Unit::draw(SpriteRenderer& renderer)
 {
 	if (bDraw)
-		renderer.DrawSprite(this->sprite, this->position, this->size, this->rotation, this->color);
+		renderer.DrawSprite(this->sprite, this->position, this->size, this->rotation,
+			isSelected() ? UNIT_SELECTED_COLOR : this->color);
 }
 
 void Unit::draw(SpriteRenderer & renderer, glm::vec2 argSampleDivider, GLint argSampleIndex)
 {
 	if (bDraw)
-		renderer.DrawSprite(this->sprite, this->position, this->size, this->rotation, this->color, 
-			argSampleDivider, argSampleIndex, (abs(angle) > M_PI /2), false);
+		renderer.DrawSprite(this->sprite, this->position, this->size, this->rotation,
+			isSelected() ? UNIT_SELECTED_COLOR : this->color, argSampleDivider, argSampleIndex, (abs(angle) > M_PI /2), false, this->animation);
 }
@@ -4,9 +4,13 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
-#include "Texture2D.h"
+#include "TextureHandle.h"
 #include "SpriteRenderer.h"
 #include "Drawable.h"
+#include "Selection.h"
+#include "FlowField.h"
+#include "Fixed.h"
+#include "Memory.h"
 
 #ifndef _USE_MATH_DEFINES
 #define _USE_MATH_DEFINES
@@ -14,33 +18,62 @@
 
 #include <math.h>
 #include <algorithm>
+#include <memory>
 
 using namespace std;
 
-class Unit : public Drawable
+// walking animation, in SheepAnimated.png
+const GLint UNIT_WALK_FRAMES = 7;
+const GLfloat UNIT_WALK_FRAME_DURATION = .1f;
+// tint of selected units
+const glm::vec4 UNIT_SELECTED_COLOR = glm::vec4(0.7f, 0.7f, 1.0f, 1.0f);
+
+class Unit : public Drawable, public Tracked<MEMORY_UNITS>
 {
 public:
 	// variables
+	GLuint id; // unique among living units, and reused once the unit dies
 	GLfloat velocity;
 	GLboolean moving = false;
-	GLboolean selected = false;
 	glm::vec2 movementVector; 
 	GLfloat angle = 0.0;
 	glm::vec2 destination;
+	glm::vec2 prevPosition; // where the unit was before this tick's move, for swept collision
+	shared_ptr<FlowField> flowField; // when set, followed toward destination instead of walking straight
+	glm::vec2 steering = glm::vec2(0.f); // velocity added on top of the heading, from Steering
+	GLfloat speedScale = 1.f;			 // fraction of velocity to walk at, from Steering
+	// sleeping - managed by CollisionSolver
+	GLboolean asleep = false;
+	GLuint restTicks = 0; // ticks the unit has stood still for
+	GLuint island = 0;	  // the group of sleeping units it wakes up with
 
 	// constructors
-	Unit(glm::vec2 pos, glm::vec2 size, Texture2D sprite, glm::vec4 color, GLboolean argDraw, GLfloat argRotation, GLfloat velocity);
+	Unit(glm::vec2 pos, glm::vec2 size, TextureHandle sprite, glm::vec4 color, GLboolean argDraw, GLfloat argRotation, GLfloat velocity);
+	~Unit();
 
 	// movement
-	void setDestination(glm::vec2 argDestination);
+	void setDestination(glm::vec2 argDestination, GLfloat argTime); // argTime starts the walking animation
+	void setDestination(glm::vec2 argDestination, GLfloat argTime, shared_ptr<FlowField> argFlowField);
 	void move(GLfloat deltaTime);
 	void stop();
-	// selection
+	// selection - kept in Selection, so the unit itself isn't touched
 	void select();
 	void deselect();
+	GLboolean isSelected();
+	// the id allocator, for saving games - after restoring, the units' ids have to be set to match
+	static void saveIds(GLuint& argNextId, vector<GLuint>& argFreeIds);
+	static void restoreIds(GLuint argNextId, const vector<GLuint>& argFreeIds);
 	// rendering 
 	virtual void draw(SpriteRenderer& Renderer);
 	void draw(SpriteRenderer & renderer, glm::vec2 argSampleDivider, GLint argSampleIndex);
+private:
+	void aim(); // faces the destination
+	void followFlowField(GLfloat deltaTime);
+	// ids of dead units, handed out again before new ones
+	static GLuint nextId;
+	static vector<GLuint> freeIds;
+	Unit(const Unit&);
+	Unit& operator=(const Unit&);
 };
 
 #endif
@@ -0,0 +1,71 @@
+#include "WorkerPool.h"
+
+#include <algorithm>
+#include <stdint.h>
+
+WorkerPool::WorkerPool(GLuint argThreads)
+{
+	// the caller takes part 0, so helper i takes part i + 1
+	for (GLuint i = 0; i < argThreads; i++)
+		threads.push_back(std::thread(&WorkerPool::run, this, i + 1));
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	wake.notify_all();
+	for (GLuint i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
+
+void WorkerPool::parallelFor(GLuint argCount, const std::function<void(GLuint, GLuint)>& argJob, GLuint grain)
+{
+	GLuint argParts = std::min(size(), std::max(1u, (argCount + grain - 1) / std::max(1u, grain)));
+	if (argParts <= 1)
+	{
+		argJob(0, argCount);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		job = &argJob;
+		count = argCount;
+		parts = argParts;
+		pending = static_cast<GLuint>(threads.size());
+		generation++;
+	}
+	wake.notify_all();
+	argJob(0, static_cast<GLuint>(static_cast<uint64_t>(argCount) / argParts));
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return pending == 0; });
+	job = nullptr;
+}
+
+void WorkerPool::run(GLuint part)
+{
+	GLuint seen = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		wake.wait(lock, [&] { return quit || generation != seen; });
+		if (quit)
+			return;
+		seen = generation;
+		// helpers past the number of parts just check in
+		if (part < parts)
+		{
+			GLuint begin = static_cast<GLuint>(static_cast<uint64_t>(count) * part / parts);
+			GLuint end = static_cast<GLuint>(static_cast<uint64_t>(count) * (part + 1) / parts);
+			const std::function<void(GLuint, GLuint)>& current = *job;
+			lock.unlock();
+			current(begin, end);
+			lock.lock();
+		}
+		if (--pending == 0)
+			done.notify_one();
+	}
+}
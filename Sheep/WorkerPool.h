@@ -0,0 +1,39 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <GL/glew.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads kept around for splitting loops across, so nothing gets spawned per tick. A loop is
+// cut into contiguous ranges, one per thread including the caller's, and parallelFor() returns
+// once all of them are done. Which range a thread gets never matters to the result as long as
+// the job only writes to its own range.
+class WorkerPool
+{
+public:
+	// constructors - argThreads is the number of helpers, on top of the calling thread
+	WorkerPool(GLuint argThreads);
+	~WorkerPool();
+	// runs job(begin, end) over [0, count), in ranges of at least grain
+	void parallelFor(GLuint count, const std::function<void(GLuint, GLuint)>& job, GLuint grain = 256);
+	GLuint size() const { return static_cast<GLuint>(threads.size()) + 1; }
+private:
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable wake, done;
+	const std::function<void(GLuint, GLuint)>* job = nullptr;
+	GLuint count = 0, parts = 0;
+	GLuint generation = 0; // bumped for every loop, so the helpers can tell a new one from the last
+	GLuint pending = 0;	   // helpers not done with the current loop
+	GLboolean quit = false;
+	WorkerPool(const WorkerPool&);
+	WorkerPool& operator=(const WorkerPool&);
+
+	void run(GLuint part);
+};
+
+#endif
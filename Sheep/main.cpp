@@ -15,6 +15,8 @@ using namespace std;
 
 const GLuint SCREEN_WIDTH = 800;
 const GLuint SCREEN_HEIGHT = 600;
+// longest the menus go without checking on the window while idle, in seconds
+const GLdouble MENU_IDLE_TIMEOUT = 0.25;
 
 int main(int argc, char *argv[]) 
 {
@@ -45,47 +47,58 @@ int main(int argc, char *argv[])
 	Game::InitGraphics();
 	Game::InitMenu();
 
+	// the game ticks on its own thread - this one just draws, as often as the display refreshes
+	glfwSwapInterval(1);
+
 	// DeltaTime variables
 	GLfloat deltaTime = 0.0f;
 	GLfloat lastFrame = 0.0f;
 
 	while (!glfwWindowShouldClose(window))
 	{
-		glfwPollEvents();
+		// the menus are static until the player does something, so sleep until they do
+		if (Game::State == GAME_PLAYING)
+			glfwPollEvents();
+		else
+			glfwWaitEventsTimeout(MENU_IDLE_TIMEOUT);
 		InputHandler::update(window);
 
-		if (Game::State == GAME_START)
-		{
-			// initialization
-			Game::UpdateMenu(deltaTime);
-			Game::RenderMenu(deltaTime);
-		}
-		else if (Game::State == GAME_PLAYING)
+		// Calculate delta time - the time between frames, which has nothing to do with game time
+		GLfloat currentFrame = glfwGetTime();
+		deltaTime = currentFrame - lastFrame;
+		lastFrame = currentFrame;
+
+		if (Game::State == GAME_PLAYING)
 		{
-			// initialization
-			if (!Game::gamestateInitialized)
-				Game::InitGamestate();
-			// Calculate delta time
-			GLfloat currentFrame = glfwGetTime();
-			deltaTime = currentFrame - lastFrame;
-			lastFrame = currentFrame;
-
-			// Manage user input
-			Game::ProcessInput(deltaTime);
-			// Update Game state
-			Game::UpdateGame(deltaTime);
+			// input and updates are picked up by the simulation thread
 			glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 			glClear(GL_COLOR_BUFFER_BIT);
 			Game::RenderGame(deltaTime);
 		}
-		else if (Game::State == GAME_END)
+		else
 		{
-			Game::UpdateMenu(deltaTime);
-			Game::RenderMenu(deltaTime);
+			{
+				// the menus work on the game state directly, so keep the simulation off of it
+				std::unique_lock<std::mutex> hold = Game::simulation->hold();
+				InputHandler::sample();
+				Game::UpdateMenu(deltaTime);
+				Game::RenderMenu(deltaTime);
+			}
+			// the game was started from the menu
+			if (Game::State == GAME_PLAYING)
+				Game::simulation->start();
 		}
+		// fence off this frame's streamed vertex data before the ring moves on
+		Game::streamBuffer->endFrame();
 		glfwSwapBuffers(window);
 	}
 
+	// the simulation thread has to be done before the game state goes away
+	delete Game::simulation;
+	Game::simulation = nullptr;
+	delete Game::workers;
+	Game::workers = nullptr;
+	Telemetry::close();
 	// Delete all resources as loaded using the resource manager
 	ResourceManager::Clear();
 